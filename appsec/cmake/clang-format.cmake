@@ -12,7 +12,8 @@ if(DD_APPSEC_BUILD_HELPER)
 endif()
 
 if(DD_APPSEC_BUILD_EXTENSION)
-    file(GLOB_RECURSE EXTENSION_FILES ${EXT_SOURCE_DIR}/*.c tests/helper/*.h tests/bench_helper/*.cc)
+    file(GLOB_RECURSE EXTENSION_FILES ${EXT_SOURCE_DIR}/*.c tests/helper/*.h tests/bench_helper/*.cc
+        tests/bench_extension/*.c tests/bench_extension/*.h tests/bench_extension/*.cc)
     list(APPEND FILE_LIST ${EXTENSION_FILES})
 endif()
 
@@ -24,6 +24,10 @@ set_target_properties(extension PROPERTIES
 target_compile_definitions(extension PRIVATE TESTING=1 ZEND_ENABLE_STATIC_TSRMLS_CACHE=1 -D_GNU_SOURCE)
 
 target_link_libraries(extension PRIVATE mpack PhpConfig zai)
+if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    # shm_open() lives in librt before glibc 2.34
+    target_link_libraries(extension PRIVATE rt)
+endif()
 target_include_directories(extension PRIVATE ..)
 
 # we don't have any C++ now, but just so we don't forget in the future...
@@ -36,3 +36,4 @@ endif()
 add_dependencies(xtest xtest-prepare ddtrace)
 
 add_subdirectory(tests/mock_helper EXCLUDE_FROM_ALL)
+add_subdirectory(tests/bench_extension EXCLUDE_FROM_ALL)
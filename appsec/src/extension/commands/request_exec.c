@@ -6,6 +6,7 @@
 
 #include "request_exec.h"
 #include "../commands_helpers.h"
+#include "../deferred_addresses.h"
 #include "../logging.h"
 #include "../msgpack_helpers.h"
 #include <php.h>
@@ -18,6 +19,7 @@ struct ctx {
 };
 
 static dd_result _pack_command(mpack_writer_t *nonnull w, void *nonnull ctx);
+static bool _overlaps_deferred(zend_array *nonnull data);
 
 static const dd_command_spec _spec = {
     .name = "request_exec",
@@ -36,6 +38,17 @@ dd_result dd_request_exec(dd_conn *nonnull conn, zval *nonnull data)
         return dd_error;
     }
 
+    // The batch must not repeat an address, send the queued ones on their own
+    if (_overlaps_deferred(Z_ARRVAL_P(data))) {
+        zval empty;
+        ZVAL_EMPTY_ARRAY(&empty);
+        struct ctx ctx = {.data = &empty};
+        dd_result res = dd_command_exec_req_info(conn, &_spec, &ctx.req_info);
+        if (res == dd_should_block || res == dd_should_redirect) {
+            return res;
+        }
+    }
+
     struct ctx ctx = {.data = data};
 
     return dd_command_exec_req_info(conn, &_spec, &ctx.req_info);
@@ -46,7 +59,52 @@ static dd_result _pack_command(mpack_writer_t *nonnull w, void *nonnull _ctx)
     assert(_ctx != NULL);
     struct ctx *ctx = _ctx;
 
-    dd_mpack_write_zval(w, ctx->data);
+    uint32_t num_deferred = dd_deferred_addresses_count();
+    if (num_deferred == 0) {
+        dd_mpack_write_zval(w, ctx->data);
+        return dd_success;
+    }
+
+    // Addresses deferred by push_address go first, in the same map
+    zend_array *arr = Z_ARRVAL_P(ctx->data);
+    mpack_start_map(w, num_deferred + zend_hash_num_elements(arr));
+    dd_deferred_addresses_pack(w);
+
+    zend_string *key;
+    zend_ulong idx;
+    zval *value;
+    ZEND_HASH_FOREACH_KEY_VAL(arr, idx, key, value)
+    {
+        if (key) {
+            dd_mpack_write_zstr(w, key);
+        } else {
+            char buf[ZEND_LTOA_BUF_LEN];
+            ZEND_LTOA((zend_long)idx, buf, sizeof(buf));
+            mpack_write(w, buf);
+        }
+        dd_mpack_write_zval(w, value);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    mpack_finish_map(w);
 
     return dd_success;
 }
+
+static bool _overlaps_deferred(zend_array *nonnull data)
+{
+    if (dd_deferred_addresses_count() == 0) {
+        return false;
+    }
+
+    zend_string *key;
+    ZEND_HASH_FOREACH_STR_KEY(data, key)
+    {
+        if (key && dd_deferred_addresses_has(key)) {
+            return true;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    return false;
+}
@@ -11,6 +11,7 @@
 #include "../configuration.h"
 #include "../ddappsec.h"
 #include "../ddtrace.h"
+#include "../deferred_addresses.h"
 #include "../entity_body.h"
 #include "../ip_extraction.h"
 #include "../logging.h"
@@ -32,13 +33,14 @@ static void _pack_path_params(
     mpack_writer_t *nonnull w, const zend_string *nullable uri_raw);
 static void _pack_request_body(mpack_writer_t *nonnull w,
     struct req_info_init *nonnull ctx, const zend_array *nonnull server);
+static dd_result _process_response(mpack_node_t root, void *unspecnull ctx);
 
 static const dd_command_spec _spec = {
     .name = "request_init",
     .name_len = sizeof("request_init") - 1,
     .num_args = 1, // a single map
     .outgoing_cb = _request_pack,
-    .incoming_cb = dd_command_proc_resp_verd_span_data,
+    .incoming_cb = _process_response,
     .config_features_cb = dd_command_process_config_features,
 };
 
@@ -48,6 +50,21 @@ dd_result dd_request_init(
     return dd_command_exec_req_info(conn, &_spec, &ctx->req_info);
 }
 
+static dd_result _process_response(mpack_node_t root, void *unspecnull ctx)
+{
+    // 4th element: whether the ruleset can block; older helpers don't send it
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    if (mpack_node_array_length(root) == 4) {
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        mpack_node_t may_block = mpack_node_array_at(root, 3);
+        if (mpack_node_type(may_block) == mpack_type_bool) {
+            dd_deferred_addresses_set_may_block(mpack_node_bool(may_block));
+        }
+    }
+
+    return dd_command_proc_resp_verd_span_data(root, ctx);
+}
+
 static dd_result _request_pack(mpack_writer_t *nonnull w, void *nonnull _ctx)
 {
     struct req_info_init *nonnull ctx = _ctx;
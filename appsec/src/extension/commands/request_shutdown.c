@@ -7,6 +7,7 @@
 #include "request_shutdown.h"
 #include "../commands_helpers.h"
 #include "../ddappsec.h"
+#include "../deferred_addresses.h"
 #include "../entity_body.h"
 #include "../logging.h"
 #include "../msgpack_helpers.h"
@@ -61,7 +62,11 @@ static dd_result _request_pack(mpack_writer_t *nonnull w, void *nonnull ctx)
         }
     }
 
-    mpack_start_map(w, 2 + (Z_TYPE(resp_body) != IS_NULL ? 1 : 0));
+    mpack_start_map(w, 2 + (Z_TYPE(resp_body) != IS_NULL ? 1 : 0) +
+                           dd_deferred_addresses_count());
+
+    // addresses still deferred by push_address
+    dd_deferred_addresses_pack(w);
 
     // 1.
     {
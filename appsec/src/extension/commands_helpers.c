@@ -9,6 +9,7 @@
 #include "configuration.h"
 #include "ddappsec.h"
 #include "ddtrace.h"
+#include "helper_process.h"
 #include "logging.h"
 #include "msgpack_helpers.h"
 #include "request_abort.h"
@@ -34,7 +35,8 @@ static void _dump_in_msg(
 static void _dump_out_msg(dd_log_level_t lvl, zend_llist *iovecs);
 
 typedef struct _dd_imsg {
-    char *unspecnull _data;
+    // borrowed from the connection's receive buffer
+    const char *unspecnull _data;
     size_t _size;
     mpack_tree_t _tree;
     mpack_node_t root;
@@ -55,6 +57,9 @@ static dd_result _dd_command_exec(dd_conn *nonnull conn, bool check_cred,
 #define NAME_L (int)spec->name_len, spec->name
     mlog(dd_log_debug, "Will start command %.*s with helper", NAME_L);
 
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
     // out
     {
         dd_omsg omsg;
@@ -99,6 +104,12 @@ static dd_result _dd_command_exec(dd_conn *nonnull conn, bool check_cred,
         } else {
             res = _imsg_recv(&imsg, conn);
         }
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        dd_helper_mgr_record_latency(conn,
+            (double)(end.tv_sec - start.tv_sec) * 1000.0 +
+                (double)(end.tv_nsec - start.tv_nsec) / 1000000.0,
+            res == dd_network);
         if (res) {
             if (res != dd_helper_error) {
                 mlog(dd_log_warning,
@@ -302,7 +313,6 @@ ATTR_WARN_UNUSED dd_result _imsg_recv_cred(
 static inline ATTR_WARN_UNUSED mpack_error_t _imsg_destroy(
     dd_imsg *nonnull imsg)
 {
-    free(imsg->_data);
     imsg->_data = NULL;
     imsg->_size = 0;
     return mpack_tree_destroy(&imsg->_tree);
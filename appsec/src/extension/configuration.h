@@ -51,6 +51,12 @@ extern bool runtime_config_first_init;
     CONFIG(STRING, DD_APPSEC_HELPER_RUNTIME_PATH, "/tmp", .ini_change = dd_on_runtime_path_update)                                    \
     SYSCFG(STRING, DD_APPSEC_HELPER_LOG_FILE, "/dev/null")                                                                            \
     SYSCFG(STRING, DD_APPSEC_HELPER_LOG_LEVEL, "info")                                                                                \
+    SYSCFG(DOUBLE, DD_APPSEC_HELPER_TIMEOUT_P99_MULTIPLIER, "4")                                                                      \
+    SYSCFG(INT, DD_APPSEC_HELPER_TIMEOUT_MIN, "100")                                                                                  \
+    SYSCFG(INT, DD_APPSEC_HELPER_TIMEOUT_MAX, "2000")                                                                                 \
+    SYSCFG(INT, DD_APPSEC_HELPER_SLOW_RESPONSE_THRESHOLD, "500")                                                                      \
+    SYSCFG(INT, DD_APPSEC_HELPER_BREAKER_THRESHOLD, "5")                                                                              \
+    SYSCFG(INT, DD_APPSEC_HELPER_BREAKER_COOLDOWN, "30")                                                                              \
     CONFIG(CUSTOM(SET), DD_EXTRA_SERVICES, "", .parser = _parse_list)                                                                 \
     CONFIG(STRING, DD_SERVICE, "")                                                                                                    \
     CONFIG(STRING, DD_ENV, "")                                                                                                        \
@@ -60,6 +66,8 @@ extern bool runtime_config_first_init;
     CONFIG(STRING, DD_AGENT_HOST, "")                                                                                                 \
     CONFIG(INT, DD_TRACE_AGENT_PORT, "0")                                                                                             \
     CONFIG(INT, DD_APPSEC_MAX_BODY_BUFF_SIZE, "524288")                                                                               \
+    CONFIG(BOOL, DD_APPSEC_DEFER_PUSH_ADDRESS, "false")                                                                               \
+    CONFIG(INT, DD_APPSEC_DEFER_PUSH_ADDRESS_BATCH_SIZE, "16")                                                                        \
     CONFIG(STRING, DD_TRACE_AGENT_URL, "")                                                                                            \
     CONFIG(BOOL, DD_TRACE_ENABLED, "true")                                                                                            \
     CALIAS(CUSTOM(STRING), DD_APPSEC_AUTO_USER_INSTRUMENTATION_MODE, "ident",                              \
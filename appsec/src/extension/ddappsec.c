@@ -27,6 +27,7 @@
 #include "ddappsec.h"
 #include "dddefs.h"
 #include "ddtrace.h"
+#include "deferred_addresses.h"
 #include "entity_body.h"
 #include "helper_process.h"
 #include "ip_extraction.h"
@@ -474,6 +475,7 @@ static PHP_FUNCTION(datadog_appsec_testing_request_exec)
     RETURN_TRUE;
 }
 
+static void _apply_push_address_verdict(dd_result res);
 static PHP_FUNCTION(datadog_appsec_push_address)
 {
     UNUSED(return_value);
@@ -489,22 +491,42 @@ static PHP_FUNCTION(datadog_appsec_push_address)
         RETURN_FALSE;
     }
 
-    zval parameters_zv;
-    zend_array *parameters_arr = zend_new_array(1);
-    ZVAL_ARR(&parameters_zv, parameters_arr);
-    zend_hash_add(Z_ARRVAL(parameters_zv), key, value);
-    Z_TRY_ADDREF_P(value);
-
     dd_conn *conn = dd_helper_mgr_cur_conn();
     if (conn == NULL) {
-        zval_ptr_dtor(&parameters_zv);
         mlog_g(dd_log_debug, "No connection; skipping push_address");
         return;
     }
 
-    dd_result res = dd_request_exec(conn, &parameters_zv);
+    zval parameters_zv;
+    dd_result res;
+    // Only deferred when the ruleset cannot block: no verdict can come late
+    if (dd_deferred_addresses_enabled()) {
+        // request_exec sends the queued addresses along with its own
+        ZVAL_EMPTY_ARRAY(&parameters_zv);
+        if (!dd_deferred_addresses_add(key, value)) {
+            // already queued: send the batch, then start a new one
+            res = dd_request_exec(conn, &parameters_zv);
+            _apply_push_address_verdict(res);
+            dd_deferred_addresses_add(key, value);
+        }
+        if (!dd_deferred_addresses_full()) {
+            return;
+        }
+    } else {
+        zend_array *parameters_arr = zend_new_array(1);
+        ZVAL_ARR(&parameters_zv, parameters_arr);
+        zend_hash_add(Z_ARRVAL(parameters_zv), key, value);
+        Z_TRY_ADDREF_P(value);
+    }
+
+    res = dd_request_exec(conn, &parameters_zv);
     zval_ptr_dtor(&parameters_zv);
 
+    _apply_push_address_verdict(res);
+}
+
+static void _apply_push_address_verdict(dd_result res)
+{
     if (dd_req_is_user_req()) {
         if (res == dd_should_block || res == dd_should_redirect) {
             dd_req_call_blocking_function(res);
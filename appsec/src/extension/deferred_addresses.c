@@ -0,0 +1,85 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "deferred_addresses.h"
+#include "configuration.h"
+#include "logging.h"
+#include "msgpack_helpers.h"
+#include <php.h>
+
+static THREAD_LOCAL_ON_ZTS zend_array *nullable _queued;
+// until the helper tells otherwise (older helpers never do)
+static THREAD_LOCAL_ON_ZTS bool _may_block = true;
+
+bool dd_deferred_addresses_enabled(void)
+{
+    return !_may_block && get_DD_APPSEC_DEFER_PUSH_ADDRESS();
+}
+
+void dd_deferred_addresses_set_may_block(bool may_block)
+{
+    _may_block = may_block;
+}
+
+bool dd_deferred_addresses_add(zend_string *nonnull key, zval *nonnull value)
+{
+    if (!_queued) {
+        _queued = zend_new_array(8); // NOLINT
+    }
+
+    // keeps insertion order, which is the order the addresses are sent in
+    if (!zend_hash_add(_queued, key, value)) {
+        return false;
+    }
+    Z_TRY_ADDREF_P(value);
+
+    mlog_g(dd_log_debug, "Deferred address %.*s (%" PRIu32 " queued)",
+        (int)ZSTR_LEN(key), ZSTR_VAL(key), zend_hash_num_elements(_queued));
+    return true;
+}
+
+bool dd_deferred_addresses_has(zend_string *nonnull key)
+{
+    return _queued && zend_hash_exists(_queued, key);
+}
+
+bool dd_deferred_addresses_full(void)
+{
+    zend_long batch_size = get_DD_APPSEC_DEFER_PUSH_ADDRESS_BATCH_SIZE();
+    return batch_size <= 0 ||
+           (zend_long)dd_deferred_addresses_count() >= batch_size;
+}
+
+uint32_t dd_deferred_addresses_count(void)
+{
+    return _queued ? zend_hash_num_elements(_queued) : 0;
+}
+
+void dd_deferred_addresses_pack(mpack_writer_t *nonnull w)
+{
+    if (!_queued) {
+        return;
+    }
+
+    zend_string *key;
+    zval *value;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(_queued, key, value)
+    {
+        dd_mpack_write_zstr(w, key);
+        dd_mpack_write_zval(w, value);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    dd_deferred_addresses_rshutdown();
+}
+
+void dd_deferred_addresses_rshutdown(void)
+{
+    if (_queued) {
+        zend_array_destroy(_queued);
+        _queued = NULL;
+    }
+    _may_block = true;
+}
@@ -0,0 +1,34 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include "attributes.h"
+#include <mpack.h>
+#include <stdbool.h>
+#include <zend.h>
+
+// With DD_APPSEC_DEFER_PUSH_ADDRESS enabled, the addresses pushed with
+// datadog\appsec\push_address are not sent to the helper right away. They
+// travel with the next request_exec or request_shutdown, or on their own
+// once DD_APPSEC_DEFER_PUSH_ADDRESS_BATCH_SIZE of them are queued.
+// This only happens when the helper said on request_init that its ruleset
+// cannot block, so that a verdict never arrives late.
+
+bool dd_deferred_addresses_enabled(void);
+void dd_deferred_addresses_set_may_block(bool may_block);
+
+// A batch holds each address at most once; returns false (and does nothing)
+// if key is already queued, in which case the batch has to be sent first
+bool dd_deferred_addresses_add(zend_string *nonnull key, zval *nonnull value);
+bool dd_deferred_addresses_has(zend_string *nonnull key);
+bool dd_deferred_addresses_full(void);
+uint32_t dd_deferred_addresses_count(void);
+
+// Writes the queued addresses as map entries and forgets about them. The
+// caller must account for dd_deferred_addresses_count() entries in the map
+void dd_deferred_addresses_pack(mpack_writer_t *nonnull w);
+
+void dd_deferred_addresses_rshutdown(void);
@@ -0,0 +1,102 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "enablement_state.h"
+#include "logging.h"
+#include "php_helpers.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Keep in sync with helper/enablement_state.hpp
+struct enablement_segment {
+    uint32_t generation; // 0 until the helper has published anything
+    uint32_t enabled;
+};
+
+#define SEGMENT_SUFFIX "-asm"
+#define MAX_SEGMENT_NAME 64
+
+static THREAD_LOCAL_ON_ZTS char _mapped_path[MAX_SEGMENT_NAME];
+static THREAD_LOCAL_ON_ZTS struct enablement_segment *nullable _segment;
+static THREAD_LOCAL_ON_ZTS uint32_t _last_generation;
+
+static bool _map_segment(const char *nonnull rem_cfg_path)
+{
+    char name[MAX_SEGMENT_NAME];
+    int len = snprintf(name, sizeof(name), "%s%s" SEGMENT_SUFFIX,
+        rem_cfg_path[0] == '/' ? "" : "/", rem_cfg_path);
+    if (len < 0 || (size_t)len >= sizeof(name)) {
+        return false;
+    }
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) {
+        // The helper has not published anything for this path yet
+        return false;
+    }
+
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 &&
+        (size_t)st.st_size >= sizeof(struct enablement_segment)) {
+        addr = mmap(NULL, sizeof(struct enablement_segment), PROT_READ,
+            MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        mlog(dd_log_debug, "Could not map enablement state %s", name);
+        return false;
+    }
+
+    _segment = addr;
+    // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
+    strcpy(_mapped_path, rem_cfg_path);
+    return true;
+}
+
+bool dd_enablement_state_changed(const char *nonnull rem_cfg_path)
+{
+    if (rem_cfg_path[0] == '\0' ||
+        strlen(rem_cfg_path) >= sizeof(_mapped_path)) {
+        return true;
+    }
+
+    if (!_segment || strcmp(_mapped_path, rem_cfg_path) != 0) {
+        if (_segment) {
+            munmap(_segment, sizeof(struct enablement_segment));
+            _segment = NULL;
+        }
+        _last_generation = 0;
+        if (!_map_segment(rem_cfg_path)) {
+            return true;
+        }
+    }
+
+    uint32_t generation =
+        __atomic_load_n(&_segment->generation, __ATOMIC_ACQUIRE);
+    if (generation == 0) {
+        // Not published yet, or reset by the helper before unlinking it: a
+        // segment for this path created later would be a different one
+        munmap(_segment, sizeof(struct enablement_segment));
+        _segment = NULL;
+        _last_generation = 0;
+        return true;
+    }
+    if (generation != _last_generation) {
+        mlog(dd_log_debug, "AppSec enablement state changed (generation %u)",
+            generation);
+        _last_generation = generation;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,18 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include "attributes.h"
+#include <stdbool.h>
+
+// The helper publishes whether AppSec is enabled for a given remote config
+// path in a small shared memory segment. While AppSec can only be enabled
+// remotely, this lets requests skip the config_sync round trip until the
+// helper has something new to say.
+//
+// Returns true if config_sync must be sent: the state changed since the last
+// call, or it could not be read.
+bool dd_enablement_state_changed(const char *nonnull rem_cfg_path);
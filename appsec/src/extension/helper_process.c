@@ -21,12 +21,31 @@
 #include "php_objects.h"
 #include "version.h"
 
+typedef enum {
+    breaker_closed = 0,
+    breaker_open,
+    breaker_half_open,
+} dd_breaker_state;
+
 typedef struct _dd_helper_mgr {
     dd_conn conn;
 
     struct timespec next_retry;
     uint16_t failed_count;
     bool connected_this_req;
+    bool in_client_init;
+
+    // smoothed latency and mean deviation of the exchanges, in ms
+    double latency_avg;
+    double latency_dev;
+    bool has_latency;
+    // doubled on every timed out exchange, 0 once an exchange succeeds
+    int backoff_timeout_ms;
+
+    dd_breaker_state breaker;
+    uint16_t slow_count;
+    struct timespec breaker_until;
+    bool skipped_this_req;
 
     pid_t pid;
     char *nonnull socket_path;
@@ -42,7 +61,12 @@ static const double _backoff_max_exponent = 10.0;
 
 static const int timeout_send = 500;
 static const int timeout_recv_initial = 7500;
-static const int timeout_recv_subseq = 2000;
+
+// Same gains as TCP's RTT estimator (RFC 6298)
+static const double _latency_avg_gain = 0.125;
+static const double _latency_dev_gain = 0.25;
+// avg + 3 * mean deviation is around p99 for a normal distribution
+static const double _latency_p99_devs = 3.0;
 
 #define DD_PATH_FORMAT "%s%sddappsec_" PHP_DDAPPSEC_VERSION "_%u"
 #define DD_SOCK_PATH_FORMAT DD_PATH_FORMAT ".sock"
@@ -56,6 +80,8 @@ static void _read_settings(void);
 static bool _wait_for_next_retry(void);
 static void _inc_failed_counter(void);
 static void _reset_retry_state(void);
+static bool _breaker_skips_request(void);
+static int _recv_timeout(void);
 
 void dd_helper_startup(void)
 {
@@ -68,15 +94,24 @@ void dd_helper_shutdown(void) {}
 
 void dd_helper_gshutdown()
 {
+    dd_conn_free_buffer(&_mgr.conn);
     pefree(_mgr.socket_path, 1);
     pefree(_mgr.lock_path, 1);
 }
 
-void dd_helper_rshutdown() { _mgr.connected_this_req = false; }
+void dd_helper_rshutdown()
+{
+    _mgr.connected_this_req = false;
+    _mgr.skipped_this_req = false;
+}
 
 dd_conn *nullable dd_helper_mgr_acquire_conn(
     client_init_func nonnull init_func, void *unspecnull ctx)
 {
+    if (_breaker_skips_request()) {
+        return NULL;
+    }
+
     dd_conn *conn = &_mgr.conn;
     if (dd_conn_connected(conn)) {
         return conn;
@@ -100,7 +135,11 @@ dd_conn *nullable dd_helper_mgr_acquire_conn(
     dd_conn_set_timeout(conn, comm_type_send, timeout_send);
     dd_conn_set_timeout(conn, comm_type_recv, timeout_recv_initial);
 
+    // client_init may wait for the helper to load the rules, which says
+    // nothing about how fast it answers requests
+    _mgr.in_client_init = true;
     res = init_func(conn, ctx);
+    _mgr.in_client_init = false;
     if (res) {
         mlog_g(dd_log_warning, "Initial exchange with helper failed; "
                                "abandoning the connection");
@@ -108,7 +147,7 @@ dd_conn *nullable dd_helper_mgr_acquire_conn(
         goto error;
     }
 
-    dd_conn_set_timeout(&_mgr.conn, comm_type_recv, timeout_recv_subseq);
+    dd_conn_set_timeout(&_mgr.conn, comm_type_recv, _recv_timeout());
 
     mlog(dd_log_debug, "returning fresh connection");
 
@@ -124,6 +163,10 @@ error:
 
 dd_conn *nullable dd_helper_mgr_cur_conn(void)
 {
+    if (_mgr.skipped_this_req) {
+        return NULL;
+    }
+
     dd_conn *conn = &_mgr.conn;
     if (dd_conn_connected(conn)) {
         return conn;
@@ -286,6 +329,136 @@ static void _reset_retry_state()
     _mgr.next_retry = (struct timespec){0};
 }
 
+static int _recv_timeout()
+{
+    int min = (int)get_global_DD_APPSEC_HELPER_TIMEOUT_MIN();
+    int max = (int)get_global_DD_APPSEC_HELPER_TIMEOUT_MAX();
+    // the probe decides whether AppSec stays off, give a slow helper a chance
+    if (!_mgr.has_latency || _mgr.breaker == breaker_half_open) {
+        return max;
+    }
+
+    double p99 = _mgr.latency_avg + _latency_p99_devs * _mgr.latency_dev;
+    double timeout = get_global_DD_APPSEC_HELPER_TIMEOUT_P99_MULTIPLIER() * p99;
+    if (timeout < _mgr.backoff_timeout_ms) {
+        timeout = _mgr.backoff_timeout_ms;
+    }
+    if (timeout < min) {
+        return min;
+    }
+    if (timeout > max) {
+        return max;
+    }
+    return (int)timeout;
+}
+
+void dd_helper_mgr_record_latency(
+    dd_conn *nonnull conn, double elapsed_ms, bool failed)
+{
+    if (_mgr.in_client_init) {
+        return;
+    }
+
+    if (!failed) {
+        if (!_mgr.has_latency) {
+            _mgr.latency_avg = elapsed_ms;
+            _mgr.latency_dev = elapsed_ms / 2;
+            _mgr.has_latency = true;
+        } else {
+            _mgr.latency_dev += _latency_dev_gain *
+                                (fabs(elapsed_ms - _mgr.latency_avg) -
+                                    _mgr.latency_dev);
+            _mgr.latency_avg +=
+                _latency_avg_gain * (elapsed_ms - _mgr.latency_avg);
+        }
+        _mgr.backoff_timeout_ms = 0;
+    } else if (_mgr.has_latency) {
+        // A timeout gives no sample, back off as TCP does (RFC 6298, 5.5);
+        // otherwise a helper which got slower than the estimate would time
+        // out forever
+        int max = (int)get_global_DD_APPSEC_HELPER_TIMEOUT_MAX();
+        int backoff = 2 * (_mgr.backoff_timeout_ms ? _mgr.backoff_timeout_ms
+                                                   : _recv_timeout());
+        _mgr.backoff_timeout_ms = backoff > max ? max : backoff;
+    }
+    // not through dd_conn_set_timeout(), which logs on every call
+    if (dd_conn_connected(conn)) {
+        conn->recv_timeout_ms = _recv_timeout();
+    }
+
+    zend_long threshold = get_global_DD_APPSEC_HELPER_BREAKER_THRESHOLD();
+    if (threshold <= 0) {
+        return;
+    }
+
+    double slow_threshold =
+        (double)get_global_DD_APPSEC_HELPER_SLOW_RESPONSE_THRESHOLD();
+    bool slow = failed || elapsed_ms > slow_threshold;
+    if (!slow) {
+        if (_mgr.breaker == breaker_half_open) {
+            mlog(dd_log_info, "Helper answered in %.1f ms, closing the "
+                              "circuit breaker", elapsed_ms);
+        }
+        if (_mgr.breaker == breaker_half_open && dd_conn_connected(conn)) {
+            _mgr.breaker = breaker_closed;
+            conn->recv_timeout_ms = _recv_timeout(); // was the probe's
+        }
+        _mgr.breaker = breaker_closed;
+        _mgr.slow_count = 0;
+        return;
+    }
+
+    if (_mgr.slow_count != UINT16_MAX) {
+        _mgr.slow_count++;
+    }
+    if (_mgr.breaker != breaker_half_open && _mgr.slow_count < threshold) {
+        return;
+    }
+
+    if (clock_gettime(CLOCK_MONOTONIC, &_mgr.breaker_until) == -1) {
+        mlog_err(dd_log_warning, "Call to clock_gettime() failed");
+        return;
+    }
+    _mgr.breaker_until.tv_sec +=
+        (time_t)get_global_DD_APPSEC_HELPER_BREAKER_COOLDOWN();
+    _mgr.breaker = breaker_open;
+    mlog(dd_log_warning,
+        "%u slow responses from the helper (last took %.1f ms); skipping "
+        "AppSec for %ld seconds",
+        _mgr.slow_count, elapsed_ms,
+        (long)get_global_DD_APPSEC_HELPER_BREAKER_COOLDOWN());
+}
+
+// returns true if the helper should not be contacted during this request
+static bool _breaker_skips_request()
+{
+    if (_mgr.breaker != breaker_open) {
+        return false;
+    }
+
+    struct timespec cur_time;
+    if (clock_gettime(CLOCK_MONOTONIC, &cur_time) == -1) {
+        mlog_err(dd_log_warning, "Call to clock_gettime() failed");
+        return false;
+    }
+    if (cur_time.tv_sec > _mgr.breaker_until.tv_sec ||
+        (cur_time.tv_sec == _mgr.breaker_until.tv_sec &&
+            cur_time.tv_nsec >= _mgr.breaker_until.tv_nsec)) {
+        // let this request through; its first exchange decides
+        mlog(dd_log_debug, "Circuit breaker cool-down expired, probing helper");
+        _mgr.breaker = breaker_half_open;
+        if (dd_conn_connected(&_mgr.conn)) {
+            _mgr.conn.recv_timeout_ms = _recv_timeout();
+        }
+        return false;
+    }
+
+    _mgr.skipped_this_req = true;
+    return true;
+}
+
+bool dd_helper_mgr_breaker_open(void) { return _mgr.skipped_this_req; }
+
 #ifdef TESTING
 static PHP_FUNCTION(datadog_appsec_testing_set_helper_path)
 {
@@ -330,6 +503,24 @@ static PHP_FUNCTION(datadog_appsec_testing_backoff_status)
             (double)_mgr.next_retry.tv_nsec / TEN_E9_D);
 }
 
+static PHP_FUNCTION(datadog_appsec_testing_helper_latency_status)
+{
+    if (zend_parse_parameters_none() == FAILURE) {
+        RETURN_FALSE;
+    }
+
+    array_init_size(return_value, 4);
+
+    add_assoc_double_ex(
+        return_value, ZEND_STRL("latency_avg"), _mgr.latency_avg);
+    add_assoc_long_ex(
+        return_value, ZEND_STRL("recv_timeout"), (zend_long)_recv_timeout());
+    add_assoc_long_ex(
+        return_value, ZEND_STRL("breaker"), (zend_long)_mgr.breaker);
+    add_assoc_long_ex(
+        return_value, ZEND_STRL("slow_count"), (zend_long)_mgr.slow_count);
+}
+
 // clang-format off
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(set_string_arginfo, 0, 1, IS_VOID, 0)
     ZEND_ARG_TYPE_INFO(0, value, IS_STRING, 0)
@@ -345,6 +536,7 @@ static const zend_function_entry functions[] = {
     ZEND_RAW_FENTRY(DD_TESTING_NS "set_helper_path", PHP_FN(datadog_appsec_testing_set_helper_path), set_string_arginfo, 0, NULL, NULL)
     ZEND_RAW_FENTRY(DD_TESTING_NS "is_connected_to_helper", PHP_FN(datadog_appsec_testing_is_connected_to_helper), void_ret_bool_arginfo, 0, NULL, NULL)
     ZEND_RAW_FENTRY(DD_TESTING_NS "backoff_status", PHP_FN(datadog_appsec_testing_backoff_status), void_ret_array_arginfo, 0, NULL, NULL)
+    ZEND_RAW_FENTRY(DD_TESTING_NS "helper_latency_status", PHP_FN(datadog_appsec_testing_helper_latency_status), void_ret_array_arginfo, 0, NULL, NULL)
     PHP_FE_END
 };
 // clang-format on
@@ -29,6 +29,14 @@ dd_conn *nullable dd_helper_mgr_acquire_conn(
 dd_conn *nullable dd_helper_mgr_cur_conn(void);
 void dd_helper_close_conn(void);
 
+// Feeds the duration of an exchange with the helper into the receive timeout
+// estimate and the circuit breaker
+void dd_helper_mgr_record_latency(
+    dd_conn *nonnull conn, double elapsed_ms, bool failed);
+// Whether the helper is being skipped for the current request because it was
+// too slow recently
+bool dd_helper_mgr_breaker_open(void);
+
 bool dd_on_runtime_path_update(zval *nullable old_value,
     zval *nonnull new_value, zend_string *nullable new_str);
 
@@ -38,9 +38,15 @@ typedef struct PACKED _dd_header dd_header;
 static const int CONNECT_TIMEOUT = 2500;    // ms
 static const int CONNECT_RETRY_PAUSE = 100; // ms
 static const uint32_t MAX_RECV_MESSAGE_SIZE = 4 * 1024 * 1024;
+static const size_t RECV_BUFFER_INITIAL_SIZE = 16 * 1024;
 
 static void _timespec_add_ms(struct timespec *ts, long num_ms);
-static long _timespec_delta_ms(struct timespec *ts1, struct timespec *ts2);
+static long _timespec_delta_ms(
+    const struct timespec *ts1, const struct timespec *ts2);
+static struct timespec *nullable _deadline_from_timeout(
+    struct timespec *nonnull deadline, int timeout_ms);
+static dd_result _wait_for(dd_conn *nonnull conn, short events,
+    const struct timespec *nullable deadline);
 
 int dd_conn_init( // NOLINT(readability-function-cognitive-complexity)
     dd_conn *nonnull conn, const char *nonnull path, size_t path_len)
@@ -156,7 +162,9 @@ try_again:
         }
     }
 
-    fcntl(conn->socket, F_SETFL, flags_before & ~O_NONBLOCK);
+    // The socket is left in non-blocking mode: sends and receives wait with
+    // poll() against the deadlines set with dd_conn_set_timeout()
+    conn->buf_start = conn->buf_end = 0;
 
     // no guarantee of accept() on the other side though
     mlog(dd_log_info, "connect() to helper socket succeeded");
@@ -201,23 +209,55 @@ dd_result dd_conn_sendv(dd_conn *nonnull conn, zend_llist *nonnull iovecs)
     mlog_g(dd_log_debug, "About to send %zu + %zu bytes to helper",
         sizeof(dd_header), data_len);
 
-    ssize_t sent_bytes = writev(conn->socket, iovs, (int)iovecs_count + 1);
-    efree(iovs);
-    if (sent_bytes == -1) {
-        mlog_err(dd_log_info, "Error writing %zu bytes to helper", total);
-        return dd_network;
+    struct timespec deadline_ts;
+    struct timespec *deadline =
+        _deadline_from_timeout(&deadline_ts, conn->send_timeout_ms);
+    dd_result res = dd_success;
+    size_t sent_bytes = 0;
+    int iov_idx = 0;
+    int iov_cnt = (int)iovecs_count + 1;
+    while (iov_idx < iov_cnt) {
+        ssize_t written =
+            writev(conn->socket, &iovs[iov_idx], iov_cnt - iov_idx);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                res = _wait_for(conn, POLLOUT, deadline);
+                if (res) {
+                    break;
+                }
+                continue;
+            }
+            mlog_err(dd_log_info, "Error writing %zu bytes to helper", total);
+            res = dd_network;
+            break;
+        }
+
+        // skip what was fully written; adjust what was partially written
+        sent_bytes += (size_t)written;
+        while (iov_idx < iov_cnt && (size_t)written >= iovs[iov_idx].iov_len) {
+            written -= (ssize_t)iovs[iov_idx].iov_len;
+            iov_idx++;
+        }
+        if (iov_idx < iov_cnt) {
+            iovs[iov_idx].iov_base = (char *)iovs[iov_idx].iov_base + written;
+            iovs[iov_idx].iov_len -= written;
+        }
     }
-    mlog_g(dd_log_debug, "Wrote %zu bytes", (size_t)sent_bytes);
+    efree(iovs);
+    mlog_g(dd_log_debug, "Wrote %zu bytes", sent_bytes);
 
-    if ((size_t)sent_bytes != total) {
+    if (res == dd_success && sent_bytes != total) {
         mlog(dd_log_info,
             "Could not send the desired number of bytes. Total sent was %zu, "
             "wanted %zu",
-            (size_t)sent_bytes, total);
+            sent_bytes, total);
         return dd_network;
     }
 
-    return dd_success;
+    return res;
 }
 #ifdef SO_PASSCRED
 dd_result dd_conn_sendv_cred(dd_conn *nonnull conn, zend_llist *nonnull iovecs)
@@ -243,32 +283,80 @@ dd_result dd_conn_sendv_cred(dd_conn *nonnull conn, zend_llist *nonnull iovecs)
 }
 #endif
 
-static dd_result _recv_message_body(int sock, char *nullable *nonnull data,
-    size_t *nonnull data_len, size_t expected_size);
-dd_result dd_conn_recv(dd_conn *nonnull conn, char *nullable *nonnull data,
-    size_t *nonnull data_len)
+static dd_result _recv_message(dd_conn *nonnull conn, bool check_cred,
+    const char *nullable *nonnull data, size_t *nonnull data_len);
+dd_result dd_conn_recv(dd_conn *nonnull conn,
+    const char *nullable *nonnull data, size_t *nonnull data_len)
 {
     if (conn == NULL || conn->socket <= 0 || data == NULL) {
         return dd_error;
     }
 
-    dd_header h;
-    ssize_t recv_bytes = recv(conn->socket, (void *)&h, sizeof(dd_header), 0);
-    if (recv_bytes == -1) {
-        mlog_err(dd_log_info, "Error receiving the header");
-        return dd_network;
+    return _recv_message(conn, false, data, data_len);
+}
+
+dd_result dd_conn_recv_cred(dd_conn *nonnull conn,
+    const char *nullable *nonnull data, size_t *nonnull data_len)
+{
+    if (conn == NULL || conn->socket <= 0 || data == NULL) {
+        mlog(dd_log_warning, "Invalid arguments. Bug");
+        return dd_error;
+    }
+
+#ifdef SO_PASSCRED
+    return _recv_message(conn, true, data, data_len);
+#else
+    return _recv_message(conn, false, data, data_len);
+#endif
+}
+
+static dd_result _ensure_buffer_capacity(dd_conn *nonnull conn, size_t size);
+static dd_result _recv_available(dd_conn *nonnull conn,
+    const struct timespec *nullable deadline, bool *nonnull check_cred);
+static dd_result _recv_message(dd_conn *nonnull conn, bool check_cred,
+    const char *nullable *nonnull data, size_t *nonnull data_len)
+{
+    // The previous message is no longer referenced, reclaim its space. Data
+    // past it (if the helper ever sends ahead) is kept
+    if (conn->buf_start > 0) {
+        size_t leftover = conn->buf_end - conn->buf_start;
+        if (leftover > 0) {
+            memmove(conn->buf, conn->buf + conn->buf_start, leftover);
+        }
+        conn->buf_start = 0;
+        conn->buf_end = leftover;
     }
-    if (recv_bytes != sizeof(dd_header)) {
-        mlog(dd_log_info, "Could not read the full header. Read %zd",
-            recv_bytes);
+    if (check_cred && conn->buf_end > 0) {
+        mlog(dd_log_warning, "Unexpected data buffered before credentials");
+        conn->buf_end = 0;
         return dd_network;
     }
 
+    dd_result res = _ensure_buffer_capacity(conn, RECV_BUFFER_INITIAL_SIZE);
+    if (res) {
+        return res;
+    }
+
+    struct timespec deadline_ts;
+    struct timespec *deadline =
+        _deadline_from_timeout(&deadline_ts, conn->recv_timeout_ms);
+
+    // Usually the header and the body are read with a single recv()
+    while (conn->buf_end < sizeof(dd_header)) {
+        res = _recv_available(conn, deadline, &check_cred);
+        if (res) {
+            goto error;
+        }
+    }
+
+    dd_header h;
+    memcpy(&h, conn->buf, sizeof h);
     if (strncmp(h.code, "dds", 3) != 0) {
         mlog(dd_log_warning, "Invalid message header from helper");
         // to force the connection closed. It may be we half-read a previous
         // message, so a reconnection can help
-        return dd_network;
+        res = dd_network;
+        goto error;
     }
     // size is in machine order
     if (h.size > MAX_RECV_MESSAGE_SIZE) {
@@ -276,68 +364,125 @@ dd_result dd_conn_recv(dd_conn *nonnull conn, char *nullable *nonnull data,
             "Rejecting helper message with size %" PRIu32
             " larger than max %" PRIu32,
             h.size, MAX_RECV_MESSAGE_SIZE);
-        return dd_network; // force reconnect, we don't want to read it all
+        res = dd_network; // force reconnect, we don't want to read it all
+        goto error;
+    }
+
+    size_t total = sizeof(dd_header) + h.size;
+    res = _ensure_buffer_capacity(conn, total);
+    if (res) {
+        goto error;
+    }
+
+    mlog(dd_log_debug, "Will receive message body. Expected size: %" PRIu32,
+        h.size);
+    while (conn->buf_end < total) {
+        res = _recv_available(conn, deadline, &check_cred);
+        if (res) {
+            goto error;
+        }
     }
+    mlog(dd_log_debug, "Got full response. Size %" PRIu32, h.size);
+
+    *data = conn->buf + sizeof(dd_header);
+    *data_len = h.size;
+    conn->buf_start = total;
 
-    return _recv_message_body(conn->socket, data, data_len, h.size);
+    return dd_success;
+error:
+    conn->buf_start = conn->buf_end = 0;
+    return res;
 }
 
-static dd_result _recv_message_body(int sock, char *nullable *nonnull data,
-    size_t *nonnull data_len, size_t expected_size)
+static dd_result _ensure_buffer_capacity(dd_conn *nonnull conn, size_t size)
 {
-    char *buffer = malloc(expected_size);
-    if (!buffer) {
+    if (conn->buf_cap >= size) {
+        return dd_success;
+    }
+
+    size_t new_cap = conn->buf_cap ? conn->buf_cap : RECV_BUFFER_INITIAL_SIZE;
+    while (new_cap < size) {
+        new_cap *= 2;
+    }
+    char *new_buf = realloc(conn->buf, new_cap);
+    if (!new_buf) {
+        mlog(dd_log_warning, "Failed to grow receive buffer to %zu bytes",
+            new_cap);
         return dd_error;
     }
-    *data = buffer;
-    *data_len = expected_size;
+    conn->buf = new_buf;
+    conn->buf_cap = new_cap;
 
-    size_t remaining_bytes = expected_size;
-    mlog(dd_log_debug, "Will receive message body. Expected size: %zu",
-        expected_size);
-    while (remaining_bytes > 0) {
-        ssize_t recv_bytes = recv(sock, buffer, remaining_bytes, 0);
-        if (recv_bytes == -1) {
-            mlog_err(dd_log_info, "Error receiving the body of a message");
-            goto error;
+    return dd_success;
+}
+
+#ifdef SO_PASSCRED
+static dd_result _check_credentials(struct cmsghdr *cmsgp);
+static ssize_t _recvmsg_cred(dd_conn *nonnull conn, char *nonnull dst,
+    size_t len, dd_result *nonnull cred_res);
+#endif
+// Receives as much as is available and fits in the buffer
+static dd_result _recv_available(dd_conn *nonnull conn,
+    const struct timespec *nullable deadline, bool *nonnull check_cred)
+{
+    char *dst = conn->buf + conn->buf_end;
+    size_t len = conn->buf_cap - conn->buf_end;
+
+    while (true) {
+        ssize_t recv_bytes;
+#ifdef SO_PASSCRED
+        if (*check_cred) {
+            dd_result cred_res = dd_success;
+            recv_bytes = _recvmsg_cred(conn, dst, len, &cred_res);
+            if (recv_bytes > 0) {
+                *check_cred = false;
+                if (cred_res) {
+                    return cred_res;
+                }
+            }
+        } else
+#endif
+        {
+            recv_bytes = recv(conn->socket, dst, len, 0);
+        }
+
+        if (recv_bytes > 0) {
+            conn->buf_end += (size_t)recv_bytes;
+            return dd_success;
         }
         if (recv_bytes == 0) {
             mlog(dd_log_info,
-                "recv() call yielded no data. Total received %zu out of %zu",
-                expected_size - remaining_bytes, expected_size);
-            goto error;
+                "recv() call yielded no data. Total received %zu bytes",
+                conn->buf_end);
+            return dd_network;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            mlog_err(dd_log_info, "Error receiving data from helper");
+            return dd_network;
         }
 
-        buffer += recv_bytes;
-        remaining_bytes -= recv_bytes;
+        dd_result res = _wait_for(conn, POLLIN, deadline);
+        if (res) {
+            return res;
+        }
     }
-    mlog(dd_log_debug, "Got full response. Size %zu", expected_size);
-
-    return dd_success;
-error:
-    free(buffer);
-    return dd_network;
 }
 
 #ifdef SO_PASSCRED
-static dd_result _check_credentials(struct cmsghdr *cmsgp);
-dd_result dd_conn_recv_cred(dd_conn *nonnull conn, char *nullable *nonnull data,
-    size_t *nonnull data_len)
+static ssize_t _recvmsg_cred(dd_conn *nonnull conn, char *nonnull dst,
+    size_t len, dd_result *nonnull cred_res)
 {
-    if (conn == NULL || conn->socket <= 0 || data == NULL) {
-        mlog(dd_log_warning, "Invalid arguments. Bug");
-        return dd_error;
-    }
-
     union {
         char buf[CMSG_SPACE(sizeof(struct ucred))];
         struct cmsghdr _align;
     } control;
 
-    dd_header h;
     struct iovec iov = {
-        .iov_base = &h,
-        .iov_len = sizeof h,
+        .iov_base = dst,
+        .iov_len = len,
     };
     struct msghdr msgh = {
         .msg_iov = &iov,
@@ -347,38 +492,23 @@ dd_result dd_conn_recv_cred(dd_conn *nonnull conn, char *nullable *nonnull data,
     };
 
     ssize_t recv_bytes = recvmsg(conn->socket, &msgh, 0);
-    if (recv_bytes == -1) {
-        mlog_err(dd_log_info, "Error receviving data from helper");
-        // will return after setsockopt() call
+    if (recv_bytes <= 0) {
+        return recv_bytes; // EAGAIN is handled by the caller
     }
 
+    int errno_copy = errno;
     setsockopt(conn->socket, SOL_SOCKET, SO_PASSCRED, &(int){0}, sizeof(int));
-
-    if (recv_bytes == 0) {
-        mlog(dd_log_info, "No data received");
-        return dd_network;
-    }
-    if ((size_t)recv_bytes < sizeof(h)) {
-        mlog(dd_log_info, "Not enough data received for the header");
-        return dd_network;
-    }
+    errno = errno_copy;
 
     // check credentials
     if (msgh.msg_flags & MSG_CTRUNC) { // NOLINT
         mlog(dd_log_info, "Truncated ancillary data");
     }
-    dd_result ddres = _check_credentials(CMSG_FIRSTHDR(&msgh));
-    if (ddres) {
-        return ddres;
-    }
+    *cred_res = _check_credentials(CMSG_FIRSTHDR(&msgh));
 
-    if (strncmp(h.code, "dds", 3) != 0) {
-        mlog(dd_log_warning, "Invalid message header from helper");
-        return dd_network;
-    }
-
-    return _recv_message_body(conn->socket, data, data_len, h.size);
+    return recv_bytes;
 }
+
 static dd_result _check_credentials(struct cmsghdr *cmsgp)
 {
     if (!cmsgp || cmsgp->cmsg_len != CMSG_LEN(sizeof(struct ucred))) {
@@ -417,16 +547,11 @@ static dd_result _check_credentials(struct cmsghdr *cmsgp)
     mlog(dd_log_debug, "Helper's process credentials are correct");
     return dd_success;
 }
-#else // no SO_PASSCRED
-dd_result dd_conn_recv_cred(dd_conn *nonnull conn, char *nullable *nonnull data,
-    size_t *nonnull data_len)
-{
-    return dd_conn_recv(conn, data, data_len);
-}
 #endif
 
 int dd_conn_destroy(dd_conn *nonnull conn)
 {
+    conn->buf_start = conn->buf_end = 0;
     if (conn->socket == -1) {
         return 0;
     }
@@ -434,40 +559,83 @@ int dd_conn_destroy(dd_conn *nonnull conn)
     conn->socket = -1;
     return ret;
 }
+
+void dd_conn_free_buffer(dd_conn *nonnull conn)
+{
+    free(conn->buf);
+    conn->buf = NULL;
+    conn->buf_cap = conn->buf_start = conn->buf_end = 0;
+}
+
 dd_result dd_conn_set_timeout(
     dd_conn *nonnull conn, enum comm_type comm_type, int milliseconds) // NOLINT
 {
-    int type;
+    if (!dd_conn_connected(conn)) {
+        return dd_error;
+    }
+
     if (comm_type == comm_type_recv) {
-        type = SO_RCVTIMEO;
+        conn->recv_timeout_ms = milliseconds;
     } else if (comm_type == comm_type_send) {
-        type = SO_SNDTIMEO;
+        conn->send_timeout_ms = milliseconds;
     } else {
         return dd_error;
     }
-    if (!dd_conn_connected(conn)) {
-        return dd_error;
-    }
 
-    int time_seconds = milliseconds / 1000;               // NOLINT
-    int time_microseconds = (milliseconds % 1000) * 1000; // NOLINT
+    mlog(dd_log_debug, "setting %s timeout to %d ms",
+        comm_type == comm_type_recv ? "recv" : "send", milliseconds);
 
-    /* 200 ms = 200 * 1000 us */
-    struct timeval timeout;
-    timeout.tv_sec = time_seconds;
-    timeout.tv_usec = time_microseconds;
-
-    mlog(dd_log_debug, "setting timeout to %u.%06u", time_seconds,
-        time_microseconds);
+    return dd_success;
+}
 
-    int res =
-        setsockopt(conn->socket, SOL_SOCKET, type, &timeout, sizeof(timeout));
-    if (res) {
-        mlog_err(dd_log_warning, "setsockopt (%d) error: (%d ms)", type,
-            milliseconds);
+static struct timespec *nullable _deadline_from_timeout(
+    struct timespec *nonnull deadline, int timeout_ms)
+{
+    if (timeout_ms <= 0) {
+        return NULL;
     }
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    _timespec_add_ms(deadline, timeout_ms);
+    return deadline;
+}
 
-    return dd_success;
+static dd_result _wait_for(dd_conn *nonnull conn, short events,
+    const struct timespec *nullable deadline)
+{
+    while (true) {
+        int timeout = -1;
+        if (deadline) {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            long time_left = _timespec_delta_ms(deadline, &now);
+            if (time_left <= 0) {
+                mlog(dd_log_info, "Timed out %s helper",
+                    events == POLLIN ? "waiting for data from"
+                                     : "sending data to");
+                return dd_network;
+            }
+            timeout = (int)time_left;
+        }
+
+        struct pollfd pfd = {.fd = conn->socket, .events = events};
+        int res = poll(&pfd, 1, timeout);
+        if (res == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            mlog_err(dd_log_info, "Error in connection to helper (poll() call)");
+            return dd_network;
+        }
+        if (res == 0) {
+            continue; // the deadline check above will fire
+        }
+        if (pfd.revents & (POLLERR | POLLNVAL)) { // NOLINT
+            mlog(dd_log_info, "Error in connection to helper (POLLERR)");
+            return dd_network;
+        }
+        // POLLHUP: let the following recv()/writev() report it
+        return dd_success;
+    }
 }
 
 #define ONE_E3 1000
@@ -487,7 +655,8 @@ static void _timespec_add_ms(struct timespec *ts, long num_ms)
     }
 }
 
-static long _timespec_delta_ms(struct timespec *ts1, struct timespec *ts2)
+static long _timespec_delta_ms(
+    const struct timespec *ts1, const struct timespec *ts2)
 {
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     long res = (ts1->tv_sec - ts2->tv_sec) * 1000;
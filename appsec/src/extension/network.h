@@ -19,6 +19,14 @@
 struct _dd_conn {
     struct sockaddr_un addr;
     int socket;
+    int send_timeout_ms;
+    int recv_timeout_ms;
+    // Receive buffer, kept across requests and reconnections. It grows
+    // geometrically and is freed with dd_conn_free_buffer()
+    char *nullable buf;
+    size_t buf_cap;
+    size_t buf_start; // start of the data not yet handed out
+    size_t buf_end;   // end of the data received
 };
 enum comm_type {
     comm_type_recv,
@@ -29,8 +37,10 @@ typedef struct _dd_conn dd_conn;
 
 dd_result dd_conn_sendv(dd_conn *nonnull conn, zend_llist *nonnull iovecs);
 dd_result dd_conn_sendv_cred(dd_conn *nonnull conn, zend_llist *nonnull iovecs);
-dd_result dd_conn_recv(dd_conn *nonnull conn, char *nullable *nonnull data, size_t *nonnull data_len);
-dd_result dd_conn_recv_cred(dd_conn *nonnull conn, char *nullable *nonnull data, size_t *nonnull data_len);
+// *data points into the connection's receive buffer. It must not be freed and
+// is only valid until the next call to dd_conn_recv[_cred]
+dd_result dd_conn_recv(dd_conn *nonnull conn, const char *nullable *nonnull data, size_t *nonnull data_len);
+dd_result dd_conn_recv_cred(dd_conn *nonnull conn, const char *nullable *nonnull data, size_t *nonnull data_len);
 
 // for helper_process
 #ifdef HELPER_PROCESS_C_INCLUDES
@@ -43,6 +53,8 @@ int dd_conn_init(
     dd_conn *nonnull conn, const char *nonnull path, size_t path_len);
 
 int dd_conn_destroy(dd_conn *nonnull conn);
+void dd_conn_free_buffer(dd_conn *nonnull conn);
+// Deadline for a whole message; 0 means no deadline
 dd_result dd_conn_set_timeout(
     dd_conn *nonnull conn, enum comm_type comm_type, int milliseconds);
 
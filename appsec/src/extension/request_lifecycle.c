@@ -8,6 +8,8 @@
 #include "ddappsec.h"
 #include "dddefs.h"
 #include "ddtrace.h"
+#include "deferred_addresses.h"
+#include "enablement_state.h"
 #include "entity_body.h"
 #include "helper_process.h"
 #include "ip_extraction.h"
@@ -186,6 +188,12 @@ static zend_array *nullable _do_request_begin(
     dd_conn *conn =
         dd_helper_mgr_acquire_conn((client_init_func)dd_client_init, &req_info);
     if (conn == NULL) {
+        if (dd_helper_mgr_breaker_open() && req_info.req_info.root_span) {
+            // fail open, but make it visible on the trace
+            dd_trace_span_add_tag_str(req_info.req_info.root_span,
+                ZEND_STRL("_dd.appsec.helper.circuit_breaker"),
+                ZEND_STRL("open"));
+        }
         mlog_g(dd_log_debug,
             "No connection; skipping rest of request initialization");
         if (rbe) {
@@ -195,9 +203,12 @@ static zend_array *nullable _do_request_begin(
     }
 
     int res = dd_success;
+    // While AppSec is off and can only be turned on remotely, only ask the
+    // helper once it has published a change of the enablement state
     if (_rem_cfg_path_changed(true) ||
         (!DDAPPSEC_G(active) &&
-            DDAPPSEC_G(enabled) == APPSEC_ENABLED_VIA_REMCFG)) {
+            DDAPPSEC_G(enabled) == APPSEC_ENABLED_VIA_REMCFG &&
+            dd_enablement_state_changed(_last_rem_cfg_path))) {
         res = dd_config_sync(conn,
             &(struct config_sync_data){.rem_cfg_path = _last_rem_cfg_path});
         if (res == dd_success && DDAPPSEC_G(active)) {
@@ -407,6 +418,7 @@ static void _reset_globals()
     ZVAL_UNDEF(&_blocking_function);
 
     _shutdown_done_on_commit = false;
+    dd_deferred_addresses_rshutdown();
     dd_tags_rshutdown();
 }
 
@@ -12,6 +12,7 @@
 
 #include "action.hpp"
 #include "client.hpp"
+#include "enablement_state.hpp"
 #include "exception.hpp"
 #include "network/broker.hpp"
 #include "network/proto.hpp"
@@ -296,6 +297,10 @@ bool client::handle_command(network::request_init::request &command)
     context_.emplace(*service_->get_engine());
 
     auto response = publish<network::request_init>(command);
+    if (response) {
+        // NOLINTNEXTLINE(bugprone-unchecked-optional-access)
+        response->may_block = context_->may_block();
+    }
 
     return send_message<network::request_init>(response);
 }
@@ -330,6 +335,8 @@ bool client::compute_client_status()
         service_->get_service_config()->get_asm_enabled_status() ==
         enable_asm_status::ENABLED;
 
+    enablement_state::publish(service_->get_rc_path(), request_enabled_);
+
     return request_enabled_;
 }
 
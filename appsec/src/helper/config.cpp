@@ -17,6 +17,9 @@ config::config(
     kv_[env_socket_file_path] = get_env(env_socket_file_path);
     kv_[env_lock_file_path] = get_env(env_lock_file_path);
     kv_[env_log_file_path] = get_env(env_log_file_path);
+    kv_[env_handoff_socket_path] = get_env(env_handoff_socket_path);
+    kv_[env_idle_trim_interval] = get_env(env_idle_trim_interval);
+    kv_[env_watch_rules_file] = get_env(env_watch_rules_file);
     kv_[env_log_level] = get_env(env_log_level);
 }
 
@@ -26,6 +29,9 @@ const std::unordered_map<std::string_view, std::string_view> config::defaults =
         {env_lock_file_path, "/tmp/ddappsec.lock"},
         {env_socket_file_path, "/tmp/ddappsec.sock"},
         {env_log_file_path, "/tmp/ddappsec_helper.log"},
+        {env_handoff_socket_path, ""},
+        {env_idle_trim_interval, "10"},
+        {env_watch_rules_file, "false"},
         {env_log_level, "warn"},
 };
 
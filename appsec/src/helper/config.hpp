@@ -36,6 +36,34 @@ public:
         return kv_.at(env_log_file_path);
     }
 
+    // Empty if handing off to a newer helper is disabled
+    [[nodiscard]] std::string_view handoff_socket_path() const
+    {
+        return kv_.at(env_handoff_socket_path);
+    }
+
+    // How often freed memory is given back to the OS, zero disables it
+    [[nodiscard]] std::chrono::seconds idle_trim_interval() const
+    {
+        auto value = kv_.at(env_idle_trim_interval);
+        try {
+            return std::chrono::seconds{boost::lexical_cast<unsigned>(value)};
+        } catch (const boost::bad_lexical_cast &) {
+            auto fallback = defaults.at(env_idle_trim_interval);
+            SPDLOG_WARN("Invalid value '{}' for {}, using {}", value,
+                env_idle_trim_interval, fallback);
+            return std::chrono::seconds{
+                boost::lexical_cast<unsigned>(fallback)};
+        }
+    }
+
+    // Reload DD_APPSEC_RULES files when they change on disk
+    [[nodiscard]] bool watch_rules_file() const
+    {
+        auto value = kv_.at(env_watch_rules_file);
+        return value == "true" || value == "1";
+    }
+
     [[nodiscard]] spdlog::level::level_enum log_level() const
     {
         return spdlog::level::from_str(std::string{kv_.at(env_log_level)});
@@ -52,6 +80,12 @@ protected:
         "_DD_SIDECAR_APPSEC_LOCK_FILE_PATH";
     static constexpr std::string_view env_log_file_path =
         "_DD_SIDECAR_APPSEC_LOG_FILE_PATH";
+    static constexpr std::string_view env_handoff_socket_path =
+        "_DD_SIDECAR_APPSEC_HANDOFF_SOCKET_PATH";
+    static constexpr std::string_view env_idle_trim_interval =
+        "_DD_SIDECAR_APPSEC_IDLE_TRIM_INTERVAL";
+    static constexpr std::string_view env_watch_rules_file =
+        "_DD_SIDECAR_APPSEC_WATCH_RULES_FILE";
     static constexpr std::string_view env_log_level =
         "_DD_SIDECAR_APPSEC_LOG_LEVEL";
 };
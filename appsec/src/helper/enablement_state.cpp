@@ -0,0 +1,147 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "enablement_state.hpp"
+#include "utils.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace dds::enablement_state {
+
+namespace {
+struct entry {
+    segment *seg{nullptr}; // mapped on first publish
+    unsigned refs{0};
+};
+
+std::mutex mtx;                                 // NOLINT
+std::unordered_map<std::string, entry> entries; // NOLINT
+bool detached = false;                          // NOLINT
+
+std::string segment_name(const std::string &rc_path)
+{
+    std::string name = rc_path.front() == '/' ? rc_path : "/" + rc_path;
+    name += "-asm";
+    return name;
+}
+
+segment *map_segment(const std::string &rc_path)
+{
+    const std::string name = segment_name(rc_path);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd == -1) {
+        SPDLOG_WARN("Failed to open enablement state {}: errno {}", name, errno);
+        return nullptr;
+    }
+    auto close_fd = defer([fd]() { ::close(fd); });
+
+    if (::ftruncate(fd, sizeof(segment)) == -1) {
+        SPDLOG_WARN(
+            "Failed to size enablement state {}: errno {}", name, errno);
+        return nullptr;
+    }
+
+    void *addr = ::mmap(nullptr, sizeof(segment), PROT_READ | PROT_WRITE,
+        MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        SPDLOG_WARN("Failed to map enablement state {}: errno {}", name, errno);
+        return nullptr;
+    }
+
+    // The segment may outlive a previous helper, keep its generation going
+    return static_cast<segment *>(addr);
+}
+} // namespace
+
+void publish(std::string_view rc_path, bool enabled)
+{
+    if (rc_path.empty()) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock{mtx};
+    auto &ent = entries[std::string{rc_path}];
+    if (ent.seg == nullptr) {
+        ent.seg = map_segment(std::string{rc_path});
+        if (ent.seg == nullptr) {
+            return;
+        }
+    }
+
+    segment *seg = ent.seg;
+    const std::uint32_t value = enabled ? 1 : 0;
+    if (seg->generation.load(std::memory_order_relaxed) != 0 &&
+        seg->enabled.load(std::memory_order_relaxed) == value) {
+        return;
+    }
+
+    seg->enabled.store(value, std::memory_order_relaxed);
+    auto generation = seg->generation.load(std::memory_order_relaxed) + 1;
+    if (generation == 0) {
+        generation = 1;
+    }
+    seg->generation.store(generation, std::memory_order_release);
+
+    SPDLOG_DEBUG("Published AppSec enablement {} for {} (generation {})",
+        enabled, rc_path, generation);
+}
+
+void acquire(std::string_view rc_path)
+{
+    if (rc_path.empty()) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock{mtx};
+    ++entries[std::string{rc_path}].refs;
+}
+
+void release(std::string_view rc_path)
+{
+    if (rc_path.empty()) {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock{mtx};
+    auto it = entries.find(std::string{rc_path});
+    if (it == entries.end() || --it->second.refs > 0) {
+        return;
+    }
+
+    segment *seg = it->second.seg;
+    if (seg != nullptr) {
+        if (!detached) {
+            seg->generation.store(0, std::memory_order_release);
+        }
+        ::munmap(seg, sizeof(segment));
+
+        if (!detached) {
+            const std::string name = segment_name(it->first);
+            if (::shm_unlink(name.c_str()) == -1 && errno != ENOENT) {
+                SPDLOG_WARN(
+                    "Failed to unlink enablement state {}: errno {}", name,
+                    errno);
+            }
+        }
+    }
+    entries.erase(it);
+}
+
+void detach()
+{
+    const std::lock_guard<std::mutex> lock{mtx};
+    detached = true;
+}
+
+} // namespace dds::enablement_state
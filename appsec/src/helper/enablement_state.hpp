@@ -0,0 +1,40 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+// Whether AppSec is enabled for a remote config path, published next to the
+// remote config segment as <rc path>-asm. The extension compares the
+// generation with the one it last saw and only sends config_sync when it
+// changed, see extension/enablement_state.c.
+namespace dds::enablement_state {
+
+struct segment {
+    std::atomic<std::uint32_t> generation;
+    std::atomic<std::uint32_t> enabled;
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(sizeof(segment) == 2 * sizeof(std::uint32_t));
+
+// Bumps the generation if the state changed. Failures are only logged, the
+// extension then keeps sending config_sync on every request.
+void publish(std::string_view rc_path, bool enabled);
+
+// Services using a remote config path hold a reference to its segment. Once
+// the last one goes away the segment is reset (generation 0 makes extensions
+// map it again) and unlinked, so that /dev/shm doesn't fill up.
+void acquire(std::string_view rc_path);
+void release(std::string_view rc_path);
+
+// After a handoff the successor publishes to the same segments, don't unlink
+// them when our services go away
+void detach();
+
+} // namespace dds::enablement_state
@@ -22,14 +22,20 @@ void engine::subscribe(std::unique_ptr<subscriber> sub)
     common_->subscribers.emplace_back(std::move(sub));
 }
 
-void engine::update(engine_ruleset &ruleset,
+void engine::update(const engine_ruleset &ruleset,
     std::map<std::string, std::string> &meta,
     std::map<std::string_view, double> &metrics)
 {
+    // Otherwise concurrent updates would both start from the same state and
+    // the last one to be stored would drop the changes of the other
+    const std::lock_guard<std::mutex> lock{update_mutex_};
+    auto common =
+        std::atomic_load_explicit(&common_, std::memory_order_acquire);
+
     std::vector<std::unique_ptr<subscriber>> new_subscribers;
-    new_subscribers.reserve(common_->subscribers.size());
+    new_subscribers.reserve(common->subscribers.size());
     dds::parameter param = json_to_parameter(ruleset.get_document());
-    for (auto &sub : common_->subscribers) {
+    for (auto &sub : common->subscribers) {
         try {
             new_subscribers.emplace_back(sub->update(param, meta, metrics));
         } catch (const std::exception &e) {
@@ -109,6 +115,16 @@ std::optional<engine::result> engine::context::publish(parameter &&param)
     return res;
 }
 
+bool engine::context::may_block() const
+{
+    for (const auto &sub : common_->subscribers) {
+        if (sub->may_block()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void engine::context::get_meta_and_metrics(
     std::map<std::string, std::string> &meta,
     std::map<std::string_view, double> &metrics)
@@ -124,7 +140,8 @@ std::unique_ptr<engine> engine::from_settings(
     std::map<std::string_view, double> &metrics)
 {
     auto &&rules_path = eng_settings.rules_file_or_default();
-    auto ruleset = engine_ruleset::from_path(rules_path);
+    // The DOM is only needed for RC updates, go straight to a WAF object
+    auto ruleset = engine_ruleset::parameter_from_path(rules_path);
     std::unique_ptr<engine> engine_ptr{
         engine::create(eng_settings.trace_rate_limit)};
 
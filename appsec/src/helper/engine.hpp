@@ -15,6 +15,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <rapidjson/document.h>
 #include <spdlog/fmt/ostr.h>
 #include <string>
@@ -70,6 +71,9 @@ public:
         void get_meta_and_metrics(std::map<std::string, std::string> &meta,
             std::map<std::string_view, double> &metrics);
 
+        // Whether the ruleset this context runs may block the request
+        [[nodiscard]] bool may_block() const;
+
     protected:
         std::shared_ptr<shared_state> common_;
         std::map<subscriber *, const std::unique_ptr<subscriber::listener>>
@@ -101,7 +105,9 @@ public:
     // Not thread-safe, should only be called after construction
     void subscribe(std::unique_ptr<subscriber> sub);
 
-    virtual void update(engine_ruleset &ruleset,
+    // Thread-safe: remote config and rules file reloads may update the same
+    // engine, each update builds on the result of the previous one
+    virtual void update(const engine_ruleset &ruleset,
         std::map<std::string, std::string> &meta,
         std::map<std::string_view, double> &metrics);
 
@@ -112,6 +118,7 @@ protected:
 
     // in practice: the current ddwaf_handle, atomically swapped in update
     std::shared_ptr<shared_state> common_;
+    std::mutex update_mutex_;
     rate_limiter<dds::timer> limiter_;
 };
 
@@ -10,10 +10,66 @@
 
 #include "engine_ruleset.hpp"
 #include "exception.hpp"
+#include "json_helper.hpp"
 #include "utils.hpp"
+#include <cstring>
+#include <ddwaf.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <system_error>
+#include <unordered_map>
 
 namespace dds {
 
+namespace {
+constexpr std::string_view default_processors_and_scanners =
+    R"({"processors":[{"id":"processor-001","generator":"extract_schema","conditions":[{"operator":"equals","parameters":{"inputs":[{"address":"waf.context.processor","key_path":["extract-schema"]}],"type":"boolean","value":true}}],"parameters":{"mappings":[{"inputs":[{"address":"server.request.body"}],"output":"_dd.appsec.s.req.body"},{"inputs":[{"address":"server.request.headers.no_cookies"}],"output":"_dd.appsec.s.req.headers"},{"inputs":[{"address":"server.request.query"}],"output":"_dd.appsec.s.req.query"},{"inputs":[{"address":"server.request.path_params"}],"output":"_dd.appsec.s.req.params"},{"inputs":[{"address":"server.request.cookies"}],"output":"_dd.appsec.s.req.cookies"},{"inputs":[{"address":"server.response.headers.no_cookies"}],"output":"_dd.appsec.s.res.headers"},{"inputs":[{"address":"server.response.body"}],"output":"_dd.appsec.s.res.body"}],"scanners":[{"tags":{"category":"pii"}}]},"evaluate":false,"output":true}],"scanners":[{"id":"d962f7ddb3f55041e39195a60ff79d4814a7c331","name":"US Passport Scanner","key":{"operator":"match_regex","parameters":{"regex":"passport","options":{"case_sensitive":false,"min_length":8}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b[0-9A-Z]{9}\\b|\\b[0-9]{6}[A-Z][0-9]{2}\\b","options":{"case_sensitive":false,"min_length":8}}},"tags":{"type":"passport_number","category":"pii"}},{"id":"ac6d683cbac77f6e399a14990793dd8fd0fca333","name":"US Vehicle Identification Number Scanner","key":{"operator":"match_regex","parameters":{"regex":"vehicle[_\\s-]*identification[_\\s-]*number|vin","options":{"case_sensitive":false,"min_length":3}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b[A-HJ-NPR-Z0-9]{17}\\b","options":{"case_sensitive":false,"min_length":17}}},"tags":{"type":"vin","category":"pii"}},{"id":"de0899e0cbaaa812bb624cf04c912071012f616d","name":"UK National Insurance Number Scanner","key":{"operator":"match_regex","parameters":{"regex":"national[\\s_]?(?:insurance(?:\\s+number)?)?|NIN|NI[\\s_]?number|insurance[\\s_]?number","options":{"case_sensitive":false,"min_length":3}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b[A-Z]{2}\\d{6}[A-Z]?\\b","options":{"case_sensitive":false,"min_length":8}}},"tags":{"type":"uk_nin","category":"pii"}},{"id":"450239afc250a19799b6c03dc0e16fd6a4b2a1af","name":"Canadian Social Insurance Number Scanner","key":{"operator":"match_regex","parameters":{"regex":"social[\\s_]?(?:insurance(?:\\s+number)?)?|SIN|Canadian[\\s_]?(?:social[\\s_]?(?:insurance)?|insurance[\\s_]?number)?","options":{"case_sensitive":false,"min_length":3}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b\\d{3}-\\d{3}-\\d{3}\\b","options":{"case_sensitive":false,"min_length":11}}},"tags":{"type":"canadian_sin","category":"pii"}}]})";
+
+// Moves the entries of the map src at the end of the map dst, keeping their
+// keys. Unlike parameter::add, this doesn't copy the keys or the values.
+void append_map_entries(parameter &dst, parameter &src)
+{
+    if (src.nbEntries == 0) {
+        return;
+    }
+
+    auto total = dst.nbEntries + src.nbEntries;
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    auto *array = static_cast<ddwaf_object *>(
+        realloc(dst.array, total * sizeof(ddwaf_object)));
+    if (array == nullptr) {
+        throw std::bad_alloc();
+    }
+    memcpy(&array[dst.nbEntries], src.array,
+        src.nbEntries * sizeof(ddwaf_object));
+    dst.array = array;
+    dst.nbEntries = total;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+    free(src.array);
+    src.array = nullptr;
+    src.nbEntries = 0;
+}
+
+struct cached_ruleset {
+    ino_t ino{};
+    dev_t dev{};
+    off_t size{};
+    struct timespec mtime {};
+    std::shared_ptr<const engine_ruleset> ruleset;
+
+    [[nodiscard]] bool matches(const struct stat &st) const
+    {
+        return ino == st.st_ino && dev == st.st_dev && size == st.st_size &&
+               mtime.tv_sec == st.st_mtim.tv_sec &&
+               mtime.tv_nsec == st.st_mtim.tv_nsec;
+    }
+};
+
+std::mutex ruleset_cache_mtx;                                   // NOLINT
+std::unordered_map<std::string, cached_ruleset> ruleset_cache; // NOLINT
+} // namespace
+
 engine_ruleset::engine_ruleset(std::string_view ruleset)
 {
     rapidjson::ParseResult const result = doc_.Parse(ruleset.data());
@@ -24,8 +80,7 @@ engine_ruleset::engine_ruleset(std::string_view ruleset)
 
 void engine_ruleset::add_default_processors_and_scanners()
 {
-    std::string raw =
-        R"({"processors":[{"id":"processor-001","generator":"extract_schema","conditions":[{"operator":"equals","parameters":{"inputs":[{"address":"waf.context.processor","key_path":["extract-schema"]}],"type":"boolean","value":true}}],"parameters":{"mappings":[{"inputs":[{"address":"server.request.body"}],"output":"_dd.appsec.s.req.body"},{"inputs":[{"address":"server.request.headers.no_cookies"}],"output":"_dd.appsec.s.req.headers"},{"inputs":[{"address":"server.request.query"}],"output":"_dd.appsec.s.req.query"},{"inputs":[{"address":"server.request.path_params"}],"output":"_dd.appsec.s.req.params"},{"inputs":[{"address":"server.request.cookies"}],"output":"_dd.appsec.s.req.cookies"},{"inputs":[{"address":"server.response.headers.no_cookies"}],"output":"_dd.appsec.s.res.headers"},{"inputs":[{"address":"server.response.body"}],"output":"_dd.appsec.s.res.body"}],"scanners":[{"tags":{"category":"pii"}}]},"evaluate":false,"output":true}],"scanners":[{"id":"d962f7ddb3f55041e39195a60ff79d4814a7c331","name":"US Passport Scanner","key":{"operator":"match_regex","parameters":{"regex":"passport","options":{"case_sensitive":false,"min_length":8}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b[0-9A-Z]{9}\\b|\\b[0-9]{6}[A-Z][0-9]{2}\\b","options":{"case_sensitive":false,"min_length":8}}},"tags":{"type":"passport_number","category":"pii"}},{"id":"ac6d683cbac77f6e399a14990793dd8fd0fca333","name":"US Vehicle Identification Number Scanner","key":{"operator":"match_regex","parameters":{"regex":"vehicle[_\\s-]*identification[_\\s-]*number|vin","options":{"case_sensitive":false,"min_length":3}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b[A-HJ-NPR-Z0-9]{17}\\b","options":{"case_sensitive":false,"min_length":17}}},"tags":{"type":"vin","category":"pii"}},{"id":"de0899e0cbaaa812bb624cf04c912071012f616d","name":"UK National Insurance Number Scanner","key":{"operator":"match_regex","parameters":{"regex":"national[\\s_]?(?:insurance(?:\\s+number)?)?|NIN|NI[\\s_]?number|insurance[\\s_]?number","options":{"case_sensitive":false,"min_length":3}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b[A-Z]{2}\\d{6}[A-Z]?\\b","options":{"case_sensitive":false,"min_length":8}}},"tags":{"type":"uk_nin","category":"pii"}},{"id":"450239afc250a19799b6c03dc0e16fd6a4b2a1af","name":"Canadian Social Insurance Number Scanner","key":{"operator":"match_regex","parameters":{"regex":"social[\\s_]?(?:insurance(?:\\s+number)?)?|SIN|Canadian[\\s_]?(?:social[\\s_]?(?:insurance)?|insurance[\\s_]?number)?","options":{"case_sensitive":false,"min_length":3}}},"value":{"operator":"match_regex","parameters":{"regex":"\\b\\d{3}-\\d{3}-\\d{3}\\b","options":{"case_sensitive":false,"min_length":11}}},"tags":{"type":"canadian_sin","category":"pii"}}]})";
+    std::string raw{default_processors_and_scanners};
     rapidjson::Document::AllocatorType &alloc = doc_.GetAllocator();
     rapidjson::Document additions_doc(&alloc);
     rapidjson::ParseResult const parsed = additions_doc.Parse(raw.data());
@@ -53,4 +108,44 @@ engine_ruleset engine_ruleset::from_path(std::string_view path)
     return engine;
 }
 
+std::shared_ptr<const engine_ruleset> engine_ruleset::cached_from_path(
+    std::string_view path)
+{
+    const std::string key{path};
+    struct stat st {};
+    if (::stat(key.c_str(), &st) == -1) {
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    {
+        const std::lock_guard lock{ruleset_cache_mtx};
+        auto it = ruleset_cache.find(key);
+        if (it != ruleset_cache.end() && it->second.matches(st)) {
+            return it->second.ruleset;
+        }
+    }
+
+    // Parse outside of the lock, concurrent misses on the same file are rare
+    // and whoever finishes last just replaces the entry
+    auto ruleset = std::make_shared<const engine_ruleset>(from_path(key));
+
+    const std::lock_guard lock{ruleset_cache_mtx};
+    ruleset_cache[key] = {
+        st.st_ino, st.st_dev, st.st_size, st.st_mtim, ruleset};
+    return ruleset;
+}
+
+parameter engine_ruleset::parameter_from_path(std::string_view path)
+{
+    auto ruleset = json_to_parameter(read_file(path));
+    if (ruleset.type() != parameter_type::map) {
+        throw parsing_error("invalid json rule");
+    }
+
+    auto additions = json_to_parameter(default_processors_and_scanners);
+    append_map_entries(ruleset, additions);
+
+    return ruleset;
+}
+
 } // namespace dds
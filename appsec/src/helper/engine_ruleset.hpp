@@ -5,6 +5,8 @@
 // (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
 #pragma once
 
+#include "parameter.hpp"
+#include <memory>
 #include <rapidjson/document.h>
 #include <string_view>
 
@@ -27,6 +29,16 @@ public:
 
     static engine_ruleset from_path(std::string_view path);
 
+    // Same as from_path, but the parsed ruleset is shared across callers
+    // until the file is replaced or modified (different inode, size or
+    // mtime). The returned ruleset must not be modified.
+    static std::shared_ptr<const engine_ruleset> cached_from_path(
+        std::string_view path);
+
+    // Same contents as from_path(path).get_document() converted with
+    // json_to_parameter, but parsed straight into a WAF object
+    static parameter parameter_from_path(std::string_view path);
+
     // Used only for testing
     void copy(rapidjson::Document &new_doc)
     {
@@ -0,0 +1,295 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "handoff.hpp"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sstream>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace dds::handoff {
+
+namespace {
+constexpr std::size_t max_fds = 2;
+constexpr std::uint32_t max_state_size = 16 * 1024 * 1024;
+constexpr std::chrono::seconds transfer_timeout{5};
+constexpr char ready_byte = 'R';
+
+struct header {
+    std::uint32_t num_fds;
+    std::uint32_t state_size;
+};
+
+sockaddr_un make_address(std::string_view path)
+{
+    struct sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() > sizeof(addr.sun_path) - 1) {
+        throw std::invalid_argument{"handoff socket path too long"};
+    }
+    // NOLINTNEXTLINE
+    memcpy(static_cast<char *>(addr.sun_path), path.data(), path.size());
+    return addr;
+}
+
+void send_header(int sock, const header &hdr, const std::vector<int> &fds)
+{
+    struct iovec iov {};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    iov.iov_base = const_cast<header *>(&hdr);
+    iov.iov_len = sizeof(hdr);
+
+    std::array<char, CMSG_SPACE(sizeof(int) * max_fds)> control{};
+    struct msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+
+    ssize_t res;
+    do {
+        res = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (res == -1 && errno == EINTR);
+    if (res == -1) {
+        throw std::system_error(errno, std::generic_category());
+    }
+    if (static_cast<std::size_t>(res) != sizeof(hdr)) {
+        throw std::runtime_error{"short write of handoff header"};
+    }
+}
+
+header recv_header(int sock, std::vector<int> &fds)
+{
+    header hdr{};
+    struct iovec iov {};
+    iov.iov_base = &hdr;
+    iov.iov_len = sizeof(hdr);
+
+    std::array<char, CMSG_SPACE(sizeof(int) * max_fds)> control{};
+    struct msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+
+    ssize_t res;
+    do {
+        res = ::recvmsg(sock, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+    } while (res == -1 && errno == EINTR);
+    if (res == -1) {
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    // Collect the descriptors first so that they're not leaked on error
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t i = 0; i < count; i++) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+            fds.push_back(fd);
+        }
+    }
+
+    if (static_cast<std::size_t>(res) != sizeof(hdr) ||
+        (msg.msg_flags & MSG_CTRUNC) != 0 || hdr.num_fds == 0 ||
+        hdr.num_fds != fds.size()) {
+        throw std::runtime_error{"invalid handoff header"};
+    }
+
+    return hdr;
+}
+} // namespace
+
+listener::listener(std::string_view path)
+    // NOLINTNEXTLINE(android-cloexec-socket)
+    : sock_(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)), path_{path}
+{
+    if (sock_ == -1) {
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    struct sockaddr_un addr {};
+    try {
+        addr = make_address(path);
+    } catch (...) {
+        ::close(sock_);
+        throw;
+    }
+
+    // The previous helper, if any, has already handed off to us
+    int res = ::unlink(path_.c_str());
+    if (res == -1 && errno != ENOENT) {
+        ::close(sock_);
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    // NOLINTNEXTLINE
+    res = ::bind(sock_, reinterpret_cast<struct sockaddr *>(&addr),
+        sizeof(addr));
+    if (res == -1 || ::listen(sock_, 1) == -1) {
+        auto err = errno;
+        ::close(sock_);
+        throw std::system_error(err, std::generic_category());
+    }
+
+    SPDLOG_INFO("Listening for handoff requests on {}", path_);
+}
+
+listener::~listener()
+{
+    // The path is not unlinked: after a handoff it belongs to the successor
+    ::close(sock_);
+}
+
+std::optional<network::local::socket> listener::wait_for_successor(
+    std::chrono::milliseconds timeout)
+{
+    struct pollfd pfd {
+        .fd = sock_, .events = POLLIN, .revents = 0
+    };
+    int const res = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+    if (res <= 0) {
+        return std::nullopt; // timeout or EINTR
+    }
+
+    int const s = ::accept4(sock_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (s == -1) {
+        SPDLOG_WARN("Failed to accept handoff connection: errno {}", errno);
+        return std::nullopt;
+    }
+
+    return network::local::socket{s};
+}
+
+bool hand_over(network::local::socket &conn, int listen_fd, int lock_fd,
+    const state &st, std::chrono::milliseconds ready_timeout)
+{
+    try {
+        std::stringstream ss;
+        msgpack::pack(ss, st);
+        const std::string serialized = ss.str();
+        if (serialized.size() > max_state_size) {
+            throw std::length_error{"handoff state too large"};
+        }
+
+        std::vector<int> fds{listen_fd};
+        if (lock_fd != -1) {
+            fds.push_back(lock_fd);
+        }
+
+        conn.set_send_timeout(transfer_timeout);
+        send_header(static_cast<int>(conn),
+            {static_cast<std::uint32_t>(fds.size()),
+                static_cast<std::uint32_t>(serialized.size())},
+            fds);
+
+        std::size_t sent = 0;
+        while (sent < serialized.size()) {
+            sent += conn.send(&serialized[sent], serialized.size() - sent);
+        }
+
+        SPDLOG_INFO("Handed off listening socket and {} services, waiting for "
+                    "successor to be ready",
+            st.services.size());
+
+        conn.set_recv_timeout(ready_timeout);
+        char ack = 0;
+        if (conn.recv(&ack, 1) != 1 || ack != ready_byte) {
+            SPDLOG_WARN("Successor did not confirm the handoff");
+            return false;
+        }
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Handoff failed: {}", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<predecessor> predecessor::connect(std::string_view path)
+{
+    auto addr = make_address(path);
+
+    // NOLINTNEXTLINE(android-cloexec-socket)
+    network::local::socket conn{
+        ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (static_cast<int>(conn) == -1) {
+        throw std::system_error(errno, std::generic_category());
+    }
+
+    // NOLINTNEXTLINE
+    if (::connect(static_cast<int>(conn),
+            reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1) {
+        SPDLOG_DEBUG(
+            "No helper to take over from on {}: errno {}", path, errno);
+        return std::nullopt;
+    }
+
+    predecessor pred{std::move(conn)};
+    std::vector<int> fds;
+    try {
+        pred.conn_.set_recv_timeout(transfer_timeout);
+        auto hdr = recv_header(static_cast<int>(pred.conn_), fds);
+        if (hdr.state_size > max_state_size) {
+            throw std::length_error{"handoff state too large"};
+        }
+
+        std::string serialized(hdr.state_size, '\0');
+        if (pred.conn_.recv(serialized.data(), serialized.size()) !=
+            serialized.size()) {
+            throw std::runtime_error{"handoff state was truncated"};
+        }
+
+        msgpack::object_handle const oh =
+            msgpack::unpack(serialized.data(), serialized.size());
+        oh.get().convert(pred.state_);
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Failed to take over from running helper: {}", e.what());
+        for (int const fd : fds) {
+            ::close(fd);
+        }
+        return std::nullopt;
+    }
+
+    pred.listen_fd_ = fds[0];
+    if (fds.size() > 1) {
+        pred.lock_fd_ = fds[1];
+    }
+
+    SPDLOG_INFO("Took over listening socket from running helper with {} "
+                "services to warm up",
+        pred.state_.services.size());
+
+    return pred;
+}
+
+void predecessor::ready()
+{
+    try {
+        conn_.send(&ready_byte, 1);
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Failed to notify previous helper: {}", e.what());
+    }
+    conn_ = network::local::socket{-1};
+}
+
+} // namespace dds::handoff
@@ -0,0 +1,95 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include "engine_settings.hpp"
+#include "network/socket.hpp"
+#include "remote_config/settings.hpp"
+#include <chrono>
+#include <msgpack.hpp>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// A running helper listens on the handoff socket. A newer helper connects to
+// it, receives the listening socket (and the lock file descriptor) through
+// SCM_RIGHTS together with the settings of the services that were alive, and
+// builds those services before telling its predecessor that it is ready. The
+// predecessor then stops accepting and lets its clients finish their current
+// request.
+namespace dds::handoff {
+
+struct warm_service {
+    engine_settings engine;
+    remote_config::settings rc;
+    bool dynamic_enablement{};
+
+    MSGPACK_DEFINE_MAP(engine, rc, dynamic_enablement);
+};
+
+struct state {
+    std::vector<warm_service> services;
+
+    MSGPACK_DEFINE_MAP(services);
+};
+
+// Old helper side
+class listener {
+public:
+    explicit listener(std::string_view path);
+    listener(const listener &) = delete;
+    listener &operator=(const listener &) = delete;
+    listener(listener &&) = delete;
+    listener &operator=(listener &&) = delete;
+    ~listener();
+
+    // Returns the connection of a successor, or nullopt if none showed up
+    // within the given timeout
+    std::optional<network::local::socket> wait_for_successor(
+        std::chrono::milliseconds timeout);
+
+private:
+    int sock_{-1};
+    std::string path_;
+};
+
+// Sends the listening socket, the lock file (-1 if we don't own it) and the
+// warm state, then waits for the successor to be ready. Returns false if the
+// successor went away before confirming, in which case we keep running.
+bool hand_over(network::local::socket &conn, int listen_fd, int lock_fd,
+    const state &st, std::chrono::milliseconds ready_timeout);
+
+// New helper side
+class predecessor {
+public:
+    predecessor(const predecessor &) = delete;
+    predecessor &operator=(const predecessor &) = delete;
+    predecessor(predecessor &&) = default;
+    predecessor &operator=(predecessor &&) = default;
+    ~predecessor() = default;
+
+    // Returns nullopt if there is no running helper to take over from
+    static std::optional<predecessor> connect(std::string_view path);
+
+    [[nodiscard]] int listen_fd() const { return listen_fd_; }
+    [[nodiscard]] int lock_fd() const { return lock_fd_; }
+    [[nodiscard]] const state &warm_state() const { return state_; }
+
+    // Tells the old helper to stop accepting connections
+    void ready();
+
+private:
+    explicit predecessor(network::local::socket &&conn)
+        : conn_{std::move(conn)}
+    {}
+
+    network::local::socket conn_;
+    int listen_fd_{-1};
+    int lock_fd_{-1};
+    state state_;
+};
+
+} // namespace dds::handoff
@@ -9,11 +9,15 @@
 #include "parameter_view.hpp"
 #include "std_logging.hpp"
 #include <base64.h>
+#include <cstring>
 #include <ddwaf.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/prettywriter.h>
+#include <rapidjson/reader.h>
 #include <string_view>
 #include <type_traits>
+#include <vector>
 
 using namespace std::literals;
 
@@ -136,6 +140,8 @@ void json_to_object(ddwaf_object *object, T &doc)
             ddwaf_object_string_from_signed(object, doc.GetInt64());
         } else if (doc.IsUint64()) {
             ddwaf_object_string_from_unsigned(object, doc.GetUint64());
+        } else {
+            ddwaf_object_invalid(object);
         }
         break;
     }
@@ -153,15 +159,202 @@ dds::parameter json_to_parameter(const rapidjson::Document &doc)
     return obj;
 }
 
+namespace {
+
+// Builds the ddwaf_object tree straight from the SAX events, producing the
+// same structure as json_to_object() without materialising a DOM first.
+// The children of each open container are accumulated in a growable buffer
+// (which is reused by later containers at the same depth) and copied into an
+// exactly sized array once the container is closed.
+class parameter_builder
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, parameter_builder> {
+public:
+    static constexpr std::size_t max_depth = 256;
+
+    parameter_builder() = default;
+    parameter_builder(const parameter_builder &) = delete;
+    parameter_builder &operator=(const parameter_builder &) = delete;
+    parameter_builder(parameter_builder &&) = delete;
+    parameter_builder &operator=(parameter_builder &&) = delete;
+
+    ~parameter_builder()
+    {
+        // Only reached with open containers if parsing failed
+        while (depth_ > 0) {
+            ddwaf_object obj = close(false);
+            ddwaf_object_free(&obj);
+        }
+        ddwaf_object_free(&result_);
+    }
+
+    bool Null()
+    {
+        ddwaf_object obj;
+        ddwaf_object_invalid(&obj);
+        return add(obj);
+    }
+
+    bool Bool(bool b)
+    {
+        ddwaf_object obj;
+        if (b) {
+            ddwaf_object_stringl(&obj, "true", sizeof("true") - 1);
+        } else {
+            ddwaf_object_stringl(&obj, "false", sizeof("false") - 1);
+        }
+        return add(obj);
+    }
+
+    bool Int(int i) { return Int64(i); }
+    bool Uint(unsigned u) { return Uint64(u); }
+
+    bool Int64(int64_t i)
+    {
+        ddwaf_object obj;
+        ddwaf_object_string_from_signed(&obj, i);
+        return add(obj);
+    }
+
+    bool Uint64(uint64_t u)
+    {
+        ddwaf_object obj;
+        ddwaf_object_string_from_unsigned(&obj, u);
+        return add(obj);
+    }
+
+    bool Double(double /*d*/) { return Null(); }
+
+    bool String(const char *str, rapidjson::SizeType length, bool /*copy*/)
+    {
+        ddwaf_object obj;
+        ddwaf_object_stringl(&obj, str, length);
+        return add(obj);
+    }
+
+    bool Key(const char *str, rapidjson::SizeType length, bool /*copy*/)
+    {
+        // json_to_object() reads keys as C strings. The reader's buffer is
+        // only valid during the callback, so the key is copied
+        key_.assign(str, strnlen(str, length));
+        has_key_ = true;
+        return true;
+    }
+
+    bool StartObject() { return open(); }
+    bool EndObject(rapidjson::SizeType /*count*/) { return add(close(true)); }
+
+    bool StartArray() { return open(); }
+    bool EndArray(rapidjson::SizeType /*count*/) { return add(close(false)); }
+
+    dds::parameter release()
+    {
+        dds::parameter param{result_};
+        ddwaf_object_invalid(&result_);
+        return param;
+    }
+
+private:
+    struct frame {
+        std::vector<ddwaf_object> children;
+        // the key of the container itself in its parent map
+        std::string key;
+        bool has_key{false};
+    };
+
+    bool open()
+    {
+        if (depth_ == max_depth) {
+            return false;
+        }
+        if (depth_ == stack_.size()) {
+            stack_.emplace_back();
+        }
+        auto &f = stack_[depth_++];
+        f.children.clear();
+        f.key.swap(key_);
+        f.has_key = has_key_;
+        has_key_ = false;
+        return true;
+    }
+
+    ddwaf_object close(bool is_map)
+    {
+        auto &f = stack_[--depth_];
+        ddwaf_object obj;
+        if (is_map) {
+            ddwaf_object_map(&obj);
+        } else {
+            ddwaf_object_array(&obj);
+        }
+
+        if (!f.children.empty()) {
+            // freed by ddwaf_object_free(), like the arrays libddwaf allocates
+            // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+            auto *array = static_cast<ddwaf_object *>(
+                malloc(f.children.size() * sizeof(ddwaf_object)));
+            if (array == nullptr) {
+                for (auto &child : f.children) {
+                    ddwaf_object_free(&child);
+                }
+                f.children.clear();
+                throw std::bad_alloc();
+            }
+            memcpy(array, f.children.data(),
+                f.children.size() * sizeof(ddwaf_object));
+            obj.array = array;
+            obj.nbEntries = f.children.size();
+            f.children.clear();
+        }
+
+        key_.swap(f.key);
+        has_key_ = f.has_key;
+        return obj;
+    }
+
+    bool add(ddwaf_object obj)
+    {
+        if (depth_ == 0) {
+            result_ = obj;
+            return true;
+        }
+
+        if (has_key_) {
+            // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+            auto *name = static_cast<char *>(malloc(key_.size() + 1));
+            if (name == nullptr) {
+                ddwaf_object_free(&obj);
+                throw std::bad_alloc();
+            }
+            memcpy(name, key_.c_str(), key_.size() + 1);
+            obj.parameterName = name;
+            obj.parameterNameLength = key_.size();
+            has_key_ = false;
+        }
+        stack_[depth_ - 1].children.push_back(obj);
+        return true;
+    }
+
+    std::vector<frame> stack_;
+    std::size_t depth_{0};
+    std::string key_;
+    bool has_key_{false};
+    ddwaf_object result_{};
+};
+
+} // namespace
+
 dds::parameter json_to_parameter(std::string_view json)
 {
-    rapidjson::Document doc;
-    rapidjson::ParseResult const result = doc.Parse(json.data());
+    parameter_builder builder;
+    rapidjson::Reader reader;
+    rapidjson::MemoryStream ms{json.data(), json.size()};
+    rapidjson::ParseResult const result =
+        reader.Parse<rapidjson::kParseIterativeFlag>(ms, builder);
     if (result.IsError()) {
         throw parsing_error("invalid json object: "s +
                             rapidjson::GetParseError_En(result.Code()));
     }
-    return json_to_parameter(doc);
+    return builder.release();
 }
 
 std::optional<rapidjson::Value::ConstMemberIterator>
@@ -8,9 +8,11 @@
 #endif
 
 #include "config.hpp"
+#include "handoff.hpp"
 #include "runner.hpp"
 #include <csignal>
 #include <cstdlib>
+#include <optional>
 #include <spdlog/common.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_sinks.h>
@@ -32,7 +34,8 @@ std::atomic<bool> interrupted; // NOLINT
 std::atomic<bool> finished;    // NOLINT
 pthread_t thread_id;
 
-bool ensure_unique(const std::string &lock_path)
+// lock_fd is left at -1 if the lock was inherited
+bool ensure_unique(const std::string &lock_path, int &lock_fd)
 {
     // do not acquire the lock / assume we inherited it
     if (lock_path == "-") {
@@ -56,6 +59,7 @@ bool ensure_unique(const std::string &lock_path)
             lock_path, errno);
         return false;
     }
+    lock_fd = fd;
     return true;
 }
 
@@ -95,7 +99,22 @@ int appsec_helper_main_impl()
 
     dds::waf::initialise_logging(level);
 
-    if (!ensure_unique(std::string{config.lock_file_path()})) {
+    // If there's a helper running with handoff enabled, take over its socket
+    // and lock instead of waiting for it to go away
+    std::optional<dds::handoff::predecessor> predecessor;
+    if (!config.handoff_socket_path().empty()) {
+        try {
+            predecessor = dds::handoff::predecessor::connect(
+                config.handoff_socket_path());
+        } catch (const std::exception &e) {
+            SPDLOG_WARN("Failed to connect to handoff socket: {}", e.what());
+        }
+    }
+
+    int lock_fd = -1;
+    if (predecessor) {
+        lock_fd = predecessor->lock_fd();
+    } else if (!ensure_unique(std::string{config.lock_file_path()}, lock_fd)) {
         logger->warn("helper launched, but not unique, exiting");
         // There's another helper running
         return 1;
@@ -113,7 +132,19 @@ int appsec_helper_main_impl()
     dds::remote_config::resolve_symbols();
     dds::runner::resolve_symbols();
 
-    auto runner = std::make_shared<dds::runner>(config, interrupted);
+    std::shared_ptr<dds::runner> runner;
+    if (predecessor) {
+        runner = std::make_shared<dds::runner>(config,
+            std::make_unique<dds::network::local::acceptor>(
+                predecessor->listen_fd()),
+            interrupted);
+        runner->warm_up(predecessor->warm_state());
+        predecessor->ready();
+    } else {
+        runner = std::make_shared<dds::runner>(config, interrupted);
+    }
+    runner->set_lock_fd(lock_fd);
+
     SPDLOG_INFO("starting runner on new thread");
     std::thread thr{[runner = std::move(runner)]() {
 #ifdef __linux__
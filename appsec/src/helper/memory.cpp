@@ -0,0 +1,23 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "memory.hpp"
+
+#ifdef __GLIBC__
+#    include <malloc.h>
+#endif
+
+namespace dds::memory {
+
+bool trim()
+{
+#ifdef __GLIBC__
+    return malloc_trim(0) == 1;
+#else
+    return false;
+#endif
+}
+
+} // namespace dds::memory
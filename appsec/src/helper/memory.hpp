@@ -0,0 +1,13 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+namespace dds::memory {
+
+// Gives the memory freed by this process back to the OS, where supported
+bool trim();
+
+} // namespace dds::memory
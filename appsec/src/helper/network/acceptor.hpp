@@ -24,6 +24,9 @@ public:
 
     virtual void set_accept_timeout(std::chrono::seconds timeout) = 0;
     [[nodiscard]] virtual base_socket::ptr accept() = 0;
+
+    // The listening socket, for handing it off to another helper (-1 if n/a)
+    [[nodiscard]] virtual int native_handle() const { return -1; }
 };
 
 namespace local {
@@ -56,6 +59,7 @@ public:
 
     void set_accept_timeout(std::chrono::seconds timeout) override;
     [[nodiscard]] base_socket::ptr accept() override;
+    [[nodiscard]] int native_handle() const override { return sock_; }
 
 private:
     int sock_{-1};
@@ -169,8 +169,10 @@ struct request_init {
         std::vector<std::string> triggers;
 
         bool force_keep;
+        // Lets the extension defer push_address calls when false
+        bool may_block{true};
 
-        MSGPACK_DEFINE(actions, triggers, force_keep);
+        MSGPACK_DEFINE(actions, triggers, force_keep, may_block);
     };
 };
 
@@ -28,10 +28,13 @@ void dds::remote_config::asm_dd_aggregator::remove(const config & /*config*/)
         return;
     }
 
-    auto ruleset = engine_ruleset::from_path(fallback_rules_file_);
+    // The fallback file is shared by all the services, don't parse it again
+    // for each of them. The copy is still needed because aggregate() moves
+    // the members out of ruleset_.
+    auto ruleset = engine_ruleset::cached_from_path(fallback_rules_file_);
 
     rapidjson::Document doc(&ruleset_.GetAllocator());
-    doc.CopyFrom(ruleset.get_document(), doc.GetAllocator());
+    doc.CopyFrom(ruleset->get_document(), doc.GetAllocator());
 
     ruleset_ = std::move(doc);
 }
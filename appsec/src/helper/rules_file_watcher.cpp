@@ -0,0 +1,228 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "rules_file_watcher.hpp"
+#include "engine_ruleset.hpp"
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef __linux__
+#    include <sys/inotify.h>
+#endif
+
+namespace dds::rules_file_watcher {
+
+namespace {
+constexpr int poll_timeout_ms = 1000;
+
+struct watched_dir {
+    int wd{-1};
+    // file name -> engines loaded from it
+    std::unordered_map<std::string, std::vector<std::weak_ptr<engine>>> files;
+};
+
+std::mutex mtx;                                      // NOLINT
+int inotify_fd{-1};                                  // NOLINT
+std::thread watcher_thread;                          // NOLINT
+std::atomic<bool> running{false};                    // NOLINT
+std::unordered_map<std::string, watched_dir> dirs;   // NOLINT
+std::unordered_map<int, std::string> wd_to_dir;      // NOLINT
+
+std::vector<std::shared_ptr<engine>> live_engines(
+    std::vector<std::weak_ptr<engine>> &engines)
+{
+    std::vector<std::shared_ptr<engine>> res;
+    for (auto it = engines.begin(); it != engines.end();) {
+        if (auto eng = it->lock()) {
+            res.emplace_back(std::move(eng));
+            ++it;
+        } else {
+            it = engines.erase(it);
+        }
+    }
+    return res;
+}
+
+void reload(
+    const std::string &path, const std::vector<std::shared_ptr<engine>> &engines)
+{
+    std::shared_ptr<const engine_ruleset> ruleset;
+    try {
+        ruleset = engine_ruleset::cached_from_path(path);
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Rules file {} changed but could not be loaded, keeping "
+                    "the current rules: {}",
+            path, e.what());
+        return;
+    }
+
+    SPDLOG_INFO(
+        "Rules file {} changed, updating {} engines", path, engines.size());
+    for (const auto &eng : engines) {
+        // There's no request to attach the diagnostics to
+        std::map<std::string, std::string> meta;
+        std::map<std::string_view, double> metrics;
+        // Keeps the previous rules if the WAF rejects the new ones. Serialized
+        // with remote config updates of the same engine by engine::update.
+        eng->update(*ruleset, meta, metrics);
+    }
+}
+
+#ifdef __linux__
+void process_events()
+{
+    alignas(struct inotify_event) std::array<char, 4096> buf{};
+    std::unordered_set<std::string> changed;
+
+    while (true) {
+        auto len = ::read(inotify_fd, buf.data(), buf.size());
+        if (len <= 0) {
+            break; // EAGAIN: no more events
+        }
+
+        for (std::size_t off = 0; off < static_cast<std::size_t>(len);) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            auto *ev = reinterpret_cast<struct inotify_event *>(&buf[off]);
+            off += sizeof(struct inotify_event) + ev->len;
+            if (ev->len == 0) {
+                continue;
+            }
+
+            const std::lock_guard lock{mtx};
+            auto wd_it = wd_to_dir.find(ev->wd);
+            if (wd_it == wd_to_dir.end()) {
+                continue;
+            }
+            auto &dir = dirs[wd_it->second];
+            std::string const name{static_cast<char *>(ev->name)};
+            if (dir.files.find(name) != dir.files.end()) {
+                changed.emplace(wd_it->second + "/" + name);
+            }
+        }
+    }
+
+    for (const auto &path : changed) {
+        std::vector<std::shared_ptr<engine>> engines;
+        {
+            const std::lock_guard lock{mtx};
+            std::filesystem::path const p{path};
+            auto &dir = dirs[p.parent_path().string()];
+            engines = live_engines(dir.files[p.filename().string()]);
+        }
+        if (!engines.empty()) {
+            reload(path, engines);
+        }
+    }
+}
+
+void run()
+{
+    pthread_setname_np(pthread_self(), "appsec_helper rules");
+    while (running.load(std::memory_order_acquire)) {
+        struct pollfd pfd {
+            .fd = inotify_fd, .events = POLLIN, .revents = 0
+        };
+        if (::poll(&pfd, 1, poll_timeout_ms) <= 0) {
+            continue; // timeout or EINTR
+        }
+        try {
+            process_events();
+        } catch (const std::exception &e) {
+            SPDLOG_WARN("Failed to reload rules file: {}", e.what());
+        }
+    }
+}
+#endif
+} // namespace
+
+void start()
+{
+#ifdef __linux__
+    const std::lock_guard lock{mtx};
+    if (running.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1) {
+        SPDLOG_WARN("Failed to initialize inotify, rules files won't be "
+                    "reloaded: errno {}",
+            errno);
+        return;
+    }
+
+    running.store(true, std::memory_order_release);
+    watcher_thread = std::thread{run};
+    SPDLOG_INFO("Watching local rules files for changes");
+#endif
+}
+
+void stop()
+{
+    if (!running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    if (watcher_thread.joinable()) {
+        watcher_thread.join();
+    }
+
+    const std::lock_guard lock{mtx};
+    ::close(inotify_fd);
+    inotify_fd = -1;
+    dirs.clear();
+    wd_to_dir.clear();
+}
+
+void watch(const std::string &path, const std::shared_ptr<engine> &engine)
+{
+#ifdef __linux__
+    if (!running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::error_code ec;
+    auto abs_path = std::filesystem::absolute(path, ec);
+    if (ec) {
+        SPDLOG_WARN("Not watching rules file {}: {}", path, ec.message());
+        return;
+    }
+
+    auto dir_path = abs_path.parent_path().string();
+    auto file_name = abs_path.filename().string();
+
+    const std::lock_guard lock{mtx};
+    auto &dir = dirs[dir_path];
+    if (dir.wd == -1) {
+        dir.wd = ::inotify_add_watch(inotify_fd, dir_path.c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (dir.wd == -1) {
+            SPDLOG_WARN("Failed to watch {} for changes: errno {}", dir_path,
+                errno);
+            dirs.erase(dir_path);
+            return;
+        }
+        wd_to_dir[dir.wd] = dir_path;
+    }
+
+    auto &engines = dir.files[file_name];
+    live_engines(engines); // drop the engines that are gone
+    engines.emplace_back(engine);
+    SPDLOG_DEBUG("Watching rules file {} for changes", abs_path.string());
+#endif
+}
+
+} // namespace dds::rules_file_watcher
@@ -0,0 +1,28 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include "engine.hpp"
+#include <memory>
+#include <string>
+
+// Reloads locally configured rules files (DD_APPSEC_RULES) when they change,
+// without having to restart the helper. The directories containing the files
+// are watched rather than the files themselves, so that files replaced
+// through a rename are picked up too. A new version of a file is parsed once
+// and then pushed to every engine using it through engine::update; if it
+// can't be parsed or the WAF rejects it, the engines keep their current rules.
+namespace dds::rules_file_watcher {
+
+// Starts the watcher thread. Without it, watch() does nothing.
+void start();
+
+void stop();
+
+// The watcher only holds a weak reference to the engine
+void watch(const std::string &path, const std::shared_ptr<engine> &engine);
+
+} // namespace dds::rules_file_watcher
@@ -6,12 +6,16 @@
 #include "runner.hpp"
 
 #include "client.hpp"
+#include "enablement_state.hpp"
+#include "rules_file_watcher.hpp"
 #include "subscriber/waf.hpp"
 #include <csignal>
 #include <cstdio>
 #include <spdlog/spdlog.h>
+#include <optional>
 #include <stdexcept>
 #include <sys/stat.h>
+#include <thread>
 
 extern "C" {
 #include <dlfcn.h>
@@ -72,6 +76,9 @@ void unblock_sigusr1()
     }
 }
 
+constexpr std::chrono::milliseconds handoff_poll_interval{200};
+constexpr std::chrono::seconds handoff_ready_timeout{30};
+
 void handle_sigusr1()
 {
     // the signal handler need not do anything (just interrupt accept())
@@ -91,7 +98,8 @@ runner::runner(const config::config &cfg, std::atomic<bool> &interrupted)
 runner::runner(const config::config &cfg,
     network::base_acceptor::ptr &&acceptor, std::atomic<bool> &interrupted)
     : cfg_(cfg), service_manager_{std::make_shared<service_manager>()},
-      acceptor_(std::move(acceptor)), interrupted_{interrupted}
+      worker_pool_{cfg.idle_trim_interval()}, acceptor_(std::move(acceptor)),
+      interrupted_{interrupted}
 {
     try {
         acceptor_->set_accept_timeout(1min);
@@ -99,6 +107,11 @@ runner::runner(const config::config &cfg,
         // Not a critical error, we should continue
         SPDLOG_WARN("Failed to set runner timeout: {}", e.what());
     }
+
+    // Before warm_up() so that the services taken over are watched too
+    if (cfg.watch_rules_file()) {
+        rules_file_watcher::start();
+    }
 }
 
 // NOLINTNEXTLINE
@@ -155,11 +168,23 @@ void runner::unregister_for_rc_notifications()
 
 void runner::run()
 {
+    std::thread handoff_thread;
     try {
         SPDLOG_INFO("Runner running");
         handle_sigusr1();
 
+        if (!cfg_.handoff_socket_path().empty()) {
+            handoff_thread = std::thread{
+                [this, runner_thread = pthread_self()]() {
+                    serve_handoff(runner_thread);
+                }};
+        }
+
         while (!interrupted()) {
+            if (!wait_while_accept_paused()) {
+                break;
+            }
+
             unblock_sigusr1();
             network::base_socket::ptr socket = acceptor_->accept();
             block_sigusr1();
@@ -168,10 +193,8 @@ void runner::run()
                 continue; // interrupted / timeout
             }
 
-            if (interrupted()) {
-                break;
-            }
-
+            // Even if we've been interrupted in the meantime, the client was
+            // accepted by us and nobody else will serve it
             const std::shared_ptr<client> c =
                 std::make_shared<client>(service_manager_, std::move(socket));
 
@@ -184,9 +207,103 @@ void runner::run()
         SPDLOG_ERROR("exception: {}", e.what());
     }
 
+    if (handoff_thread.joinable()) {
+        // serve_handoff() only returns once we're interrupted, which is not
+        // the case if we left the loop through an exception
+        interrupted_.store(true, std::memory_order_release);
+        accept_pause_.cv.notify_all();
+        handoff_thread.join();
+    }
+
+    // Clients stop once they're done with their current request
     SPDLOG_INFO("Runner exiting, stopping pool");
     worker_pool_.stop();
     SPDLOG_INFO("Pool stopped");
+
+    rules_file_watcher::stop();
+}
+
+void runner::serve_handoff(pthread_t runner_thread)
+{
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), "appsec_helper handoff");
+#endif
+    std::optional<handoff::listener> listener;
+    try {
+        listener.emplace(cfg_.handoff_socket_path());
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Failed to listen for handoff requests: {}", e.what());
+        return;
+    }
+
+    while (!interrupted()) {
+        auto conn = listener->wait_for_successor(handoff_poll_interval);
+        if (!conn) {
+            continue;
+        }
+
+        SPDLOG_INFO("A new helper requested a handoff");
+        if (!pause_accepting(runner_thread)) {
+            break; // the runner is exiting
+        }
+
+        if (!handoff::hand_over(*conn, acceptor_->native_handle(), lock_fd_,
+                service_manager_->warm_state(), handoff_ready_timeout)) {
+            resume_accepting();
+            continue;
+        }
+
+        // The successor is accepting on the same socket, we must not anymore
+        SPDLOG_INFO("Handoff complete, draining clients");
+        enablement_state::detach();
+        interrupted_.store(true, std::memory_order_release);
+        resume_accepting();
+        break;
+    }
+}
+
+bool runner::wait_while_accept_paused()
+{
+    std::unique_lock<std::mutex> lock{accept_pause_.mtx};
+    if (!accept_pause_.requested) {
+        return true;
+    }
+
+    accept_pause_.paused = true;
+    accept_pause_.cv.notify_all();
+    while (accept_pause_.requested && !interrupted()) {
+        accept_pause_.cv.wait_for(lock, handoff_poll_interval);
+    }
+    accept_pause_.paused = false;
+
+    return !interrupted();
+}
+
+bool runner::pause_accepting(pthread_t runner_thread)
+{
+    std::unique_lock<std::mutex> lock{accept_pause_.mtx};
+    accept_pause_.requested = true;
+    while (!accept_pause_.paused) {
+        if (interrupted()) {
+            accept_pause_.requested = false;
+            return false;
+        }
+
+        // The signal is lost if the runner is not blocked in accept(), so
+        // repeat it until it has acknowledged the pause
+        pthread_kill(runner_thread, SIGUSR1);
+        accept_pause_.cv.wait_for(lock, handoff_poll_interval);
+    }
+    return true;
+}
+
+void runner::resume_accepting()
+{
+    {
+        const std::lock_guard<std::mutex> lock{accept_pause_.mtx};
+        accept_pause_.requested = false;
+    }
+    accept_pause_.cv.notify_all();
 }
 
 void runner::resolve_symbols()
@@ -7,9 +7,13 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
+#include <pthread.h>
 
 #include "config.hpp"
+#include "handoff.hpp"
 #include "network/acceptor.hpp"
 #include "network/socket.hpp"
 #include "service_manager.hpp"
@@ -36,12 +40,24 @@ public:
 
     void unregister_for_rc_notifications();
 
+    // Builds the services a predecessor had before we start accepting
+    void warm_up(const handoff::state &st) { service_manager_->warm_up(st); }
+
+    // The lock file descriptor is handed off along with the listening socket
+    void set_lock_fd(int fd) { lock_fd_ = fd; }
+
     [[nodiscard]] bool interrupted() const
     {
         return interrupted_.load(std::memory_order_acquire);
     }
 
 private:
+    void serve_handoff(pthread_t runner_thread);
+
+    bool wait_while_accept_paused();
+    bool pause_accepting(pthread_t runner_thread);
+    void resume_accepting();
+
     static std::shared_ptr<runner> RUNNER_FOR_NOTIFICATIONS;
 
     const config::config &cfg_; // NOLINT
@@ -51,6 +67,17 @@ private:
     // Server variables
     network::base_acceptor::ptr acceptor_;
     std::atomic<bool> &interrupted_; // NOLINT
+    int lock_fd_{-1};
+
+    // The runner thread stops accepting before the listening socket is
+    // handed off, so every connection is either served by us or still queued
+    // for the successor
+    struct {
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool requested{false};
+        bool paused{false};
+    } accept_pause_;
 };
 
 } // namespace dds
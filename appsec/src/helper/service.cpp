@@ -5,6 +5,7 @@
 // (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
 
 #include "service.hpp"
+#include "rules_file_watcher.hpp"
 
 namespace dds {
 
@@ -32,6 +33,9 @@ service::service(std::shared_ptr<engine> engine,
     if (client_handler_) {
         client_handler_->poll();
     }
+
+    // Last, as the destructor releases it
+    enablement_state::acquire(rc_path_);
 }
 
 std::shared_ptr<service> service::from_settings(
@@ -43,6 +47,10 @@ std::shared_ptr<service> service::from_settings(
     const std::shared_ptr<engine> engine_ptr =
         engine::from_settings(eng_settings, meta, metrics);
 
+    if (!eng_settings.rules_file.empty()) {
+        rules_file_watcher::watch(eng_settings.rules_file, engine_ptr);
+    }
+
     auto service_config = std::make_shared<dds::service_config>();
 
     auto client_handler =
@@ -5,6 +5,7 @@
 // (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
 #pragma once
 
+#include "enablement_state.hpp"
 #include "engine.hpp"
 #include "exception.hpp"
 #include "remote_config/client_handler.hpp"
@@ -34,7 +35,7 @@ public:
     service(service &&) = delete;
     service &operator=(service &&) = delete;
 
-    virtual ~service() = default;
+    virtual ~service() { enablement_state::release(rc_path_); }
 
     static std::shared_ptr<service> from_settings(
         const dds::engine_settings &eng_settings,
@@ -64,7 +65,16 @@ public:
         return rc_path_ == path;
     }
 
-    void notify_of_rc_updates() { client_handler_->poll(); }
+    [[nodiscard]] std::string_view get_rc_path() const { return rc_path_; }
+
+    void notify_of_rc_updates()
+    {
+        client_handler_->poll();
+        // Remote enablement may have changed, let idle extensions know
+        enablement_state::publish(rc_path_,
+            service_config_->get_asm_enabled_status() ==
+                enable_asm_status::ENABLED);
+    }
 
 protected:
     std::shared_ptr<engine> engine_{};
@@ -17,7 +17,7 @@ std::shared_ptr<service> service_manager::create_service(
     const std::lock_guard guard{mutex_};
     auto hit = cache_.find(key);
     if (hit != cache_.end()) {
-        auto service_ptr = hit->second.lock();
+        auto service_ptr = hit->second.service_ptr.lock();
         if (service_ptr) { // not expired
             SPDLOG_DEBUG(
                 "Found an existing service for settings={} rc_settings={}",
@@ -31,7 +31,7 @@ std::shared_ptr<service> service_manager::create_service(
 
     auto service_ptr = service::from_settings(
         settings, rc_settings, meta, metrics, dynamic_enablement);
-    cache_.emplace(key, std::move(service_ptr));
+    cache_.emplace(key, cache_entry{service_ptr, dynamic_enablement});
 
     last_service_ = service_ptr;
 
@@ -45,9 +45,10 @@ void service_manager::notify_of_rc_updates(std::string_view shmem_path)
     std::vector<std::shared_ptr<service>> services_to_notify;
     {
         const std::lock_guard guard{mutex_};
-        for (auto &[key, service_ptr] : cache_) {
+        for (auto &[key, entry] : cache_) {
             if (key.get_shmem_path() == shmem_path) {
-                if (std::shared_ptr<service> service = service_ptr.lock()) {
+                if (std::shared_ptr<service> service =
+                        entry.service_ptr.lock()) {
                     services_to_notify.emplace_back(std::move(service));
                 }
             }
@@ -61,10 +62,56 @@ void service_manager::notify_of_rc_updates(std::string_view shmem_path)
     }
 }
 
+handoff::state service_manager::warm_state()
+{
+    handoff::state st;
+    const std::lock_guard guard{mutex_};
+    for (auto &[key, entry] : cache_) {
+        if (entry.service_ptr.expired()) {
+            continue;
+        }
+        st.services.push_back({key.get_engine_settings(),
+            key.get_config_settings(), entry.dynamic_enablement});
+    }
+    return st;
+}
+
+void service_manager::warm_up(const handoff::state &st)
+{
+    {
+        const std::lock_guard guard{mutex_};
+        warm_services_expiry_ =
+            std::chrono::steady_clock::now() + warm_service_ttl;
+    }
+
+    for (const auto &ws : st.services) {
+        std::map<std::string, std::string> meta;
+        std::map<std::string_view, double> metrics;
+        try {
+            auto service_ptr = create_service(
+                ws.engine, ws.rc, meta, metrics, ws.dynamic_enablement);
+
+            const std::lock_guard guard{mutex_};
+            warm_services_.emplace_back(std::move(service_ptr));
+        } catch (const std::exception &e) {
+            SPDLOG_WARN("Failed to warm up service for settings={}: {}",
+                ws.engine, e.what());
+        }
+    }
+
+    SPDLOG_INFO("Warmed up {} services", st.services.size());
+}
+
 void service_manager::cleanup_cache()
 {
+    if (!warm_services_.empty() &&
+        std::chrono::steady_clock::now() >= warm_services_expiry_) {
+        // the services still in use are owned by their clients
+        warm_services_.clear();
+    }
+
     for (auto it = cache_.begin(); it != cache_.end();) {
-        if (it->second.expired()) {
+        if (it->second.service_ptr.expired()) {
             it = cache_.erase(it);
         } else {
             it++;
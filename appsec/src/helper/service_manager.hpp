@@ -8,15 +8,18 @@
 #include "engine.hpp"
 #include "engine_settings.hpp"
 #include "exception.hpp"
+#include "handoff.hpp"
 #include "network/proto.hpp"
 #include "service.hpp"
 #include "std_logging.hpp"
 #include "subscriber/waf.hpp"
 #include "utils.hpp"
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <spdlog/spdlog.h>
 #include <unordered_map>
+#include <vector>
 
 namespace dds {
 
@@ -37,6 +40,13 @@ public:
 
     void notify_of_rc_updates(std::string_view shmem_path);
 
+    // Settings of the services currently alive, to be handed to a successor
+    [[nodiscard]] handoff::state warm_state();
+
+    // Creates the services of a predecessor ahead of their clients. They are
+    // kept alive for warm_service_ttl, giving the clients time to reconnect.
+    void warm_up(const handoff::state &st);
+
 protected:
     class cache_key {
     public:
@@ -65,20 +75,39 @@ protected:
             return config_settings_.shmem_path;
         }
 
+        [[nodiscard]] const engine_settings &get_engine_settings() const
+        {
+            return engine_settings_;
+        }
+
+        [[nodiscard]] const remote_config::settings &get_config_settings() const
+        {
+            return config_settings_;
+        }
+
     private:
         engine_settings engine_settings_;
         remote_config::settings config_settings_;
         std::size_t hash_;
     };
 
+    struct cache_entry {
+        std::weak_ptr<service> service_ptr;
+        bool dynamic_enablement;
+    };
+
     using cache_t =
-        std::unordered_map<cache_key, std::weak_ptr<service>, cache_key::hash>;
+        std::unordered_map<cache_key, cache_entry, cache_key::hash>;
+
+    static constexpr std::chrono::minutes warm_service_ttl{5};
 
     void cleanup_cache(); // mutex_ must be held when calling this
 
     std::mutex mutex_;
     cache_t cache_;
     std::shared_ptr<service> last_service_; // keep always one
+    std::vector<std::shared_ptr<service>> warm_services_;
+    std::chrono::steady_clock::time_point warm_services_expiry_;
 };
 
 } // namespace dds
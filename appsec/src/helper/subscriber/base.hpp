@@ -49,6 +49,10 @@ public:
     virtual std::unique_ptr<subscriber> update(parameter &rule,
         std::map<std::string, std::string> &meta,
         std::map<std::string_view, double> &metrics) = 0;
+
+    // Whether a listener may ever return a block or redirect action; the
+    // extension only defers addresses when no subscriber may
+    virtual bool may_block() { return true; }
 };
 
 } // namespace dds
@@ -307,17 +307,13 @@ instance::instance(parameter &rule, std::map<std::string, std::string> &meta,
         throw invalid_object();
     }
 
-    uint32_t size;
-    const auto *addrs = ddwaf_known_addresses(handle_, &size);
-
-    addresses_.clear();
-    for (uint32_t i = 0; i < size; i++) { addresses_.emplace(addrs[i]); }
+    load_known_addresses_and_actions();
 }
 
 instance::instance(instance &&other) noexcept
     : handle_(other.handle_), waf_timeout_(other.waf_timeout_),
       ruleset_version_(std::move(other.ruleset_version_)),
-      addresses_(std::move(other.addresses_))
+      addresses_(std::move(other.addresses_)), may_block_(other.may_block_)
 {
     other.handle_ = nullptr;
     other.waf_timeout_ = {};
@@ -333,6 +329,7 @@ instance &instance::operator=(instance &&other) noexcept
 
     ruleset_version_ = std::move(other.ruleset_version_);
     addresses_ = std::move(other.addresses_);
+    may_block_ = other.may_block_;
 
     return *this;
 }
@@ -354,12 +351,28 @@ instance::instance(
     ddwaf_handle handle, std::chrono::microseconds timeout, std::string version)
     : handle_(handle), waf_timeout_(timeout),
       ruleset_version_(std::move(version))
+{
+    load_known_addresses_and_actions();
+}
+
+void instance::load_known_addresses_and_actions()
 {
     uint32_t size;
     const auto *addrs = ddwaf_known_addresses(handle_, &size);
 
     addresses_.clear();
     for (uint32_t i = 0; i < size; i++) { addresses_.emplace(addrs[i]); }
+
+    const auto *actions = ddwaf_known_actions(handle_, &size);
+
+    may_block_ = false;
+    for (uint32_t i = 0; i < size; i++) {
+        auto type = parse_action_type_string(actions[i]);
+        if (type == action_type::block || type == action_type::redirect) {
+            may_block_ = true;
+            break;
+        }
+    }
 }
 
 std::unique_ptr<subscriber> instance::update(parameter &rule,
@@ -393,7 +406,15 @@ std::unique_ptr<instance> instance::from_settings(
     std::map<std::string_view, double> &metrics)
 {
     dds::parameter param = json_to_parameter(ruleset.get_document());
-    return std::make_unique<instance>(param, meta, metrics,
+    return from_settings(settings, param, meta, metrics);
+}
+
+std::unique_ptr<instance> instance::from_settings(
+    const engine_settings &settings, parameter &ruleset,
+    std::map<std::string, std::string> &meta,
+    std::map<std::string_view, double> &metrics)
+{
+    return std::make_unique<instance>(ruleset, meta, metrics,
         settings.waf_timeout_us, settings.obfuscator_key_regex,
         settings.obfuscator_value_regex);
 }
@@ -403,8 +424,10 @@ std::unique_ptr<instance> instance::from_string(std::string_view rule,
     std::map<std::string_view, double> &metrics, std::uint64_t waf_timeout_us,
     std::string_view key_regex, std::string_view value_regex)
 {
-    engine_ruleset const ruleset{rule};
-    dds::parameter param = json_to_parameter(ruleset.get_document());
+    dds::parameter param = json_to_parameter(rule);
+    if (param.type() != parameter_type::map) {
+        throw parsing_error("invalid json rule");
+    }
     return std::make_unique<instance>(
         param, meta, metrics, waf_timeout_us, key_regex, value_regex);
 }
@@ -70,6 +70,8 @@ public:
 
     std::unique_ptr<subscriber::listener> get_listener() override;
 
+    bool may_block() override { return may_block_; }
+
     std::unique_ptr<subscriber> update(parameter &rule,
         std::map<std::string, std::string> &meta,
         std::map<std::string_view, double> &metrics) override;
@@ -79,6 +81,11 @@ public:
         std::map<std::string, std::string> &meta,
         std::map<std::string_view, double> &metrics);
 
+    static std::unique_ptr<instance> from_settings(
+        const engine_settings &settings, parameter &ruleset,
+        std::map<std::string, std::string> &meta,
+        std::map<std::string_view, double> &metrics);
+
     // testing only
     static std::unique_ptr<instance> from_string(std::string_view rule,
         std::map<std::string, std::string> &meta,
@@ -95,6 +102,9 @@ protected:
     std::chrono::microseconds waf_timeout_;
     std::string ruleset_version_;
     std::unordered_set<std::string> addresses_;
+    bool may_block_{true};
+
+    void load_known_addresses_and_actions();
 };
 
 parameter parse_file(std::string_view filename);
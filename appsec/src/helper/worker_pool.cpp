@@ -5,6 +5,8 @@
 // (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
 
 #include "worker_pool.hpp"
+#include "memory.hpp"
+#include <spdlog/spdlog.h>
 
 using namespace std::chrono_literals;
 
@@ -48,6 +50,46 @@ void queue_producer::wait()
     }
 }
 
+pool::pool(std::chrono::seconds idle_trim_interval)
+{
+    if (idle_trim_interval.count() > 0) {
+        trimmer_ = std::thread(&pool::trim_handler, this, idle_trim_interval);
+    }
+}
+
+pool::~pool() { stop_trimmer(); }
+
+void pool::stop()
+{
+    q_.stop();
+    stop_trimmer();
+}
+
+// Workers serving a persistent connection never go back to the queue, so the
+// memory freed by their past requests is given back to the OS from here
+// rather than from the workers themselves. malloc_trim() covers every arena.
+void pool::trim_handler(std::chrono::seconds interval)
+{
+    std::unique_lock<std::mutex> lock(trim_mtx_);
+    while (!trim_cv_.wait_for(lock, interval, [this] { return trim_stop_; })) {
+        if (memory::trim()) {
+            SPDLOG_DEBUG("Released freed memory to the OS");
+        }
+    }
+}
+
+void pool::stop_trimmer()
+{
+    {
+        std::lock_guard<std::mutex> const lock(trim_mtx_);
+        trim_stop_ = true;
+    }
+    trim_cv_.notify_all();
+    if (trimmer_.joinable()) {
+        trimmer_.join();
+    }
+}
+
 bool pool::launch(runnable &&f)
 {
     if (!q_.running()) {
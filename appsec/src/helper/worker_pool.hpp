@@ -142,7 +142,10 @@ protected:
 class pool {
 public:
     pool() = default;
-    ~pool() = default;
+    // A non-zero interval starts a thread releasing freed memory to the OS
+    // that often
+    explicit pool(std::chrono::seconds idle_trim_interval);
+    ~pool();
     pool(const pool &) = delete;
     pool &operator=(const pool &) = delete;
     pool(pool &&) = delete;
@@ -151,12 +154,20 @@ public:
     bool launch(runnable &&f);
 
     void wait() { q_.wait(); }
-    void stop() { q_.stop(); }
+    void stop();
 
     [[nodiscard]] unsigned worker_count() const { return q_.ref_count(); }
 
 private:
+    void trim_handler(std::chrono::seconds interval);
+    void stop_trimmer();
+
     queue_producer q_;
+
+    std::mutex trim_mtx_;
+    std::condition_variable trim_cv_;
+    bool trim_stop_{false};
+    std::thread trimmer_;
 };
 
 } // namespace dds::worker
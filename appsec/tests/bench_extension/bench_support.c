@@ -0,0 +1,257 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#define HELPER_PROCESS_C_INCLUDES
+#include "bench_support.h"
+#include <php.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "src/extension/commands/request_exec.h"
+#include "src/extension/commands/request_init.h"
+#include "src/extension/commands/request_shutdown.h"
+#include "src/extension/deferred_addresses.h"
+#include "src/extension/network.h"
+#include "src/extension/tags.h"
+
+zend_module_entry *get_module(void);
+
+static zend_module_entry *_module;
+static dd_conn _conn = {.socket = -1};
+static mock_helper *_helper;
+
+static zend_array *_superglob_equiv;
+static zval _rasp_data;
+static zend_array *_resp_headers;
+
+static zend_mm_heap *_heap;
+static uint64_t _allocations;
+
+static zend_array *_build_superglob_equiv(const bench_request_shape *shape);
+static zend_array *_build_resp_headers(void);
+
+bool bench_minit(void)
+{
+    // RINIT must not look for a helper: the benchmarks bring their own
+    setenv("DD_APPSEC_ENABLED", "0", 1);
+
+    _module = get_module();
+    return zend_startup_module(_module) == SUCCESS;
+}
+
+bool bench_rinit(const bench_request_shape *shape)
+{
+    // The module was registered after startup, so the engine does not know
+    // about its request handlers
+    if (_module->request_startup_func(MODULE_PERSISTENT,
+            _module->module_number) != SUCCESS) {
+        return false;
+    }
+    dd_tags_rinit();
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == -1) {
+        return false;
+    }
+    _conn.socket = sv[0];
+    _helper = mock_helper_start(sv[1]);
+    if (!_helper) {
+        dd_conn_destroy(&_conn);
+        return false;
+    }
+
+    _superglob_equiv = _build_superglob_equiv(shape);
+
+    array_init(&_rasp_data);
+    add_assoc_string(
+        &_rasp_data, "server.io.fs.file", "/var/www/uploads/avatar_1234.png");
+
+    _resp_headers = _build_resp_headers();
+
+    return true;
+}
+
+void bench_rshutdown(void)
+{
+    mock_helper_stop(_helper);
+    _helper = NULL;
+    dd_conn_destroy(&_conn);
+    dd_conn_free_buffer(&_conn);
+
+    zend_array_destroy(_superglob_equiv);
+    _superglob_equiv = NULL;
+    zval_ptr_dtor(&_rasp_data);
+    zend_array_destroy(_resp_headers);
+    _resp_headers = NULL;
+
+    bench_reset_request_state();
+    dd_tags_rshutdown();
+
+    _module->request_shutdown_func(MODULE_PERSISTENT, _module->module_number);
+    _module->post_deactivate_func();
+}
+
+void bench_set_verdict(mock_verdict verdict)
+{
+    mock_helper_set_verdict(_helper, verdict);
+}
+
+int bench_request_init(void)
+{
+    struct req_info_init ctx = {.superglob_equiv = _superglob_equiv};
+    return dd_request_init(&_conn, &ctx);
+}
+
+int bench_request_exec(void)
+{
+    return dd_request_exec(&_conn, &_rasp_data);
+}
+
+int bench_request_shutdown(void)
+{
+    struct req_shutdown_info ctx = {
+        .status_code = 200, // NOLINT
+        .resp_headers_fmt = RESP_HEADERS_MAP_STRING_LIST,
+        .resp_headers_arr = _resp_headers,
+    };
+    return dd_request_shutdown(&_conn, &ctx);
+}
+
+void bench_reset_request_state(void)
+{
+    dd_tags_rshutdown();
+    dd_tags_rinit();
+    dd_deferred_addresses_rshutdown();
+}
+
+size_t bench_take_bytes_sent(void)
+{
+    return mock_helper_take_bytes_received(_helper);
+}
+
+#if !ZEND_DEBUG
+static void *_counting_malloc(size_t size)
+{
+    _allocations++;
+    return _zend_mm_alloc(_heap, size);
+}
+
+static void _counting_free(void *ptr) { _zend_mm_free(_heap, ptr); }
+
+static void *_counting_realloc(void *ptr, size_t size)
+{
+    _allocations++;
+    return _zend_mm_realloc(_heap, ptr, size);
+}
+#endif
+
+void bench_allocations_start(void)
+{
+    _allocations = 0;
+#if !ZEND_DEBUG
+    _heap = zend_mm_get_heap();
+    if (!zend_mm_is_custom_heap(_heap)) {
+        zend_mm_set_custom_handlers(
+            _heap, _counting_malloc, _counting_free, _counting_realloc);
+    } else {
+        _heap = NULL;
+    }
+#endif
+}
+
+uint64_t bench_allocations_stop(void)
+{
+    if (_heap) {
+        // the heap must not be left custom, or its shutdown is skipped
+        zend_mm_set_custom_handlers(_heap, NULL, NULL, NULL);
+        _heap = NULL;
+    }
+    return _allocations;
+}
+
+static void _fill_post(zval *arr, int depth, int width)
+{
+    array_init(arr);
+    for (int i = 0; i < width; i++) {
+        char key[32]; // NOLINT
+        snprintf(key, sizeof(key), "field_%d", i);
+        if (i == 0 && depth > 1) {
+            zval child;
+            _fill_post(&child, depth - 1, width);
+            add_assoc_zval(arr, key, &child);
+        } else {
+            add_assoc_string(arr, key, "some value submitted by the user");
+        }
+    }
+}
+
+static zend_array *_build_superglob_equiv(const bench_request_shape *shape)
+{
+    char key[64];  // NOLINT
+    char val[128]; // NOLINT
+
+    zval server;
+    array_init(&server);
+    add_assoc_string(&server, "REQUEST_METHOD", "POST");
+    add_assoc_string(&server, "REQUEST_URI", "/api/users/1234/profile?tab=1");
+    add_assoc_string(&server, "REMOTE_ADDR", "10.0.0.1");
+    add_assoc_string(
+        &server, "CONTENT_TYPE", "application/x-www-form-urlencoded");
+    add_assoc_string(&server, "HTTP_USER_AGENT", "Arachni/v1.5.1");
+    for (int i = 0; i < shape->headers; i++) {
+        snprintf(key, sizeof(key), "HTTP_X_BENCH_HEADER_%d", i);
+        snprintf(val, sizeof(val), "value %d; with=parameters; q=0.%d", i,
+            i % 10); // NOLINT
+        add_assoc_string(&server, key, val);
+    }
+
+    zval cookies;
+    array_init(&cookies);
+    for (int i = 0; i < shape->cookies; i++) {
+        snprintf(key, sizeof(key), "cookie_%d", i);
+        snprintf(val, sizeof(val), "cookie value number %d", i);
+        add_assoc_string(&cookies, key, val);
+    }
+
+    zval get;
+    array_init(&get);
+    add_assoc_string(&get, "tab", "1");
+
+    zval post;
+    if (shape->post_depth > 0) {
+        _fill_post(&post, shape->post_depth, shape->post_width);
+    } else {
+        array_init(&post);
+    }
+
+    zend_array *equiv = zend_new_array(4);
+    zend_hash_str_add_new(equiv, ZEND_STRL("_SERVER"), &server);
+    zend_hash_str_add_new(equiv, ZEND_STRL("_COOKIE"), &cookies);
+    zend_hash_str_add_new(equiv, ZEND_STRL("_GET"), &get);
+    zend_hash_str_add_new(equiv, ZEND_STRL("_POST"), &post);
+    return equiv;
+}
+
+static zend_array *_build_resp_headers(void)
+{
+    static const char *headers[][2] = {
+        {"content-type", "text/html; charset=UTF-8"},
+        {"cache-control", "no-cache, private"},
+        {"x-frame-options", "SAMEORIGIN"},
+        {"set-cookie", "session=abcdef0123456789; path=/; HttpOnly"},
+    };
+
+    zend_array *arr = zend_new_array(ARRAY_SIZE(headers));
+    for (size_t i = 0; i < ARRAY_SIZE(headers); i++) {
+        zval list;
+        array_init(&list);
+        add_next_index_string(&list, headers[i][1]);
+        zend_hash_str_add_new(
+            arr, headers[i][0], strlen(headers[i][0]), &list);
+    }
+    return arr;
+}
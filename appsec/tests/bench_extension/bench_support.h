@@ -0,0 +1,54 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include "mock_helper.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Glue between the benchmarks and the extension: the extension is linked
+// statically into the benchmark, registered once the TEA SAPI has started up
+// and talks to a mock helper through a socket pair instead of the real helper.
+
+typedef struct {
+    int headers;    // HTTP_* entries in $_SERVER
+    int cookies;    // entries in $_COOKIE
+    int post_depth; // nesting level of $_POST
+    int post_width; // entries on each level of $_POST
+} bench_request_shape;
+
+// After tea_sapi_minit()
+bool bench_minit(void);
+// After tea_sapi_rinit()
+bool bench_rinit(const bench_request_shape *shape);
+// Before tea_sapi_rshutdown()
+void bench_rshutdown(void);
+
+void bench_set_verdict(mock_verdict verdict);
+
+// These return the dd_result of the command
+int bench_request_init(void);
+int bench_request_exec(void);
+int bench_request_shutdown(void);
+
+// Drops the tags and addresses accumulated by the commands so far
+void bench_reset_request_state(void);
+
+// Counts the Zend MM allocations (including reallocations) in between. Not
+// available on debug builds of PHP, where this always counts 0
+void bench_allocations_start(void);
+uint64_t bench_allocations_stop(void);
+
+size_t bench_take_bytes_sent(void);
+
+#ifdef __cplusplus
+}
+#endif
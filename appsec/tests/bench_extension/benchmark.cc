@@ -0,0 +1,190 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "bench_support.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <tea/testing/fixture.hpp>
+
+namespace {
+
+enum shape_arg {
+    arg_headers,
+    arg_cookies,
+    arg_post_depth,
+    arg_post_width,
+    arg_verdict,
+    arg_exec_count,
+};
+
+class ExtensionFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        bench_request_shape shape{
+            static_cast<int>(state.range(arg_headers)),
+            static_cast<int>(state.range(arg_cookies)),
+            static_cast<int>(state.range(arg_post_depth)),
+            static_cast<int>(state.range(arg_post_width)),
+        };
+
+        tea_ = std::make_unique<TeaTestCaseFixture>();
+        ready_ = tea_->tea_sapi_sinit() && tea_->tea_sapi_minit() &&
+                 bench_minit() && tea_->tea_sapi_rinit() &&
+                 bench_rinit(&shape);
+        if (ready_) {
+            bench_set_verdict(
+                static_cast<mock_verdict>(state.range(arg_verdict)));
+        }
+    }
+
+    void TearDown(const benchmark::State & /*state*/) override
+    {
+        if (ready_) {
+            bench_rshutdown();
+        }
+        // shuts down whatever stages were reached
+        tea_.reset();
+    }
+
+protected:
+    bool ready(benchmark::State &state)
+    {
+        if (!ready_) {
+            state.SkipWithError("Could not start PHP with the extension");
+        }
+        return ready_;
+    }
+
+    // Allocations are counted on an untimed call: the counting heap
+    // handlers bypass the Zend MM fast paths and would skew the timings
+    template <typename F> void count_allocations(benchmark::State &state, F f)
+    {
+        bench_allocations_start();
+        f();
+        auto allocs = bench_allocations_stop();
+        auto bytes = bench_take_bytes_sent();
+        bench_reset_request_state();
+
+        state.counters["allocs"] = static_cast<double>(allocs);
+        state.counters["sent_bytes"] = static_cast<double>(bytes);
+    }
+
+private:
+    std::unique_ptr<TeaTestCaseFixture> tea_;
+    bool ready_{};
+};
+
+BENCHMARK_DEFINE_F(ExtensionFixture, RequestInit)(benchmark::State &state)
+{
+    if (!ready(state)) {
+        return;
+    }
+    count_allocations(state, [] { bench_request_init(); });
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench_request_init());
+
+        state.PauseTiming();
+        bench_reset_request_state();
+        state.ResumeTiming();
+    }
+}
+
+BENCHMARK_DEFINE_F(ExtensionFixture, RequestExecBurst)
+(benchmark::State &state)
+{
+    if (!ready(state)) {
+        return;
+    }
+    auto count = state.range(arg_exec_count);
+    auto burst = [count] {
+        for (int64_t i = 0; i < count; i++) { bench_request_exec(); }
+    };
+    count_allocations(state, burst);
+
+    for (auto _ : state) {
+        burst();
+
+        state.PauseTiming();
+        bench_reset_request_state();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_DEFINE_F(ExtensionFixture, RequestShutdown)(benchmark::State &state)
+{
+    if (!ready(state)) {
+        return;
+    }
+    count_allocations(state, [] { bench_request_shutdown(); });
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench_request_shutdown());
+
+        state.PauseTiming();
+        bench_reset_request_state();
+        state.ResumeTiming();
+    }
+}
+
+// The three phases of a request as the extension runs them
+BENCHMARK_DEFINE_F(ExtensionFixture, Request)(benchmark::State &state)
+{
+    if (!ready(state)) {
+        return;
+    }
+    auto count = state.range(arg_exec_count);
+    auto request = [count] {
+        bench_request_init();
+        for (int64_t i = 0; i < count; i++) { bench_request_exec(); }
+        bench_request_shutdown();
+    };
+    count_allocations(state, request);
+
+    for (auto _ : state) {
+        request();
+
+        state.PauseTiming();
+        bench_reset_request_state();
+        state.ResumeTiming();
+    }
+}
+
+void request_shapes(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"headers", "cookies", "post_depth", "post_width", "verdict",
+        "exec"});
+    // NOLINTBEGIN(readability-magic-numbers)
+    b->Args({8, 2, 0, 0, mock_verdict_ok, 0});
+    b->Args({256, 2, 0, 0, mock_verdict_ok, 0});  // large header set
+    b->Args({8, 128, 0, 0, mock_verdict_ok, 0});  // many cookies
+    b->Args({8, 2, 16, 8, mock_verdict_ok, 0});   // deep POST body
+    b->Args({8, 2, 0, 0, mock_verdict_record, 0});
+    b->Args({8, 2, 0, 0, mock_verdict_block, 0});
+    // NOLINTEND(readability-magic-numbers)
+}
+
+void exec_bursts(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"headers", "cookies", "post_depth", "post_width", "verdict",
+        "exec"});
+    // NOLINTBEGIN(readability-magic-numbers)
+    b->Args({8, 2, 0, 0, mock_verdict_ok, 1});
+    b->Args({8, 2, 0, 0, mock_verdict_ok, 32});
+    b->Args({8, 2, 0, 0, mock_verdict_record, 32});
+    // NOLINTEND(readability-magic-numbers)
+}
+
+} // namespace
+
+BENCHMARK_REGISTER_F(ExtensionFixture, RequestInit)->Apply(request_shapes);
+BENCHMARK_REGISTER_F(ExtensionFixture, RequestExecBurst)->Apply(exec_bursts);
+BENCHMARK_REGISTER_F(ExtensionFixture, RequestShutdown)
+    ->Apply(request_shapes);
+BENCHMARK_REGISTER_F(ExtensionFixture, Request)->Apply(exec_bursts);
+
+BENCHMARK_MAIN();
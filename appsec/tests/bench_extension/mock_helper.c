@@ -0,0 +1,229 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#include "mock_helper.h"
+#include <errno.h>
+#include <mpack.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Same framing as network.c
+struct __attribute__((packed)) _mock_header {
+    char code[4]; // dds\0
+    uint32_t size;
+};
+
+struct _mock_helper {
+    int fd;
+    pthread_t thread;
+    atomic_int verdict;
+    atomic_size_t bytes_received;
+};
+
+// The event data is stored as is, its content does not matter to the extension
+static const char _trigger_json[] =
+    "[{\"rule\":{\"id\":\"bench-001\",\"name\":\"Benchmark rule\","
+    "\"tags\":{\"type\":\"security_scanner\",\"category\":\"attack_attempt\"}},"
+    "\"rule_matches\":[{\"operator\":\"match_regex\",\"operator_value\":\"^x\","
+    "\"parameters\":[{\"address\":\"server.request.headers.no_cookies\","
+    "\"key_path\":[\"user-agent\"],\"value\":\"x\",\"highlight\":[\"x\"]}]}]}]";
+
+static void *_mock_helper_run(void *arg);
+static bool _read_full(int fd, void *buf, size_t len);
+static bool _write_full(int fd, struct iovec *iov, int iovcnt);
+static void _write_reply(mpack_writer_t *w, const char *cmd, size_t cmd_len,
+    mock_verdict verdict);
+
+mock_helper *mock_helper_start(int fd)
+{
+    mock_helper *helper = calloc(1, sizeof(*helper));
+    if (!helper) {
+        close(fd);
+        return NULL;
+    }
+    helper->fd = fd;
+    atomic_init(&helper->verdict, mock_verdict_ok);
+    atomic_init(&helper->bytes_received, 0);
+
+    if (pthread_create(&helper->thread, NULL, _mock_helper_run, helper) != 0) {
+        close(fd);
+        free(helper);
+        return NULL;
+    }
+
+    return helper;
+}
+
+void mock_helper_stop(mock_helper *helper)
+{
+    if (!helper) {
+        return;
+    }
+    // wakes up the thread if it's blocked on recv()
+    shutdown(helper->fd, SHUT_RDWR);
+    pthread_join(helper->thread, NULL);
+    close(helper->fd);
+    free(helper);
+}
+
+void mock_helper_set_verdict(mock_helper *helper, mock_verdict verdict)
+{
+    atomic_store(&helper->verdict, verdict);
+}
+
+size_t mock_helper_take_bytes_received(mock_helper *helper)
+{
+    return atomic_exchange(&helper->bytes_received, 0);
+}
+
+static void *_mock_helper_run(void *arg)
+{
+    mock_helper *helper = arg;
+
+    while (true) {
+        struct _mock_header h;
+        if (!_read_full(helper->fd, &h, sizeof(h)) ||
+            memcmp(h.code, "dds", 3) != 0) {
+            break;
+        }
+
+        char *body = malloc(h.size);
+        if (!body || !_read_full(helper->fd, body, h.size)) {
+            free(body);
+            break;
+        }
+        atomic_fetch_add(&helper->bytes_received, h.size);
+
+        // [ command, [arguments...] ]
+        mpack_tree_t tree;
+        mpack_tree_init(&tree, body, h.size);
+        mpack_tree_parse(&tree);
+        mpack_node_t cmd = mpack_node_array_at(mpack_tree_root(&tree), 0);
+
+        char *reply = NULL;
+        size_t reply_size = 0;
+        mpack_writer_t w;
+        mpack_writer_init_growable(&w, &reply, &reply_size);
+        _write_reply(&w, mpack_node_str(cmd), mpack_node_strlen(cmd),
+            atomic_load(&helper->verdict));
+        mpack_error_t err = mpack_writer_destroy(&w);
+
+        bool parse_failed = mpack_tree_destroy(&tree) != mpack_ok;
+        free(body);
+        if (parse_failed || err != mpack_ok) {
+            free(reply);
+            break;
+        }
+
+        struct _mock_header rh = {"dds", (uint32_t)reply_size};
+        struct iovec iov[2] = {
+            {.iov_base = &rh, .iov_len = sizeof(rh)},
+            {.iov_base = reply, .iov_len = reply_size},
+        };
+        bool sent = _write_full(helper->fd, iov, 2);
+        free(reply);
+        if (!sent) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+// [ [ command, [ [[verdict, params]], [event data...], force_keep ] ] ]
+static void _write_reply(mpack_writer_t *w, const char *cmd, size_t cmd_len,
+    mock_verdict verdict)
+{
+    mpack_start_array(w, 1);
+    mpack_start_array(w, 2);
+    mpack_write_str(w, cmd, (uint32_t)cmd_len);
+    mpack_start_array(w, 3);
+
+    mpack_start_array(w, 1);
+    mpack_start_array(w, 2);
+    switch (verdict) {
+    case mock_verdict_block:
+        mpack_write_cstr(w, "block");
+        mpack_start_map(w, 2);
+        mpack_write_cstr(w, "status_code");
+        mpack_write_cstr(w, "403");
+        mpack_write_cstr(w, "type");
+        mpack_write_cstr(w, "auto");
+        mpack_finish_map(w);
+        break;
+    case mock_verdict_record:
+        mpack_write_cstr(w, "record");
+        mpack_start_map(w, 0);
+        mpack_finish_map(w);
+        break;
+    default:
+        mpack_write_cstr(w, "ok");
+        mpack_start_map(w, 0);
+        mpack_finish_map(w);
+        break;
+    }
+    mpack_finish_array(w);
+    mpack_finish_array(w);
+
+    if (verdict == mock_verdict_ok) {
+        mpack_start_array(w, 0);
+    } else {
+        mpack_start_array(w, 1);
+        mpack_write_str(w, _trigger_json, sizeof(_trigger_json) - 1);
+    }
+    mpack_finish_array(w);
+
+    mpack_write_false(w);
+
+    mpack_finish_array(w);
+    mpack_finish_array(w);
+    mpack_finish_array(w);
+}
+
+static bool _read_full(int fd, void *buf, size_t len)
+{
+    char *p = buf;
+    while (len > 0) {
+        ssize_t r = recv(fd, p, len, 0);
+        if (r == -1 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return false;
+        }
+        p += r;
+        len -= (size_t)r;
+    }
+    return true;
+}
+
+static bool _write_full(int fd, struct iovec *iov, int iovcnt)
+{
+    while (iovcnt > 0) {
+        ssize_t written = writev(fd, iov, iovcnt);
+        if (written == -1 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        while (iovcnt > 0 && (size_t)written >= iov->iov_len) {
+            written -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= (size_t)written;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+// Unless explicitly stated otherwise all files in this repository are
+// dual-licensed under the Apache-2.0 License or BSD-3-Clause License.
+//
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/). Copyright 2021 Datadog, Inc.
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A helper running on a thread of the benchmark process. It reads the framed
+// msgpack commands sent by the extension and answers every one of them with
+// the same canned verdict, so that only the extension side is measured.
+
+typedef enum {
+    mock_verdict_ok,
+    mock_verdict_record,
+    mock_verdict_block,
+} mock_verdict;
+
+typedef struct _mock_helper mock_helper;
+
+// Takes ownership of fd, one end of a connected socket pair
+mock_helper *mock_helper_start(int fd);
+void mock_helper_stop(mock_helper *helper);
+
+void mock_helper_set_verdict(mock_helper *helper, mock_verdict verdict);
+
+// Size of the message bodies received since the last call
+size_t mock_helper_take_bytes_received(mock_helper *helper);
+
+#ifdef __cplusplus
+}
+#endif
@@ -262,6 +262,11 @@ void ddog_sidecar_telemetry_register_metric_buffer(struct ddog_SidecarActionsBuf
                                                    ddog_CharSlice metric_name,
                                                    enum ddog_MetricNamespace namespace_);
 
+void ddog_sidecar_telemetry_register_metric_type_buffer(struct ddog_SidecarActionsBuffer *buffer,
+                                                        ddog_CharSlice metric_name,
+                                                        enum ddog_MetricNamespace namespace_,
+                                                        enum ddog_MetricType metric_type);
+
 void ddog_sidecar_telemetry_add_span_metric_point_buffer(struct ddog_SidecarActionsBuffer *buffer,
                                                          ddog_CharSlice metric_name,
                                                          double metric_value,
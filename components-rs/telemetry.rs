@@ -140,11 +140,25 @@ pub unsafe extern "C" fn ddog_sidecar_telemetry_register_metric_buffer(
     metric_name: CharSlice,
     namespace: MetricNamespace,
 ) {
+    ddog_sidecar_telemetry_register_metric_type_buffer(
+        buffer,
+        metric_name,
+        namespace,
+        data::metrics::MetricType::Count,
+    );
+}
 
+#[no_mangle]
+pub unsafe extern "C" fn ddog_sidecar_telemetry_register_metric_type_buffer(
+    buffer: &mut SidecarActionsBuffer,
+    metric_name: CharSlice,
+    namespace: MetricNamespace,
+    metric_type: data::metrics::MetricType,
+) {
     buffer.buffer.push(SidecarAction::RegisterTelemetryMetric(MetricContext {
         name: metric_name.to_utf8_lossy().into_owned(),
         namespace,
-        metric_type: data::metrics::MetricType::Count,
+        metric_type,
         tags: Vec::default(),
         common: true,
     }));
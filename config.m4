@@ -204,6 +204,8 @@ if test "$PHP_DDTRACE" != "no"; then
     ext/startup_logging.c \
     ext/telemetry.c \
     ext/threads.c \
+    ext/trace_stats.c \
+    ext/tracer_overhead.c \
     ext/tracer_tag_propagation/tracer_tag_propagation.c \
     ext/user_request.c \
     ext/hook/uhook.c \
@@ -63,6 +63,7 @@ ZEND_RESULT_CODE ddtrace_flush_tracer(bool force_on_startup, bool collect_cycles
                                 .lang_vendor = DDOG_CHARSLICE_C_BARE(""),
                                 .tracer_version = DDOG_CHARSLICE_C_BARE(PHP_DDTRACE_VERSION),
                                 .lang_version = dd_zend_string_to_CharSlice(ddtrace_php_version),
+                                // Client side stats are only computed with the background sender
                                 .client_computed_top_level = false,
                                 .client_computed_stats = false,
                         };
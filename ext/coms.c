@@ -38,6 +38,7 @@
 #include "logging.h"
 #include "mpack/mpack.h"
 #include "sidecar.h"
+#include "trace_stats.h"
 #include "zend_smart_str.h"
 
 extern inline bool ddtrace_coms_is_stack_unused(ddtrace_coms_stack_t *stack);
@@ -341,6 +342,9 @@ struct _writer_loop_data_t {
     bool set_secbit;
 
     _Atomic(bool) running, starting_up;
+    // set in forked children until the writer thread is actually needed, see ddtrace_coms_init_writer_lazily
+    _Atomic(bool) start_pending;
+    struct timespec start_pending_deadline;
     _Atomic(pid_t) current_pid;
     _Atomic(bool) shutdown_when_idle, suspended, sending, allocate_new_stacks;
     _Atomic(uint32_t) flush_interval, request_counter, flush_processed_stacks_total, writer_cycle,
@@ -369,7 +373,23 @@ static bool ddtrace_coms_threadsafe_rotate_stack(bool attempt_allocate_new, size
     return rv;
 }
 
+static bool _dd_coms_start_pending_writer(void);
+static bool _dd_is_deadline_passed(struct timespec deadline);
+
+/* There is no thread sending what a lazily initialized child buffered, so whenever the tracer is active anyway
+ * (buffering, flushing, request shutdown) we check whether the child has outlived one flush interval. */
+static void _dd_coms_start_pending_writer_if_due(void) {
+    struct _writer_loop_data_t *writer = _dd_get_writer();
+    if (atomic_load(&writer->start_pending) && _dd_is_deadline_passed(writer->start_pending_deadline)) {
+        // not short-lived after all
+        _dd_coms_start_pending_writer();
+    }
+}
+
 bool ddtrace_coms_buffer_data(uint32_t group_id, const char *data, size_t size) {
+    struct _writer_loop_data_t *writer = _dd_get_writer();
+    _dd_coms_start_pending_writer_if_due();
+
     if (!data || size > ddtrace_coms_globals.max_payload_size) {
         return false;
     }
@@ -388,6 +408,10 @@ bool ddtrace_coms_buffer_data(uint32_t group_id, const char *data, size_t size)
     }
 
     if (store_result == ENOMEM) {
+        // the stack needs rotating, which is the writer's job
+        if (atomic_load(&writer->start_pending)) {
+            _dd_coms_start_pending_writer();
+        }
         size_t padding = 2;
         ddtrace_coms_threadsafe_rotate_stack(true, size + padding);
         ddtrace_coms_trigger_writer_flush();
@@ -673,6 +697,7 @@ static ddtrace_coms_stack_t *_dd_coms_attempt_acquire_stack(void) {
 }
 
 #define TRACE_PATH_STR "/v0.4/traces"
+#define STATS_PATH_STR "/v0.6/stats"
 
 static struct curl_slist *dd_agent_curl_headers = NULL;
 
@@ -696,6 +721,12 @@ static struct curl_slist *dd_agent_headers_alloc(void) {
     dd_append_header(&list, "Datadog-Meta-Lang-Version", ZSTR_VAL(ddtrace_php_version));
     dd_append_header(&list, "Datadog-Meta-Tracer-Version", PHP_DDTRACE_VERSION);
 
+    if (ddtrace_trace_stats_enabled()) {
+        // Tell the agent not to compute stats on its own, we've already done it
+        dd_append_header(&list, "Datadog-Client-Computed-Stats", "yes");
+        dd_append_header(&list, "Datadog-Client-Computed-Top-Level", "yes");
+    }
+
     ddog_CharSlice id = ddtrace_get_container_id();
     if (id.len) {
         char header[256];
@@ -720,10 +751,14 @@ static void dd_agent_headers_free(struct curl_slist *list) {
 
 void ddtrace_coms_curl_shutdown(void) {
     dd_agent_headers_free(dd_agent_curl_headers);
+    dd_agent_curl_headers = NULL;
 
     if (dd_agent_config_writer) {
         ddog_agent_remote_config_writer_drop(dd_agent_config_writer);
         ddog_drop_anon_shm_handle(ddtrace_coms_agent_config_handle);
+        // forked children only recreate them once their writer starts
+        dd_agent_config_writer = NULL;
+        ddtrace_coms_agent_config_handle = NULL;
     }
 }
 
@@ -764,6 +799,17 @@ void ddtrace_curl_set_telemetry_url(CURL *curl) {
     ddtrace_curl_set_hostname_generic(curl, "/telemetry/proxy/api/v2/apmtelemetry");
 }
 
+static void ddtrace_curl_set_stats_url(CURL *curl) {
+    ddtrace_curl_set_hostname_generic(curl, STATS_PATH_STR);
+}
+
+static bool _dd_is_deadline_passed(struct timespec deadline) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec > deadline.tv_sec ||
+           (now.tv_sec == deadline.tv_sec && now.tv_usec * 1000L >= deadline.tv_nsec);
+}
+
 static struct timespec _dd_deadline_in_ms(uint32_t ms) {
     struct timespec deadline;
     struct timeval now;
@@ -885,7 +931,10 @@ static void _dd_curl_send_stack(struct _writer_loop_data_t *writer, ddtrace_coms
 
             // No response happens with test agents for example
             if (response.s) {
-                ddog_agent_remote_config_write(dd_agent_config_writer, dd_zend_string_to_CharSlice(response.s));
+                // Not there when flushing from an exiting child which never started its writer
+                if (dd_agent_config_writer) {
+                    ddog_agent_remote_config_write(dd_agent_config_writer, dd_zend_string_to_CharSlice(response.s));
+                }
                 smart_str_free_ex(&response, true);
             }
         }
@@ -923,6 +972,47 @@ static void _dd_curl_send_stack(struct _writer_loop_data_t *writer, ddtrace_coms
     _dd_curl_reset_headers(writer);
 }
 
+static void _dd_curl_send_stats(bool force) {
+    char *payload;
+    size_t size;
+    if (!ddtrace_trace_stats_serialize(force, &payload, &size)) {
+        return;
+    }
+
+    CURL *curl = curl_easy_init();
+    struct curl_slist *headers = NULL;
+    for (struct curl_slist *current = dd_agent_curl_headers; current; current = current->next) {
+        headers = curl_slist_append(headers, current->data);
+    }
+    headers = curl_slist_append(headers, "Content-Type: application/msgpack");
+    if (*ddtrace_coms_globals.test_session_token) {
+        char buffer[300];
+        sprintf(buffer, "x-datadog-test-session-token: %s", ddtrace_coms_globals.test_session_token);
+        headers = curl_slist_append(headers, buffer);
+    }
+
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _dd_dummy_write_callback);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (long)size);
+    curl_easy_setopt(curl, CURLOPT_VERBOSE, (long) get_global_DD_TRACE_AGENT_DEBUG_VERBOSE_CURL());
+    ddtrace_curl_set_stats_url(curl);
+    ddtrace_curl_set_timeout(curl);
+    ddtrace_curl_set_connect_timeout(curl);
+
+    CURLcode res = curl_easy_perform(curl);
+    if (res != CURLE_OK) {
+        ddtrace_bgs_logf("[bgs] sending client side stats failed: %s\n", curl_easy_strerror(res));
+    } else {
+        ddtrace_bgs_logf("[bgs] uploaded %zu bytes of client side stats\n", size);
+    }
+
+    curl_easy_cleanup(curl);
+    curl_slist_free_all(headers);
+    free(payload);
+}
+
 static void _dd_signal_writer_started(struct _writer_loop_data_t *writer) {
     if (writer->thread) {
         // at the moment no actual signal is sent but we will set a threadsafe state variable
@@ -1146,6 +1236,11 @@ static void *_dd_writer_loop(void *_) {
         writer->curl = NULL;
         curl_easy_cleanup(curl);
 
+        if (ddtrace_trace_stats_enabled() && atomic_load(&writer->sending)) {
+            // Completed buckets are shipped as soon as possible, and everything when shutting down
+            _dd_curl_send_stats(atomic_load(&writer->shutdown_when_idle));
+        }
+
         if (processed_stacks > 0) {
             atomic_fetch_add(&writer->flush_processed_stacks_total, processed_stacks);
         } else if (atomic_load(&writer->shutdown_when_idle)) {
@@ -1222,6 +1317,7 @@ bool ddtrace_coms_restart_writer(void) {
 
 bool ddtrace_coms_init_and_start_writer(void) {
     struct _writer_loop_data_t *writer = _dd_get_writer();
+    atomic_store(&writer->start_pending, false);
     atomic_store(&writer->current_pid, getpid());
 
     dd_agent_curl_headers = dd_agent_headers_alloc();
@@ -1234,6 +1330,73 @@ bool ddtrace_coms_init_and_start_writer(void) {
     return _dd_coms_start_writer();
 }
 
+void ddtrace_coms_init_writer_lazily(void) {
+    struct _writer_loop_data_t *writer = _dd_get_writer();
+    atomic_store(&writer->current_pid, getpid());
+
+    dd_agent_curl_headers = dd_agent_headers_alloc();
+
+    if (writer->thread) {
+        return;
+    }
+
+    _dd_writer_set_operational_state(writer);
+    writer->start_pending_deadline = _dd_deadline_in_ms(get_global_DD_TRACE_AGENT_FLUSH_INTERVAL());
+    atomic_store(&writer->start_pending, true);
+}
+
+static bool _dd_coms_start_pending_writer(void) {
+    struct _writer_loop_data_t *writer = _dd_get_writer();
+    bool pending = true;
+    if (!atomic_compare_exchange_strong(&writer->start_pending, &pending, false)) {
+        return false;  // someone else got there first
+    }
+
+    ddtrace_ffi_try("error creating config writer", ddog_create_agent_remote_config_writer(&dd_agent_config_writer, &ddtrace_coms_agent_config_handle));
+    return _dd_coms_start_writer();
+}
+
+/* A child which exits before its writer was started has at most a single stack worth of traces (filling it up starts
+ * the writer). Sending it from the exiting thread is much cheaper than spinning up a thread just to join it. */
+static void _dd_coms_flush_pending_from_current_thread(void) {
+    struct _writer_loop_data_t *writer = _dd_get_writer();
+    bool pending = true;
+    if (!atomic_compare_exchange_strong(&writer->start_pending, &pending, false)) {
+        return;
+    }
+
+    // there is no writer thread to race with
+    _dd_coms_unsafe_rotate_stack(false, ddtrace_coms_globals.initial_stack_size);
+
+    ddtrace_coms_stack_t *stack = _dd_coms_attempt_acquire_stack();
+    if (stack) {
+        writer->curl = curl_easy_init();
+        curl_easy_setopt(writer->curl, CURLOPT_READFUNCTION, _dd_coms_read_callback);
+        curl_easy_setopt(writer->curl, CURLOPT_WRITEFUNCTION, _dd_dummy_write_callback);
+        curl_easy_setopt(writer->curl, CURLOPT_NOSIGNAL, 1);
+
+        trace_api_metrics metrics = {0};
+        do {
+            if (atomic_load(&writer->sending)) {
+                _dd_curl_send_stack(writer, stack, &metrics);
+            }
+            _dd_coms_free_stack(stack);
+        } while ((stack = _dd_coms_attempt_acquire_stack()));
+
+        CURL *curl = writer->curl;
+        writer->curl = NULL;
+        curl_easy_cleanup(curl);
+
+        ddtrace_telemetry_send_trace_api_metrics(metrics);
+    }
+
+    if (ddtrace_trace_stats_enabled() && atomic_load(&writer->sending)) {
+        _dd_curl_send_stats(true);
+    }
+
+    _dd_curl_reset_headers(writer);
+}
+
 static bool _dd_has_pid_changed(void) {
     struct _writer_loop_data_t *writer = _dd_get_writer();
     pid_t current_pid = getpid();
@@ -1286,6 +1449,7 @@ bool ddtrace_coms_on_pid_change(void) {
 
 bool ddtrace_coms_trigger_writer_flush(void) {
     struct _writer_loop_data_t *writer = _dd_get_writer();
+    _dd_coms_start_pending_writer_if_due();
     if (writer->thread) {
         pthread_mutex_lock(&writer->thread->interval_flush_mutex);
         pthread_cond_signal(&writer->thread->interval_flush_condition);
@@ -1298,6 +1462,9 @@ bool ddtrace_coms_trigger_writer_flush(void) {
 void ddtrace_coms_rshutdown(void) {
     struct _writer_loop_data_t *writer = _dd_get_writer();
 
+    // a child serving requests must not hold on to the traces of a past one until it exits
+    _dd_coms_start_pending_writer_if_due();
+
     atomic_fetch_add(&writer->request_counter, 1);
 
     /* atomic_fetch_add returns the old value, so +1 to get the current value;
@@ -1315,6 +1482,9 @@ void ddtrace_coms_rshutdown(void) {
 // Returns true if writer is shutdown completely
 bool ddtrace_coms_flush_shutdown_writer_synchronous(void) {
     struct _writer_loop_data_t *writer = _dd_get_writer();
+    if (atomic_load(&writer->start_pending) && !_dd_has_pid_changed()) {
+        _dd_coms_flush_pending_from_current_thread();
+    }
     if (!writer->thread) {
         return true;
     }
@@ -1365,6 +1535,12 @@ bool ddtrace_coms_flush_shutdown_writer_synchronous(void) {
 
 bool ddtrace_coms_synchronous_flush(uint32_t timeout) {
     struct _writer_loop_data_t *writer = _dd_get_writer();
+    if (atomic_load(&writer->start_pending)) {
+        _dd_coms_start_pending_writer();
+    }
+    if (!writer->thread) {
+        return false;
+    }
     uint32_t previous_writer_cycle = atomic_load(&writer->writer_cycle);
     uint32_t previous_processed_stacks_total = atomic_load(&writer->flush_processed_stacks_total);
     int64_t old_flush_interval = atomic_load(&writer->flush_interval);
@@ -66,6 +66,10 @@ uint32_t ddtrace_coms_next_group_id(void);
 void ddtrace_coms_set_test_session_token(const char *token, size_t token_len);
 
 bool ddtrace_coms_init_and_start_writer(void);
+/* Used in forked children: the writer thread is only started once traces are buffered and the child didn't exit
+ * within a flush interval, or when they don't fit into the current stack anymore. Otherwise the traces are sent from
+ * the exiting thread. */
+void ddtrace_coms_init_writer_lazily(void);
 bool ddtrace_coms_restart_writer(void);
 bool ddtrace_coms_trigger_writer_flush(void);
 bool ddtrace_coms_set_writer_send_on_flush(bool send);
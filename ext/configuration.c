@@ -4,6 +4,7 @@
 
 #include "ip_extraction.h"
 #include "logging.h"
+#include "memory_limit.h"
 #include "json/json.h"
 #include "sidecar.h"
 #include <components/log/log.h>
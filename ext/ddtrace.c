@@ -42,6 +42,7 @@
 #ifndef _WIN32
 #include "comms_php.h"
 #include "coms.h"
+#include "trace_stats.h"
 #endif
 #include "config/config.h"
 #include "configuration.h"
@@ -51,6 +52,7 @@
 #include "dogstatsd_client.h"
 #endif
 #include "engine_hooks.h"
+#include "exception_serialize.h"
 #include "excluded_modules.h"
 #include "handlers_http.h"
 #include "handlers_internal.h"
@@ -80,6 +82,7 @@
 
 #include "hook/uhook.h"
 #include "handlers_fiber.h"
+#include "tracer_overhead.h"
 #include "handlers_exception.h"
 #include "exceptions/exceptions.h"
 #include "git.h"
@@ -375,6 +378,7 @@ bool ddtrace_alter_sampling_rules_file_config(zval *old_value, zval *new_value,
 static inline void dd_alter_prop(size_t prop_offset, zval *old_value, zval *new_value, zend_string *new_str) {
     UNUSED(old_value, new_str);
 
+    ++DDTRACE_G(span_properties_generation);
     ddtrace_span_properties *pspan = ddtrace_active_span_props();
     while (pspan) {
         zval *property = (zval *) (prop_offset + (char *) pspan), garbage = *property;
@@ -455,6 +459,7 @@ static void dd_activate_once(void) {
                 // Set the default to 5000 so that BGS does not flush too often. The sidecar can flush more often, but the BGS is per process. Keep it higher to avoid too much load on the agent.
                 ddtrace_change_default_ini(DDTRACE_CONFIG_DD_TRACE_AGENT_FLUSH_INTERVAL, (zai_str) ZAI_STR_FROM_CSTR("5000"));
             }
+            ddtrace_trace_stats_minit();
             ddtrace_coms_minit(get_global_DD_TRACE_AGENT_STACK_INITIAL_SIZE(),
                                get_global_DD_TRACE_AGENT_MAX_PAYLOAD_SIZE(),
                                get_global_DD_TRACE_AGENT_STACK_BACKLOG(),
@@ -468,6 +473,10 @@ static void dd_activate_once(void) {
             }
         }
 #endif
+        if (get_global_DD_TRACE_SIDECAR_TRACE_SENDER() && get_global_DD_TRACE_STATS_COMPUTATION_ENABLED()) {
+            // The sidecar has no endpoint to ship client side stats to, their computation is left to the agent
+            LOG(WARN, "DD_TRACE_STATS_COMPUTATION_ENABLED is only supported by the background sender, it is ignored with the sidecar trace sender");
+        }
     }
 }
 
@@ -666,6 +675,17 @@ static PHP_GSHUTDOWN_FUNCTION(ddtrace) {
     if (ddtrace_globals->agent_info_reader) {
         ddog_drop_agent_info_reader(ddtrace_globals->agent_info_reader);
     }
+    if (ddtrace_globals->active_global_tags_source.tags) {
+        ddog_Vec_Tag_drop(ddtrace_globals->active_global_tags);
+        zend_hash_destroy(ddtrace_globals->active_global_tags_source.tags);
+        pefree(ddtrace_globals->active_global_tags_source.tags, 1);
+        if (ddtrace_globals->active_global_tags_source.commit) {
+            zend_string_release(ddtrace_globals->active_global_tags_source.commit);
+        }
+        if (ddtrace_globals->active_global_tags_source.repository) {
+            zend_string_release(ddtrace_globals->active_global_tags_source.repository);
+        }
+    }
     zai_hook_gshutdown();
     if (ddtrace_globals->telemetry_buffer) {
         ddog_sidecar_telemetry_buffer_drop(ddtrace_globals->telemetry_buffer);
@@ -1061,6 +1081,12 @@ static zval *ddtrace_span_data_readonly(zend_object *object, zend_string *member
     }
 
     ddtrace_span_data *span = OBJ_SPANDATA(obj);
+    if (zend_string_equals_literal(prop_name, "service")
+     || zend_string_equals_literal(prop_name, "env")
+     || zend_string_equals_literal(prop_name, "version")) {
+        ++DDTRACE_G(span_properties_generation);
+    }
+
     // As per unified service tagging spec if a span is created with a service name different from the global
     // service name it will not inherit the global version value
     if (zend_string_equals_literal(prop_name, "service")) {
@@ -1080,6 +1106,25 @@ static zval *ddtrace_span_data_readonly(zend_object *object, zend_string *member
 #endif
 }
 
+// Compound assignments ($span->service .= ...) and taking references go through get_property_ptr_ptr, not write_property
+#if PHP_VERSION_ID < 80000
+static zval *ddtrace_span_data_get_property_ptr_ptr(zval *object, zval *member, int type, void **cache_slot) {
+    zend_string *prop_name = Z_TYPE_P(member) == IS_STRING ? Z_STR_P(member) : ZSTR_EMPTY_ALLOC();
+#else
+static zval *ddtrace_span_data_get_property_ptr_ptr(zend_object *object, zend_string *member, int type, void **cache_slot) {
+    zend_string *prop_name = member;
+#endif
+    if (zend_string_equals_literal(prop_name, "service")
+     || zend_string_equals_literal(prop_name, "env")
+     || zend_string_equals_literal(prop_name, "version")) {
+        // The modification follows immediately, so the next lookup sees it. Later writes through a reference don't.
+        ++DDTRACE_G(span_properties_generation);
+        cache_slot = NULL;
+    }
+
+    return zend_std_get_property_ptr_ptr(object, member, type, cache_slot);
+}
+
 #if PHP_VERSION_ID < 80000
 #if PHP_VERSION_ID >= 70400
 static zval *ddtrace_root_span_data_write(zval *object, zval *member, zval *value, void **cache_slot) {
@@ -1221,6 +1266,7 @@ static void dd_register_span_data_ce(void) {
     ddtrace_span_data_handlers.clone_obj = ddtrace_span_data_clone_obj;
     ddtrace_span_data_handlers.free_obj = ddtrace_span_data_free_storage;
     ddtrace_span_data_handlers.write_property = ddtrace_span_data_readonly;
+    ddtrace_span_data_handlers.get_property_ptr_ptr = ddtrace_span_data_get_property_ptr_ptr;
     ddtrace_span_data_handlers.get_constructor = ddtrace_span_data_get_constructor;
 
     ddtrace_ce_root_span_data = register_class_DDTrace_RootSpanData(ddtrace_ce_span_data);
@@ -1445,6 +1491,7 @@ static PHP_MINIT_FUNCTION(ddtrace) {
     ddtrace_git_metadata_handlers.free_obj = ddtrace_free_obj_wrapper;
 
     ddtrace_engine_hooks_minit();
+    ddtrace_memory_limit_minit();
 
     ddtrace_integrations_minit();
     dd_ip_extraction_startup();
@@ -1487,6 +1534,7 @@ static PHP_MSHUTDOWN_FUNCTION(ddtrace) {
         if (ddtrace_coms_flush_shutdown_writer_synchronous()) {
             ddtrace_coms_curl_shutdown();
         }
+        ddtrace_trace_stats_mshutdown();
     }
 #endif
 
@@ -1596,6 +1644,8 @@ static void dd_initialize_request(void) {
 
     // Reset compile time after request init hook has compiled
     ddtrace_compile_time_reset();
+    ddtrace_overhead_rinit();
+    ddtrace_memory_limit_rinit();
 
     dd_prepare_for_new_trace();
 
@@ -1624,6 +1674,9 @@ static PHP_RINIT_FUNCTION(ddtrace) {
 #endif
     }
 
+    // A bailout during serialization skips the cache clear; its memory went away with the previous request heap
+    DDTRACE_G(error_stack_cache) = NULL;
+
     if (get_DD_TRACE_ENABLED()) {
         dd_initialize_request();
     }
@@ -1692,6 +1745,9 @@ static void dd_shutdown_hooks_and_observer(void) {
 void dd_force_shutdown_tracing(void) {
     DDTRACE_G(in_shutdown) = true;
 
+    // Don't account the shutdown flush to a section a bailout left open
+    ddtrace_overhead_unwind();
+
     zend_try {
         ddtrace_close_all_open_spans(true);  // All remaining userland spans (and root span)
     } zend_catch {
@@ -1734,12 +1790,17 @@ static PHP_RSHUTDOWN_FUNCTION(ddtrace) {
     // run unconditionally because ddtrace may've been disabled mid-request
     ddtrace_exec_handlers_rshutdown();
 
+    ddtrace_live_debugger_flush_metrics();
+
     if (get_DD_TRACE_ENABLED()) {
         dd_force_shutdown_tracing();
     } else if (!ddtrace_disable) {
         dd_shutdown_hooks_and_observer();
     }
 
+    ddtrace_live_debugger_rshutdown();
+    ddtrace_exception_stack_cache_clear();
+
     if (DDTRACE_G(remote_config_state)) {
         ddtrace_rshutdown_remote_config();
     }
@@ -1749,6 +1810,9 @@ static PHP_RSHUTDOWN_FUNCTION(ddtrace) {
 
         OBJ_RELEASE(&DDTRACE_G(active_stack)->std);
         DDTRACE_G(active_stack) = NULL;
+#if PHP_VERSION_ID >= 80200
+        DDTRACE_G(lazy_stack_fiber) = NULL;
+#endif
     }
 
     dd_finalize_sidecar_lifecycle();
@@ -1784,6 +1848,9 @@ zend_result ddtrace_post_deactivate(void) {
 
     // zai config may be accessed indirectly via other modules RSHUTDOWN, so delay this until the last possible time
     zai_config_rshutdown();
+    zai_headers_rshutdown();
+
+    ddtrace_sidecar_post_deactivate();
 
     return SUCCESS;
 }
@@ -2278,6 +2345,7 @@ void dd_internal_handle_fork(void) {
     if (!get_global_DD_TRACE_SIDECAR_TRACE_SENDER()) {
         ddtrace_coms_curl_shutdown();
         ddtrace_coms_clean_background_sender_after_fork();
+        ddtrace_trace_stats_clean_after_fork();
     }
 #endif
     if (DDTRACE_G(agent_config_reader)) {
@@ -2315,11 +2383,9 @@ void dd_internal_handle_fork(void) {
 
 #ifndef _WIN32
     if (!get_global_DD_TRACE_SIDECAR_TRACE_SENDER()) {
-        ddtrace_coms_init_and_start_writer();
-
-        if (ddtrace_coms_agent_config_handle) {
-            ddog_agent_remote_config_reader_for_anon_shm(ddtrace_coms_agent_config_handle, &DDTRACE_G(agent_config_reader));
-        }
+        // Many children (e.g. fork-per-job queue workers) exit long before they'd benefit from a writer thread.
+        // The agent config reader is attached by ddtrace_try_read_agent_rate once the writer exists.
+        ddtrace_coms_init_writer_lazily();
     }
 #endif
 }
@@ -2719,6 +2785,7 @@ PHP_FUNCTION(DDTrace_start_span) {
 /* {{{ proto string DDTrace\start_trace_span() */
 PHP_FUNCTION(DDTrace_start_trace_span) {
     if (get_DD_TRACE_ENABLED()) {
+        ddtrace_ensure_fiber_span_stack();
         ddtrace_span_stack *stack = ddtrace_init_root_span_stack();
         ddtrace_switch_span_stack(stack);
         GC_DELREF(&stack->std); // We don't retain a ref to it, it's now the active_stack
@@ -2791,6 +2858,7 @@ PHP_FUNCTION(DDTrace_active_stack) {
     if (!DDTRACE_G(active_stack)) {
         RETURN_NULL();
     }
+    ddtrace_ensure_fiber_span_stack();
     RETURN_OBJ_COPY(&DDTRACE_G(active_stack)->std);
 }
 
@@ -2804,6 +2872,7 @@ PHP_FUNCTION(DDTrace_create_stack) {
         RETURN_OBJ(&ddtrace_init_root_span_stack()->std);
     }
 
+    ddtrace_ensure_fiber_span_stack();
     ddtrace_span_stack *stack = ddtrace_init_span_stack();
     ddtrace_switch_span_stack(stack);
     RETURN_OBJ(&stack->std);
@@ -2832,6 +2901,7 @@ PHP_FUNCTION(DDTrace_switch_stack) {
         RETURN_NULL();
     }
 
+    ddtrace_ensure_fiber_span_stack();
     if (stack) {
         ddtrace_switch_span_stack(stack);
     } else if (DDTRACE_G(active_stack)->parent_stack) {
@@ -3172,7 +3242,7 @@ bool ddtrace_tracer_is_limited(void) {
             return true;
         }
     }
-    return !ddtrace_is_memory_under_limit();
+    return ddtrace_is_memory_limit_reached();
 }
 
 /* {{{ proto string dd_trace_tracer_is_limited() */
@@ -55,6 +55,15 @@ static inline zend_array *ddtrace_property_array(zval *zv) {
 #define CXA_THREAD_ATEXIT_WRAPPER 1
 #endif
 
+// Tracer code paths whose own duration is accounted with DD_TRACE_MEASURE_OVERHEAD, see tracer_overhead.h
+typedef enum {
+    DDTRACE_OVERHEAD_HOOKS,
+    DDTRACE_OVERHEAD_SPANS,
+    DDTRACE_OVERHEAD_SERIALIZE,
+    DDTRACE_OVERHEAD_PROPAGATION,
+    DDTRACE_OVERHEAD_KINDS,
+} ddtrace_overhead_kind;
+
 bool ddtrace_tracer_is_limited(void);
 // prepare the tracer state to start handling a new trace
 void dd_prepare_for_new_trace(void);
@@ -118,12 +127,23 @@ ZEND_BEGIN_MODULE_GLOBALS(ddtrace)
     zend_long default_priority_sampling;
     zend_long propagated_priority_sampling;
     ddtrace_span_stack *active_stack; // never NULL except tracer is disabled
+#if PHP_VERSION_ID >= 80200
+    struct _zend_fiber_context *lazy_stack_fiber; // running fiber which still borrows active_stack from its parent
+#endif
     ddtrace_span_stack *top_closed_stack;
     HashTable traced_spans; // tie a span to a specific active execute_data
     uint32_t open_spans_count;
     uint32_t closed_spans_count;
     uint32_t dropped_spans_count;
+    int64_t memory_limit;
+    uint32_t memory_check_countdown;
+    bool memory_limit_fetched;
+    bool memory_limit_reached;
     int64_t compile_time_microseconds;
+    bool measure_overhead;
+    int overhead_kind;
+    uint64_t overhead_since;
+    uint64_t overhead_ns[DDTRACE_OVERHEAD_KINDS];
     ddtrace_trace_id distributed_trace_id;
     uint64_t distributed_parent_trace_id;
     zend_string *dd_origin;
@@ -135,12 +155,38 @@ ZEND_BEGIN_MODULE_GLOBALS(ddtrace)
     ddog_RemoteConfigState *remote_config_state;
     ddog_AgentInfoReader *agent_info_reader;
     zend_arena *debugger_capture_arena;
+    HashTable *error_stack_cache;
+    zend_arena *debugger_spare_arena;
     ddog_Vec_DebuggerPayload exception_debugger_buffer;
     HashTable active_rc_hooks;
+    HashTable *live_debugger_metrics;
+    uint64_t live_debugger_metrics_since;
     HashTable *agent_rate_by_service;
     zend_string *last_flushed_root_service_name;
     zend_string *last_flushed_root_env_name;
     ddog_Vec_Tag active_global_tags;
+    // Persistent copies of the DD_TAGS and git metadata active_global_tags was built from; the tags are NULL until then
+    struct {
+        HashTable *tags;
+        zend_string *commit;
+        zend_string *repository;
+        uint32_t generation;
+    } active_global_tags_source;
+    // The service data last sent over sidecar_queue_id, in request memory; service is NULL if nothing was sent yet
+    struct {
+        zend_string *service;
+        zend_string *env;
+        zend_string *version;
+        uint32_t tags_generation;
+    } sidecar_submitted_identity;
+    uint32_t span_properties_generation;
+    struct {
+        zend_string *env;
+        zend_string *service;
+        zend_string *version;
+        uint64_t span_id;
+        uint32_t generation;
+    } dogstatsd_base_tags;
 
     bool request_initialized;
     HashTable telemetry_spans_created_per_integration;
@@ -482,32 +482,125 @@ static void ddtrace_collect_exception_debug_data(zend_object *exception, zend_st
     zend_string_release(key_locals);
 }
 
+typedef struct {
+    zend_object *exception;
+    zend_string *stack;
+} dd_error_stack_cache_entry;
+
+static void dd_error_stack_cache_entry_dtor(zval *zv) {
+    dd_error_stack_cache_entry *entry = Z_PTR_P(zv);
+    OBJ_RELEASE(entry->exception);
+    zend_string_release(entry->stack);
+    efree(entry);
+}
+
+// Exceptions attached to multiple spans (e.g. propagating through several hooked frames) are only rendered once per flush
+static zend_string *dd_error_stack_cache_find(zend_object *exception) {
+    if (!DDTRACE_G(error_stack_cache)) {
+        return NULL;
+    }
+    dd_error_stack_cache_entry *entry = zend_hash_index_find_ptr(DDTRACE_G(error_stack_cache), exception->handle);
+    if (entry && entry->exception == exception) {
+        return zend_string_copy(entry->stack);
+    }
+    return NULL;
+}
+
+static void dd_error_stack_cache_add(zend_object *exception, zend_string *stack) {
+    if (!DDTRACE_G(error_stack_cache)) {
+        ALLOC_HASHTABLE(DDTRACE_G(error_stack_cache));
+        zend_hash_init(DDTRACE_G(error_stack_cache), 8, NULL, dd_error_stack_cache_entry_dtor, 0);
+    }
+    dd_error_stack_cache_entry *entry = emalloc(sizeof(*entry));
+    GC_ADDREF(exception);
+    entry->exception = exception;
+    entry->stack = zend_string_copy(stack);
+    zend_hash_index_update_ptr(DDTRACE_G(error_stack_cache), exception->handle, entry);
+}
+
+void ddtrace_exception_stack_cache_clear(void) {
+    if (DDTRACE_G(error_stack_cache)) {
+        zend_hash_destroy(DDTRACE_G(error_stack_cache));
+        FREE_HASHTABLE(DDTRACE_G(error_stack_cache));
+        DDTRACE_G(error_stack_cache) = NULL;
+    }
+}
+
+static zend_string *dd_truncate_error_stack(zend_string *stack) {
+    zend_long max_size = get_DD_TRACE_ERROR_STACK_MAX_SIZE();
+    if (max_size <= 0 || ZSTR_LEN(stack) <= (size_t)max_size) {
+        return stack;
+    }
+
+    // Keep both ends, the outermost frames tell where it was caught and the innermost ones where it was thrown
+    size_t head = (size_t)max_size / 2, tail = (size_t)max_size - head;
+    zend_string *truncated = zend_strpprintf(0, "%.*s\n[... %zu bytes omitted ...]\n%s", (int)head, ZSTR_VAL(stack),
+                                             ZSTR_LEN(stack) - head - tail, ZSTR_VAL(stack) + ZSTR_LEN(stack) - tail);
+    zend_string_release(stack);
+    return truncated;
+}
+
 // Guarantees that add_tag will only be called once per tag, will stop trying to add tags if one fails.
 zend_result ddtrace_exception_to_meta(zend_object *exception, zend_string *service_name, uint64_t time, void *context, add_tag_fn_t add_meta, enum dd_exception exception_state) {
     zend_object *exception_root = exception;
-    zend_string *full_trace = zai_get_trace_without_args_from_exception(exception);
+    zend_string *full_trace = dd_error_stack_cache_find(exception_root);
+
+    // Collect the chain first, then render it in a single pass, innermost exception first
+    zend_object *chain_buf[16], **chain = chain_buf;
+    uint32_t chain_len = 0, chain_cap = sizeof(chain_buf) / sizeof(*chain_buf);
+    chain[chain_len++] = exception;
 
     zval *previous = zai_exception_read_property(exception, ZSTR_KNOWN(ZEND_STR_PREVIOUS));
     while (Z_TYPE_P(previous) == IS_OBJECT && !Z_IS_RECURSIVE_P(previous) &&
            instanceof_function(Z_OBJCE_P(previous), zend_ce_throwable)) {
-        zend_string *trace_string = zai_get_trace_without_args_from_exception(Z_OBJ_P(previous));
-
-        zend_string *msg = zai_exception_message(exception);
-        zend_long line = zval_get_long(zai_exception_read_property(exception, ZSTR_KNOWN(ZEND_STR_LINE)));
-        zend_string *file = ddtrace_convert_to_str(zai_exception_read_property(exception, ZSTR_KNOWN(ZEND_STR_FILE)));
-
-        zend_string *complete_trace =
-        zend_strpprintf(0, "%s\n\nNext %s%s%s in %s:" ZEND_LONG_FMT "\nStack trace:\n%s", ZSTR_VAL(trace_string),
-                ZSTR_VAL(exception->ce->name), ZSTR_LEN(msg) ? ": " : "", ZSTR_VAL(msg), ZSTR_VAL(file),
-                line, ZSTR_VAL(full_trace));
-        zend_string_release(trace_string);
-        zend_string_release(full_trace);
-        zend_string_release(file);
-        full_trace = complete_trace;
-
         Z_PROTECT_RECURSION_P(previous);
         exception = Z_OBJ_P(previous);
         previous = zai_exception_read_property(exception, ZSTR_KNOWN(ZEND_STR_PREVIOUS));
+
+        if (chain_len == chain_cap) {
+            chain_cap *= 2;
+            if (chain == chain_buf) {
+                chain = emalloc(chain_cap * sizeof(*chain));
+                memcpy(chain, chain_buf, sizeof(chain_buf));
+            } else {
+                chain = erealloc(chain, chain_cap * sizeof(*chain));
+            }
+        }
+        chain[chain_len++] = exception;
+    }
+
+    if (!full_trace) {
+        uint32_t max_frames = (uint32_t)MAX(get_DD_TRACE_ERROR_STACK_MAX_FRAMES(), 0);
+        smart_str str = {0};
+        zai_append_trace_without_args_from_exception(&str, chain[chain_len - 1], max_frames);
+        for (uint32_t i = chain_len - 1; i-- > 0;) {
+            zend_object *next = chain[i];
+            zend_string *msg = zai_exception_message(next);
+            zend_long line = zval_get_long(zai_exception_read_property(next, ZSTR_KNOWN(ZEND_STR_LINE)));
+            zend_string *file = ddtrace_convert_to_str(zai_exception_read_property(next, ZSTR_KNOWN(ZEND_STR_FILE)));
+
+            smart_str_appends(&str, "\n\nNext ");
+            smart_str_append(&str, next->ce->name);
+            if (ZSTR_LEN(msg)) {
+                smart_str_appends(&str, ": ");
+                smart_str_append(&str, msg);
+            }
+            smart_str_appends(&str, " in ");
+            smart_str_append(&str, file);
+            smart_str_appendc(&str, ':');
+            smart_str_append_long(&str, line);
+            smart_str_appends(&str, "\nStack trace:\n");
+            zai_append_trace_without_args_from_exception(&str, next, max_frames);
+
+            zend_string_release(file);
+        }
+        smart_str_0(&str);
+        full_trace = dd_truncate_error_stack(str.s ? str.s : ZSTR_EMPTY_ALLOC());
+        dd_error_stack_cache_add(exception_root, full_trace);
+    }
+
+    if (chain != chain_buf) {
+        efree(chain);
     }
 
     // exception is now the innermost exception, i.e. what we need
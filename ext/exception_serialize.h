@@ -9,6 +9,7 @@ enum dd_exception {
     DD_EXCEPTION_UNCAUGHT,
 };
 
+void ddtrace_exception_stack_cache_clear(void);
 zend_result ddtrace_exception_to_meta(zend_object *exception, zend_string *service_name, uint64_t time, void *context, add_tag_fn_t add_meta, enum dd_exception exception_state);
 void ddtrace_create_capture_value(zval *zv, struct ddog_CaptureValue *value, const ddog_CaptureConfiguration *config, int remaining_nesting);
 
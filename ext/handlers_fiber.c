@@ -10,6 +10,20 @@
 
 static int dd_resource_handle;
 
+#if PHP_VERSION_ID >= 80200
+// Most fibers never open a span. Instead of a stack of their own they get a tagged pointer to the stack which was active
+// when they were created (holding a reference to it), and run on that stack until a span is opened within them.
+#define DD_LAZY_STACK_TAG ((uintptr_t)1)
+
+static inline bool dd_is_lazy_stack(void *stack) {
+    return ((uintptr_t)stack & DD_LAZY_STACK_TAG) != 0;
+}
+
+static inline ddtrace_span_stack *dd_lazy_stack_parent(void *stack) {
+    return (ddtrace_span_stack *)((uintptr_t)stack & ~DD_LAZY_STACK_TAG);
+}
+#endif
+
 ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
 
 // PHP-8.1 crashes hard on any bailout originating from a fiber with observers enabled. Work around it.
@@ -99,7 +113,7 @@ ZEND_TLS zend_execute_data *dd_main_execute_data;
 #endif
 
 static void dd_observe_fiber_switch(zend_fiber_context *from, zend_fiber_context *to) {
-    ddtrace_span_stack *to_stack = to->reserved[dd_resource_handle];
+    void *to_stack = to->reserved[dd_resource_handle];
 
 #if PHP_VERSION_ID < 80200
     // fiber->execute_data will not necessarily be truthful for fibers continuing another fiber, only for fully suspended fibers
@@ -112,7 +126,7 @@ static void dd_observe_fiber_switch(zend_fiber_context *from, zend_fiber_context
             dd_set_observed_frame(from->reserved[dd_resource_handle]);
         }
         if (to->status == ZEND_FIBER_STATUS_INIT) {
-            to_stack->fiber_initial_execute_data = EG(current_execute_data);
+            ((ddtrace_span_stack *)to_stack)->fiber_initial_execute_data = EG(current_execute_data);
         } else {
             to->reserved[dd_resource_handle] = EG(current_execute_data);
         }
@@ -128,11 +142,63 @@ static void dd_observe_fiber_switch(zend_fiber_context *from, zend_fiber_context
     }
 #endif
 
+#if PHP_VERSION_ID >= 80200
+    if (DDTRACE_G(lazy_stack_fiber) == from) {
+        DDTRACE_G(lazy_stack_fiber) = NULL;
+        ddtrace_span_stack *parent = dd_lazy_stack_parent(from->reserved[dd_resource_handle]);
+        if (DDTRACE_G(active_stack) == parent) {
+            // Nothing happened on the stack, the fiber keeps borrowing it. The sentinel holds its own reference.
+            GC_DELREF(&parent->std);
+        } else {
+            // The fiber switched to another stack by itself, that one is its stack now
+            OBJ_RELEASE(&parent->std);
+            from->reserved[dd_resource_handle] = DDTRACE_G(active_stack);
+        }
+    } else {
+        from->reserved[dd_resource_handle] = DDTRACE_G(active_stack);
+    }
+
+    if (dd_is_lazy_stack(to_stack)) {
+        ddtrace_span_stack *parent = dd_lazy_stack_parent(to_stack);
+        GC_ADDREF(&parent->std);
+        DDTRACE_G(active_stack) = parent;
+        DDTRACE_G(lazy_stack_fiber) = to;
+        return;
+    }
+#else
     from->reserved[dd_resource_handle] = DDTRACE_G(active_stack);
+#endif
     DDTRACE_G(active_stack) = to_stack;
 }
 
+#if PHP_VERSION_ID >= 80200
+void ddtrace_fiber_materialize_span_stack(void) {
+    zend_fiber_context *context = DDTRACE_G(lazy_stack_fiber);
+    DDTRACE_G(lazy_stack_fiber) = NULL;
+
+    ddtrace_span_stack *parent = dd_lazy_stack_parent(context->reserved[dd_resource_handle]);
+    context->reserved[dd_resource_handle] = NULL; // set again when switching away from the fiber
+
+    if (DDTRACE_G(active_stack) == parent) {
+        ddtrace_span_stack *stack = ddtrace_init_span_stack();
+        ddtrace_switch_span_stack(stack);
+        // We don't hold a direct reference to the active stack
+        GC_DELREF(&stack->std);
+    }
+
+    OBJ_RELEASE(&parent->std);
+}
+#endif
+
 static void dd_observe_fiber_init(zend_fiber_context *context) {
+#if PHP_VERSION_ID >= 80200
+    if (get_DD_TRACE_ENABLED() && DDTRACE_G(active_stack)) {
+        GC_ADDREF(&DDTRACE_G(active_stack)->std);
+        context->reserved[dd_resource_handle] = (void *)((uintptr_t)DDTRACE_G(active_stack) | DD_LAZY_STACK_TAG);
+        return;
+    }
+#endif
+
     ddtrace_span_stack *stack = get_DD_TRACE_ENABLED() ? ddtrace_init_span_stack() : ddtrace_init_root_span_stack();
     context->reserved[dd_resource_handle] = stack;
 
@@ -153,8 +219,16 @@ static void dd_observe_fiber_init(zend_fiber_context *context) {
 }
 
 static void dd_observe_fiber_destroy(zend_fiber_context *context) {
-    ddtrace_span_stack *stack = context->reserved[dd_resource_handle];
-    OBJ_RELEASE(&stack->std);
+    void *stack = context->reserved[dd_resource_handle];
+#if PHP_VERSION_ID >= 80200
+    if (dd_is_lazy_stack(stack)) {
+        if (DDTRACE_G(lazy_stack_fiber) == context) {
+            DDTRACE_G(lazy_stack_fiber) = NULL;
+        }
+        stack = dd_lazy_stack_parent(stack);
+    }
+#endif
+    OBJ_RELEASE(&((ddtrace_span_stack *)stack)->std);
 }
 
 void ddtrace_setup_fiber_observers(void) {
@@ -3,6 +3,7 @@
 #include "priority_sampling/priority_sampling.h"
 #include "tracer_tag_propagation/tracer_tag_propagation.h"
 #include "span.h"
+#include "tracer_overhead.h"
 #include <Zend/zend_smart_str.h>
 
 ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
@@ -240,5 +241,7 @@ static inline void ddtrace_inject_distributed_headers(zend_array *array, bool ke
     zend_array *inject = zai_config_is_modified(DDTRACE_CONFIG_DD_TRACE_PROPAGATION_STYLE)
                          && !zai_config_is_modified(DDTRACE_CONFIG_DD_TRACE_PROPAGATION_STYLE_INJECT)
                          ? get_DD_TRACE_PROPAGATION_STYLE() : get_DD_TRACE_PROPAGATION_STYLE_INJECT();
+    DDTRACE_OVERHEAD_START(DDTRACE_OVERHEAD_PROPAGATION);
     ddtrace_inject_distributed_headers_config(array, key_value_pairs, inject);
+    DDTRACE_OVERHEAD_END();
 }
@@ -8,6 +8,9 @@
 
 #include "../compatibility.h"
 #include "../configuration.h"
+#include "../span.h"
+#include "../tracer_overhead.h"
+#include "../zend_hrtime.h"
 #include <components/log/log.h>
 
 #define HOOK_INSTANCE 0x1
@@ -17,6 +20,7 @@
 #include <hook/hook.h>
 
 #include "uhook.h"
+#include "../integrations/integrations.h"
 #include <jit_utils/jit_blacklist.h>
 #include <exceptions/exceptions.h>
 
@@ -45,6 +49,7 @@ typedef struct {
     zend_string *function;
     zend_string *file;
     zend_object *closure;
+    dd_uhook_demotion demotion;
 } dd_uhook_def;
 
 typedef struct {
@@ -65,12 +70,15 @@ typedef struct {
     bool returns_reference;
     bool suppress_call;
     bool dis_jit_inlining_called;
+    bool demoted;
 } dd_hook_data;
 
 #define EXCEPTION_OVERRIDE_CLEAR ((zend_object *)0x1)
 
 typedef struct {
     dd_hook_data *hook_data;
+    bool demoted;
+    zend_hrtime_t demoted_start;
 } dd_uhook_dynamic;
 
 static zend_object *dd_hook_data_create(zend_class_entry *class_type) {
@@ -196,6 +204,80 @@ static bool dd_uhook_call_hook(zend_execute_data *execute_data, zend_object *clo
     return Z_TYPE(rv) != IS_FALSE;
 }
 
+static void dd_uhook_add_metric(zend_array *metrics, zend_string *key, double value) {
+    zval *existing = zend_hash_find(metrics, key);
+    if (existing) {
+        ZVAL_DOUBLE(existing, zval_get_double(existing) + value);
+    } else {
+        zval zv;
+        ZVAL_DOUBLE(&zv, value);
+        zend_hash_add_new(metrics, key, &zv);
+    }
+}
+
+void dd_uhook_demotion_init(dd_uhook_demotion *demotion) {
+    demotion->demoted = false;
+    demotion->calls = 0;
+    demotion->short_calls = 0;
+    demotion->count_metric = NULL;
+    demotion->duration_metric = NULL;
+}
+
+void dd_uhook_demotion_free(dd_uhook_demotion *demotion) {
+    if (demotion->count_metric) {
+        zend_string_release(demotion->count_metric);
+        zend_string_release(demotion->duration_metric);
+    }
+}
+
+void dd_uhook_demotion_init_metrics(dd_uhook_demotion *demotion, zend_execute_data *execute_data) {
+    if (demotion->count_metric) {
+        return;
+    }
+
+    zend_function *func = EX(func);
+    const char *name = func->common.function_name ? ZSTR_VAL(func->common.function_name) : "{main}";
+    if (func->common.scope) {
+        demotion->count_metric = zend_strpprintf(0, "_dd.demoted.%s::%s.count", ZSTR_VAL(func->common.scope->name), name);
+        demotion->duration_metric = zend_strpprintf(0, "_dd.demoted.%s::%s.duration_ns", ZSTR_VAL(func->common.scope->name), name);
+    } else {
+        demotion->count_metric = zend_strpprintf(0, "_dd.demoted.%s.count", name);
+        demotion->duration_metric = zend_strpprintf(0, "_dd.demoted.%s.duration_ns", name);
+    }
+}
+
+// The median is below the floor exactly when more than half of the spans were shorter than it
+void dd_uhook_demotion_track(dd_uhook_demotion *demotion, zend_execute_data *execute_data, ddtrace_span_data *span) {
+    zend_long threshold = get_DD_TRACE_HOOK_DEMOTION_CALLS();
+    if (threshold <= 0 || demotion->demoted) {
+        return;
+    }
+
+    ++demotion->calls;
+    if (span->duration < (uint64_t)get_DD_TRACE_HOOK_DEMOTION_MAX_DURATION() * 1000) {
+        ++demotion->short_calls;
+    }
+
+    if (demotion->calls < threshold || demotion->short_calls * 2 <= demotion->calls) {
+        return;
+    }
+
+    demotion->demoted = true;
+    dd_uhook_demotion_init_metrics(demotion, execute_data);
+
+    LOG(HOOK_TRACE, "Demoting the hook producing %s after %" PRIu32 " calls, %" PRIu32 " of which were shorter than %" PRId64 " microseconds",
+        ZSTR_VAL(demotion->count_metric), demotion->calls, demotion->short_calls, (int64_t)get_DD_TRACE_HOOK_DEMOTION_MAX_DURATION());
+}
+
+void dd_uhook_demotion_report(dd_uhook_demotion *demotion, uint64_t start) {
+    ddtrace_span_data *parent = ddtrace_active_span();
+    if (parent) {
+        zend_array *metrics = ddtrace_property_array(&parent->property_metrics);
+        dd_uhook_add_metric(metrics, demotion->count_metric, 1);
+        dd_uhook_add_metric(metrics, demotion->duration_metric, (double)(zend_hrtime() - start));
+    }
+}
+
 bool ddtrace_uhook_match_filepath(zend_string *file, zend_string *source) {
     if (ZSTR_LEN(source) == 0) {
         return true; // empty path is wildcard
@@ -251,10 +333,11 @@ void dd_uhook_log_invocation(void (*log)(const char *, ...), zend_execute_data *
         EX(func)->common.function_name ? ZSTR_VAL(EX(func)->op_array.function_name) : (EX(func)->op_array.filename ? "<unnamed>" : ZSTR_VAL(EX(func)->op_array.filename)));
 }
 
-static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
+static bool dd_uhook_begin_impl(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
     dd_uhook_def *def = auxiliary;
     dd_uhook_dynamic *dyn = dynamic;
 
+    dyn->demoted = false;
     if (def->file && (!execute_data->func->op_array.filename || !ddtrace_uhook_match_filepath(execute_data->func->op_array.filename, def->file))) {
         dyn->hook_data = NULL;
         return true;
@@ -266,6 +349,11 @@ static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_dat
     }
 
     dyn->hook_data = (dd_hook_data *)dd_hook_data_create(ddtrace_hook_data_ce);
+    // The closures of a demoted hook may do more than tracing, so they still run, only without a span. Generators are never demoted
+    if (def->demotion.demoted && !(EX(func)->common.fn_flags & ZEND_ACC_GENERATOR)) {
+        dyn->hook_data->demoted = true;
+        dyn->demoted = true;
+    }
     dyn->hook_data->returns_reference = execute_data->func->common.fn_flags & ZEND_ACC_RETURN_REFERENCE;
     dyn->hook_data->vm_stack_top = EG(vm_stack_top);
     dyn->hook_data->running_ptr = &def->running;
@@ -356,10 +444,21 @@ static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_dat
         }
     }
 
+    if (dyn->demoted) {
+        dyn->demoted_start = zend_hrtime();
+    }
+
     return true;
 }
 
-static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
+static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
+    volatile bool result;
+    DDTRACE_OVERHEAD_MEASURE_USER_CODE(DDTRACE_OVERHEAD_HOOKS,
+        result = dd_uhook_begin_impl(invocation, execute_data, auxiliary, dynamic));
+    return result;
+}
+
+static void dd_uhook_end_impl(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
     dd_uhook_def *def = auxiliary;
     dd_uhook_dynamic *dyn = dynamic;
 
@@ -367,6 +466,10 @@ static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data,
         return;
     }
 
+    if (dyn->demoted) {
+        dd_uhook_demotion_report(&def->demotion, dyn->demoted_start);
+    }
+
     ddtrace_span_data *span = dyn->hook_data->span;
     if (span && span->duration != DDTRACE_DROPPED_SPAN && span->duration != DDTRACE_SILENTLY_DROPPED_SPAN) {
         zval *exception_zv = &span->property_exception;
@@ -375,6 +478,10 @@ static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data,
         }
 
         dd_trace_stop_span_time(span);
+        // Only spans opened before the end closure runs are counted
+        if (span->start) {
+            dd_uhook_demotion_track(&def->demotion, execute_data, span);
+        }
     }
 
     bool keep_span = true;
@@ -467,6 +574,11 @@ static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data,
     OBJ_RELEASE(&dyn->hook_data->std);
 }
 
+static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
+    DDTRACE_OVERHEAD_MEASURE_USER_CODE(DDTRACE_OVERHEAD_HOOKS,
+        dd_uhook_end_impl(invocation, execute_data, retval, auxiliary, dynamic));
+}
+
 static void dd_uhook_dtor(void *data) {
     dd_uhook_def *def = data;
     if (def->begin) {
@@ -475,6 +587,7 @@ static void dd_uhook_dtor(void *data) {
     if (def->end) {
         OBJ_RELEASE(def->end);
     }
+    dd_uhook_demotion_free(&def->demotion);
     if (def->function) {
         zend_string_release(def->function);
         if (def->scope) {
@@ -502,6 +615,12 @@ PHP_FUNCTION(DDTrace_install_hook) {
     zend_fcall_info_cache fcc;
     zend_long flags = 0;
 
+#ifdef DDTRACE_INTEGRATION_REPLAY
+    if (UNEXPECTED(ddtrace_integration_recording)) {
+        ddtrace_integration_record_hook_call(execute_data);
+    }
+#endif
+
     ZEND_PARSE_PARAMETERS_START(1, 4)
         DD_PARAM_PROLOGUE(0, 0);
         if (Z_TYPE_P(_arg) == IS_STRING) {
@@ -565,6 +684,7 @@ type_error:
     dd_uhook_def *def = emalloc(sizeof(*def));
     def->closure = NULL;
     def->running = false;
+    dd_uhook_demotion_init(&def->demotion);
     def->begin = begin ? Z_OBJ_P(begin) : NULL;
     if (def->begin) {
         GC_ADDREF(def->begin);
@@ -721,6 +841,14 @@ PHP_FUNCTION(DDTrace_remove_hook) {
 
     zend_long id;
     zend_string *location = NULL;
+
+#ifdef DDTRACE_INTEGRATION_REPLAY
+    if (UNEXPECTED(ddtrace_integration_recording)) {
+        // Hook ids differ on replay
+        ddtrace_integration_abort_recording();
+    }
+#endif
+
     ZEND_PARSE_PARAMETERS_START(1, 2)
         Z_PARAM_LONG(id)
         Z_PARAM_OPTIONAL
@@ -808,12 +936,15 @@ void dd_uhook_span(INTERNAL_FUNCTION_PARAMETERS, bool unlimited) {
     }
 
     // pre-hook check
-    if (!hookData->execute_data || (!unlimited && ddtrace_tracer_is_limited()) || !get_DD_TRACE_ENABLED()) {
+    if (!hookData->execute_data || (!unlimited && (hookData->demoted || ddtrace_tracer_is_limited())) || !get_DD_TRACE_ENABLED()) {
         // dummy span, which never gets pushed
         hookData->span = ddtrace_init_dummy_span();
         RETURN_OBJ_COPY(&hookData->span->std);
     }
 
+    // The prior stack must not be the one borrowed from the parent fiber
+    ddtrace_ensure_fiber_span_stack();
+
     // By this functionality we provide the ability to also switch the stack automatically back when the span attached to the function is closed
     if (stack) {
         ddtrace_span_data *span = zend_hash_index_find_ptr(&DDTRACE_G(traced_spans), hookData->invocation);
@@ -9,6 +9,29 @@ void dd_uhook_report_sandbox_error(zend_execute_data *execute_data, zend_object
 void dd_uhook_log_invocation(void (*log)(const char *, ...), zend_execute_data *execute_data, const char *type, zend_object *closure);
 bool ddtrace_uhook_match_filepath(zend_string *file, zend_string *source);
 
+struct ddtrace_span_data;
+
+/* Shared by install_hook() and the legacy tracing hooks: a hook which keeps producing spans whose median duration is
+ * below DD_TRACE_HOOK_DEMOTION_MAX_DURATION is demoted for the rest of the request once it has been called
+ * DD_TRACE_HOOK_DEMOTION_CALLS times. Demoted legacy tracing hooks stop running, as they only trace; demoted
+ * install_hook() closures still run, but HookData::span() gives them a dummy span. The counters live in the hook
+ * definition, which is per request. */
+typedef struct {
+    bool demoted;
+    // Spans of this hook in the current request, and how many of them were shorter than DD_TRACE_HOOK_DEMOTION_MAX_DURATION
+    uint32_t calls;
+    uint32_t short_calls;
+    zend_string *count_metric;
+    zend_string *duration_metric;
+} dd_uhook_demotion;
+
+void dd_uhook_demotion_init(dd_uhook_demotion *demotion);
+void dd_uhook_demotion_free(dd_uhook_demotion *demotion);
+void dd_uhook_demotion_init_metrics(dd_uhook_demotion *demotion, zend_execute_data *execute_data);
+void dd_uhook_demotion_track(dd_uhook_demotion *demotion, zend_execute_data *execute_data, struct ddtrace_span_data *span);
+// Demoted calls only report their count and total time on the span they would have been a child of
+void dd_uhook_demotion_report(dd_uhook_demotion *demotion, uint64_t start);
+
 void zai_uhook_rinit();
 void zai_uhook_rshutdown();
 void zai_uhook_minit(int module_number);
@@ -8,6 +8,8 @@
 
 #include <hook/hook.h>
 
+ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
+
 zend_class_entry *ddtrace_hook_attribute_ce;
 static zend_string *dd_hook_attribute_lcname;
 
@@ -116,6 +118,7 @@ static void dd_fill_span_data(dd_uhook_def *def, ddtrace_span_data *span) {
         zval *service = &span->property_service;
         zval_ptr_dtor(service);
         ZVAL_STR_COPY(service, def->service);
+        ++DDTRACE_G(span_properties_generation);
     }
     if (def->type) {
         zval *type = &span->property_type;
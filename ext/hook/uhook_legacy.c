@@ -3,7 +3,10 @@
 #include <hook/hook.h>
 #include "uhook.h"
 #include "../configuration.h"
+#include "../integrations/integrations.h"
 #include "../span.h"
+#include "../tracer_overhead.h"
+#include "../zend_hrtime.h"
 #include <sandbox/sandbox.h>
 
 #include <components/log/log.h>
@@ -17,6 +20,7 @@ typedef struct {
     bool run_if_limited;
     bool active;
     bool allow_recursion;
+    dd_uhook_demotion demotion;
 } dd_uhook_def;
 
 typedef struct {
@@ -25,6 +29,8 @@ typedef struct {
     bool skipped;
     bool dropped_span;
     bool was_primed;
+    bool demoted;
+    zend_ulong demoted_start;
 } dd_uhook_dynamic;
 
 static bool dd_uhook_call(zend_object *closure, bool tracing, dd_uhook_dynamic *dyn, zend_execute_data *execute_data, zval *retval) {
@@ -90,11 +96,25 @@ static bool dd_uhook_call(zend_object *closure, bool tracing, dd_uhook_dynamic *
     return Z_TYPE(rv) != IS_FALSE;
 }
 
-static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
+// Demoted hooks only report their call count and total time on the span they would have been a child of
+static void dd_uhook_end_demoted(dd_uhook_def *def, dd_uhook_dynamic *dyn) {
+    dd_uhook_demotion_report(&def->demotion, dyn->demoted_start);
+    def->active = false;
+}
+
+static bool dd_uhook_begin_impl(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
     dd_uhook_def *def = auxiliary;
     dd_uhook_dynamic *dyn = dynamic;
 
-    if ((!def->run_if_limited && ddtrace_tracer_is_limited()) || (def->active && !def->allow_recursion) || !get_DD_TRACE_ENABLED()) {
+    if ((def->active && !def->allow_recursion) || !get_DD_TRACE_ENABLED()) {
+        dyn->skipped = true;
+        return true;
+    }
+
+    // Only tracing hooks may be limited. With DD_TRACE_AGGREGATE_WHEN_LIMITED they are aggregated like demoted hooks
+    bool is_generator = EX(func)->common.fn_flags & ZEND_ACC_GENERATOR;
+    bool limited = !def->run_if_limited && ddtrace_tracer_is_limited();
+    if (limited && (is_generator || !get_DD_TRACE_AGGREGATE_WHEN_LIMITED())) {
         dyn->skipped = true;
         return true;
     }
@@ -103,6 +123,14 @@ static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_dat
     dyn->skipped = false;
     dyn->was_primed = false;
     dyn->dropped_span = false;
+
+    dyn->demoted = limited || (def->demotion.demoted && !is_generator);
+    if (dyn->demoted) {
+        dd_uhook_demotion_init_metrics(&def->demotion, execute_data);
+        dyn->demoted_start = zend_hrtime();
+        return true;
+    }
+
     dyn->args = dd_uhook_collect_args(execute_data);
 
     if (def->tracing) {
@@ -190,7 +218,14 @@ static void dd_uhook_generator_yield(zend_ulong invocation, zend_execute_data *e
     }
 }
 
-static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
+static bool dd_uhook_begin(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
+    volatile bool result;
+    DDTRACE_OVERHEAD_MEASURE_USER_CODE(DDTRACE_OVERHEAD_HOOKS,
+        result = dd_uhook_begin_impl(invocation, execute_data, auxiliary, dynamic));
+    return result;
+}
+
+static void dd_uhook_end_impl(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
     dd_uhook_def *def = auxiliary;
     dd_uhook_dynamic *dyn = dynamic;
     bool keep_span = true;
@@ -199,6 +234,11 @@ static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data,
         return;
     }
 
+    if (dyn->demoted) {
+        dd_uhook_end_demoted(def, dyn);
+        return;
+    }
+
     if (def->tracing && !dyn->dropped_span) {
         if (dyn->span->duration == DDTRACE_DROPPED_SPAN) {
             dyn->dropped_span = true;
@@ -214,6 +254,7 @@ static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data,
             }
 
             dd_trace_stop_span_time(dyn->span);
+            dd_uhook_demotion_track(&def->demotion, execute_data, dyn->span);
         }
     }
 
@@ -244,6 +285,11 @@ static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data,
     def->active = false;
 }
 
+static void dd_uhook_end(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
+    DDTRACE_OVERHEAD_MEASURE_USER_CODE(DDTRACE_OVERHEAD_HOOKS,
+        dd_uhook_end_impl(invocation, execute_data, retval, auxiliary, dynamic));
+}
+
 static void dd_uhook_dtor(void *data) {
     dd_uhook_def *def = data;
     if (def->begin) {
@@ -252,6 +298,7 @@ static void dd_uhook_dtor(void *data) {
     if (def->end) {
         OBJ_RELEASE(def->end);
     }
+    dd_uhook_demotion_free(&def->demotion);
     efree(def);
 }
 
@@ -309,6 +356,12 @@ static void dd_uhook(INTERNAL_FUNCTION_PARAMETERS, bool tracing, bool method) {
     zval *prehook = NULL, *posthook = NULL, *config_array = NULL;
     bool run_when_limited = false, allow_recursion = false;
 
+#ifdef DDTRACE_INTEGRATION_REPLAY
+    if (UNEXPECTED(ddtrace_integration_recording)) {
+        ddtrace_integration_record_hook_call(execute_data);
+    }
+#endif
+
     ZEND_PARSE_PARAMETERS_START(1 + method, 2 + method + !tracing)
         // clang-format off
         if (method) {
@@ -359,6 +412,7 @@ static void dd_uhook(INTERNAL_FUNCTION_PARAMETERS, bool tracing, bool method) {
     def->run_if_limited = !tracing || run_when_limited;
     def->active = false;
     def->allow_recursion = allow_recursion;
+    dd_uhook_demotion_init(&def->demotion);
 
     zai_str class_str = ZAI_STR_EMPTY;
     if (method) {
@@ -4,6 +4,7 @@
 #include "../telemetry.h"
 #include <components/log/log.h>
 #include <exceptions/exceptions.h>
+#include <zend_closures.h>
 #include <hook/hook.h>
 #include <sandbox/sandbox.h>
 #undef INTEGRATION
@@ -51,12 +52,367 @@ typedef struct {
     zai_str scope;
     zai_str function;
     zend_long id;
+#ifdef DDTRACE_INTEGRATION_REPLAY
+    HashTable *recorded_calls;
+    bool replay_unsupported;
+#endif
 } dd_integration_aux;
 
+#ifdef DDTRACE_INTEGRATION_REPLAY
+static void dd_recorded_calls_free(HashTable *calls);
+#endif
+
 void dd_integration_aux_free(void *auxiliary) {
+#ifdef DDTRACE_INTEGRATION_REPLAY
+    dd_integration_aux *aux = auxiliary;
+    if (aux->recorded_calls) {
+        dd_recorded_calls_free(aux->recorded_calls);
+    }
+#endif
     free(auxiliary);
 }
 
+#ifdef DDTRACE_INTEGRATION_REPLAY
+/* Most of the cost of a deferred integration is its init() building closures and calling DDTrace\install_hook & co.
+ * While an init() runs we record the calls to these functions. Arguments are copied into persistent memory, with
+ * closures stored as IS_PTR to the op_array they were created from. This is only done when that op_array is immutable
+ * (i.e. lives in opcache shared memory) and the closure has no use/static variables and is either static or bound to
+ * the integration instance init() runs on: anything else cannot be recreated without running init(). The bundled
+ * integrations fetch their instance through Integration::get() for that reason. Replaying just creates a new
+ * instance, recreates the closures and calls the recorded functions again. */
+typedef struct {
+    zend_function *func;
+    uint32_t num_args;
+    zval args[];
+} dd_integration_recorded_call;
+
+typedef struct {
+    zend_op_array *def;
+    bool bound;  // to the integration instance
+} dd_integration_recorded_closure;
+
+bool ddtrace_integration_recording;
+static bool dd_recording_failed;
+static HashTable *dd_recording_calls;
+static zend_class_entry *dd_recording_ce;
+static zend_object *dd_recording_this;
+static uint32_t dd_recording_modified_ini;
+
+static void dd_recorded_arg_dtor(zval *zv) {
+    if (Z_TYPE_P(zv) == IS_STRING) {
+        zend_string_release(Z_STR_P(zv));
+    } else if (Z_TYPE_P(zv) == IS_ARRAY) {
+        zend_hash_destroy(Z_ARR_P(zv));
+        pefree(Z_ARR_P(zv), 1);
+    } else if (Z_TYPE_P(zv) == IS_PTR) {
+        pefree(Z_PTR_P(zv), 1);
+    }
+}
+
+static void dd_recorded_call_dtor(zval *zv) {
+    dd_integration_recorded_call *call = Z_PTR_P(zv);
+    for (uint32_t i = 0; i < call->num_args; ++i) {
+        dd_recorded_arg_dtor(&call->args[i]);
+    }
+    pefree(call, 1);
+}
+
+static void dd_recorded_calls_free(HashTable *calls) {
+    zend_hash_destroy(calls);
+    pefree(calls, 1);
+}
+
+// Closures are looked up by their opcodes at record time and by identity at replay time. The op_array pointer is
+// only trusted once it is found again within the freshly looked up class, so that an opcache restart is harmless.
+static zend_op_array *dd_find_dynamic_func_def(zend_op_array *op_array, const zend_op_array *target, const zend_op *opcodes) {
+    for (uint32_t i = 0; i < op_array->num_dynamic_func_defs; ++i) {
+        zend_op_array *def = op_array->dynamic_func_defs[i];
+        if (def == target || def->opcodes == opcodes) {
+            return def;
+        }
+        if ((def = dd_find_dynamic_func_def(def, target, opcodes))) {
+            return def;
+        }
+    }
+    return NULL;
+}
+
+static zend_op_array *dd_find_closure_def(zend_class_entry *ce, const zend_op_array *target, const zend_op *opcodes) {
+    zend_function *method;
+    ZEND_HASH_FOREACH_PTR(&ce->function_table, method) {
+        if (method->type == ZEND_USER_FUNCTION) {
+            zend_op_array *def = dd_find_dynamic_func_def(&method->op_array, target, opcodes);
+            if (def) {
+                return def;
+            }
+        }
+    } ZEND_HASH_FOREACH_END();
+    return NULL;
+}
+
+// dst is always left destructible, also on failure
+static bool dd_persist_recorded_arg(zval *dst, zval *src) {
+    ZVAL_DEREF(src);
+    switch (Z_TYPE_P(src)) {
+        case IS_NULL:
+        case IS_FALSE:
+        case IS_TRUE:
+        case IS_LONG:
+        case IS_DOUBLE:
+            ZVAL_COPY_VALUE(dst, src);
+            return true;
+
+        case IS_STRING:
+            ZVAL_STR(dst, zend_string_init(Z_STRVAL_P(src), Z_STRLEN_P(src), 1));
+            return true;
+
+        case IS_ARRAY: {
+            HashTable *ht = pemalloc(sizeof(*ht), 1);
+            zend_hash_init(ht, zend_hash_num_elements(Z_ARR_P(src)), NULL, dd_recorded_arg_dtor, 1);
+            ZVAL_ARR(dst, ht);
+
+            zend_string *key;
+            zend_ulong idx;
+            zval *val;
+            ZEND_HASH_FOREACH_KEY_VAL(Z_ARR_P(src), idx, key, val) {
+                zval copy;
+                bool persisted = dd_persist_recorded_arg(&copy, val);
+                if (key) {
+                    zend_string *persistent_key = zend_string_init(ZSTR_VAL(key), ZSTR_LEN(key), 1);
+                    zend_hash_add_new(ht, persistent_key, &copy);
+                    zend_string_release(persistent_key);
+                } else {
+                    zend_hash_index_add_new(ht, idx, &copy);
+                }
+                if (!persisted) {
+                    return false;
+                }
+            } ZEND_HASH_FOREACH_END();
+            return true;
+        }
+
+        case IS_OBJECT:
+            if (Z_OBJCE_P(src) == zend_ce_closure) {
+                const zend_function *func = zend_get_closure_method_def(Z_OBJ_P(src));
+                zval *closure_this = zend_get_closure_this_ptr(src);
+                bool bound = Z_TYPE_P(closure_this) == IS_OBJECT;
+                if (func->type != ZEND_USER_FUNCTION || (func->common.fn_flags & ZEND_ACC_FAKE_CLOSURE)
+                    || func->op_array.static_variables || (bound && Z_OBJ_P(closure_this) != dd_recording_this)) {
+                    break;
+                }
+                zend_op_array *def = dd_find_closure_def(dd_recording_ce, NULL, func->op_array.opcodes);
+                if (!def || !(def->fn_flags & ZEND_ACC_IMMUTABLE)) {
+                    break;
+                }
+                dd_integration_recorded_closure *closure = pemalloc(sizeof(*closure), 1);
+                closure->def = def;
+                closure->bound = bound;
+                ZVAL_PTR(dst, closure);
+                return true;
+            }
+            break;
+    }
+
+    ZVAL_NULL(dst);
+    return false;
+}
+
+void ddtrace_integration_abort_recording(void) {
+    dd_recording_failed = true;
+}
+
+void ddtrace_integration_record_hook_call(zend_execute_data *execute_data) {
+    if (dd_recording_failed) {
+        return;
+    }
+    if (ZEND_CALL_INFO(execute_data) & ZEND_CALL_HAS_EXTRA_NAMED_PARAMS) {
+        dd_recording_failed = true;
+        return;
+    }
+
+    uint32_t num_args = ZEND_NUM_ARGS();
+    dd_integration_recorded_call *call = pemalloc(sizeof(*call) + num_args * sizeof(zval), 1);
+    call->func = EX(func);
+    call->num_args = num_args;
+    for (uint32_t i = 0; i < num_args; ++i) {
+        if (!dd_persist_recorded_arg(&call->args[i], ZEND_CALL_ARG(execute_data, i + 1))) {
+            dd_recording_failed = true;
+        }
+    }
+    zend_hash_next_index_insert_ptr(dd_recording_calls, call);
+}
+
+static uint32_t dd_modified_ini_count(void) {
+    return EG(modified_ini_directives) ? zend_hash_num_elements(EG(modified_ini_directives)) : 0;
+}
+
+static bool dd_start_recording(dd_integration_aux *aux, zend_class_entry *ce, zend_object *integration) {
+    if (!get_DD_TRACE_REPLAY_INTEGRATION_INIT() || aux->replay_unsupported || !(ce->ce_flags & ZEND_ACC_IMMUTABLE)) {
+        return false;
+    }
+    if (ddtrace_integration_recording) {
+        // An integration loaded from within another init(): the outer recording would replay both
+        dd_recording_failed = true;
+        return false;
+    }
+
+    // init() is invoked with the hooked object, which it must not depend on
+    zend_function *init = zend_hash_str_find_ptr_lc(&ce->function_table, ZEND_STRL("init"));
+    if (!init || init->common.num_args || (init->common.fn_flags & ZEND_ACC_VARIADIC)) {
+        aux->replay_unsupported = true;
+        return false;
+    }
+
+    dd_recording_calls = pemalloc(sizeof(*dd_recording_calls), 1);
+    zend_hash_init(dd_recording_calls, 8, NULL, dd_recorded_call_dtor, 1);
+    dd_recording_ce = ce;
+    dd_recording_this = integration;
+    dd_recording_modified_ini = dd_modified_ini_count();
+    dd_recording_failed = false;
+    ddtrace_integration_recording = true;
+    return true;
+}
+
+// Replay only installs the hooks again, on a fresh instance: init() must not have done anything else to be replayable
+static void dd_check_recorded_side_effects(zend_object *integration) {
+    if (dd_modified_ini_count() != dd_recording_modified_ini) {
+        dd_recording_failed = true;
+        return;
+    }
+
+    zend_class_entry *ce = integration->ce;
+    if (integration->properties && zend_hash_num_elements(integration->properties) > (uint32_t)ce->default_properties_count) {
+        dd_recording_failed = true;
+        return;
+    }
+
+    zval *defaults = CE_DEFAULT_PROPERTIES_TABLE(ce);
+    for (int i = 0; i < ce->default_properties_count; ++i) {
+        zval *prop = OBJ_PROP_NUM(integration, i), *def = &defaults[i];
+        ZVAL_DEREF(prop);
+        if (Z_TYPE_P(prop) == IS_UNDEF ? Z_TYPE_P(def) != IS_UNDEF : !zend_is_identical(prop, def)) {
+            dd_recording_failed = true;
+            return;
+        }
+    }
+}
+
+static void dd_stop_recording(dd_integration_aux *aux, bool loaded) {
+    ddtrace_integration_recording = false;
+    dd_recording_ce = NULL;
+    dd_recording_this = NULL;
+
+    if (loaded && !dd_recording_failed) {
+        aux->recorded_calls = dd_recording_calls;
+        LOG(DEBUG, "Recorded %" PRIu32 " hooks installed by integration %s", zend_hash_num_elements(dd_recording_calls), ZSTR_VAL(aux->classname));
+    } else {
+        if (loaded) {
+            LOG(DEBUG, "Integration %s installs hooks which cannot be replayed, init() will run in every request", ZSTR_VAL(aux->classname));
+            aux->replay_unsupported = true;
+        }
+        dd_recorded_calls_free(dd_recording_calls);
+    }
+    dd_recording_calls = NULL;
+}
+
+static bool dd_materialize_recorded_arg(zval *dst, zval *src, zend_class_entry *ce, zval *integration) {
+    switch (Z_TYPE_P(src)) {
+        case IS_STRING:
+            ZVAL_STRINGL(dst, Z_STRVAL_P(src), Z_STRLEN_P(src));
+            return true;
+
+        case IS_ARRAY: {
+            array_init_size(dst, zend_hash_num_elements(Z_ARR_P(src)));
+
+            zend_string *key;
+            zend_ulong idx;
+            zval *val;
+            ZEND_HASH_FOREACH_KEY_VAL(Z_ARR_P(src), idx, key, val) {
+                zval copy;
+                if (!dd_materialize_recorded_arg(&copy, val, ce, integration)) {
+                    zval_ptr_dtor(dst);
+                    return false;
+                }
+                if (key) {
+                    zend_hash_str_add_new(Z_ARR_P(dst), ZSTR_VAL(key), ZSTR_LEN(key), &copy);
+                } else {
+                    zend_hash_index_add_new(Z_ARR_P(dst), idx, &copy);
+                }
+            } ZEND_HASH_FOREACH_END();
+            return true;
+        }
+
+        case IS_PTR: {
+            dd_integration_recorded_closure *closure = Z_PTR_P(src);
+            zend_op_array *def = dd_find_closure_def(ce, closure->def, NULL);
+            if (!def) {
+                return false;
+            }
+            zend_create_closure(dst, (zend_function *)def, def->scope, ce, closure->bound ? integration : NULL);
+            return true;
+        }
+
+        default:
+            ZVAL_COPY_VALUE(dst, src);
+            return true;
+    }
+}
+
+// All closures are recreated before anything is installed, so that a stale recording does not leave half of the hooks
+static bool dd_replay_recorded_calls(dd_integration_aux *aux, zend_class_entry *ce, zval *integration) {
+    HashTable *calls = aux->recorded_calls;
+    uint32_t total_args = 0;
+    dd_integration_recorded_call *call;
+    ZEND_HASH_FOREACH_PTR(calls, call) {
+        total_args += call->num_args;
+    } ZEND_HASH_FOREACH_END();
+
+    zval *args = safe_emalloc(total_args, sizeof(zval), 0), *arg = args;
+    bool valid = true;
+    ZEND_HASH_FOREACH_PTR(calls, call) {
+        for (uint32_t i = 0; valid && i < call->num_args; ++i, ++arg) {
+            valid = dd_materialize_recorded_arg(arg, &call->args[i], ce, integration);
+        }
+    } ZEND_HASH_FOREACH_END();
+
+    if (!valid) {
+        // The last argument failed and was not materialized
+        for (zval *cur = args; cur < arg - 1; ++cur) {
+            zval_ptr_dtor(cur);
+        }
+        efree(args);
+
+        LOG(DEBUG, "Recorded hooks of integration %s are stale, running init() again", ZSTR_VAL(aux->classname));
+        dd_recorded_calls_free(aux->recorded_calls);
+        aux->recorded_calls = NULL;
+        return false;
+    }
+
+    arg = args;
+    ZEND_HASH_FOREACH_PTR(calls, call) {
+        zval rv;
+        zend_fcall_info fci = empty_fcall_info;
+        zend_fcall_info_cache fcc = empty_fcall_info_cache;
+        fci.size = sizeof(fci);
+        fci.retval = &rv;
+        fci.params = arg;
+        fci.param_count = call->num_args;
+        fcc.function_handler = call->func;
+        if (zend_call_function(&fci, &fcc) == SUCCESS) {
+            zval_ptr_dtor(&rv);
+        }
+        arg += call->num_args;
+    } ZEND_HASH_FOREACH_END();
+
+    for (arg = args; arg < args + total_args; ++arg) {
+        zval_ptr_dtor(arg);
+    }
+    efree(args);
+
+    return !EG(exception);
+}
+#endif
+
 #if PHP_VERSION_ID < 80000
 #define LAST_ERROR_STRING PG(last_error_message)
 #else
@@ -88,6 +444,9 @@ static void dd_invoke_integration_loader_and_unhook_posthook(zend_ulong invocati
         zai_sandbox sandbox;
         zai_sandbox_open(&sandbox);
         bool success = false;
+#ifdef DDTRACE_INTEGRATION_REPLAY
+        volatile bool recording = false, loaded = false;
+#endif
         zend_try {
             do {
                 zend_class_entry *ce = zend_lookup_class(aux->classname);
@@ -108,6 +467,23 @@ static void dd_invoke_integration_loader_and_unhook_posthook(zend_ulong invocati
                     break;
                 }
 
+#ifdef DDTRACE_INTEGRATION_REPLAY
+                if (aux->recorded_calls && get_DD_TRACE_REPLAY_INTEGRATION_INIT()) {
+                    if (dd_replay_recorded_calls(aux, ce, &obj)) {
+                        zval_ptr_dtor(&obj);
+                        LOG(DEBUG, "Loaded integration %s from recorded hooks", ZSTR_VAL(aux->classname));
+                        success = true;
+                        break;
+                    }
+                    if (EG(exception)) {
+                        zval_ptr_dtor(&obj);
+                        break;
+                    }
+                }
+
+                recording = dd_start_recording(aux, ce, Z_OBJ(obj));
+#endif
+
                 zval rv;
                 zval *thisp = getThis();
                 if (thisp) {
@@ -116,6 +492,13 @@ static void dd_invoke_integration_loader_and_unhook_posthook(zend_ulong invocati
                     success = zai_symbol_call_named(ZAI_SYMBOL_SCOPE_OBJECT, &obj, &(zai_str) ZAI_STRL("init"), &rv, 0 | ZAI_SYMBOL_SANDBOX, &sandbox);
                 }
 
+#ifdef DDTRACE_INTEGRATION_REPLAY
+                loaded = success && !PG(last_error_message) && Z_TYPE(rv) == IS_LONG && Z_LVAL(rv) == DD_TRACE_INTEGRATION_LOADED;
+                if (recording && loaded) {
+                    dd_check_recorded_side_effects(Z_OBJ(obj));
+                }
+#endif
+
                 zval_ptr_dtor(&obj);
 
                 if (success && get_DD_TRACE_ENABLED()) {
@@ -138,6 +521,11 @@ static void dd_invoke_integration_loader_and_unhook_posthook(zend_ulong invocati
             } while (0);
         } zend_catch {
         } zend_end_try();
+#ifdef DDTRACE_INTEGRATION_REPLAY
+        if (recording) {
+            dd_stop_recording(aux, loaded);
+        }
+#endif
         if ((!success || PG(last_error_message)) && get_DD_TRACE_ENABLED()) {
             LOGEV(WARN, {
                 zend_object *ex = EG(exception);
@@ -182,6 +570,10 @@ static void dd_hook_method_and_unhook_on_first_call(zai_str Class, zai_str metho
             0);
     aux->scope = Class;
     aux->function = method;
+#ifdef DDTRACE_INTEGRATION_REPLAY
+    aux->recorded_calls = NULL;
+    aux->replay_unsupported = false;
+#endif
 
     if (name != -1u) {
         void **auxArray = ddtrace_integrations[name].aux;
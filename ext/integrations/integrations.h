@@ -74,6 +74,14 @@ extern size_t ddtrace_integrations_len;
 void ddtrace_integrations_minit(void);
 void ddtrace_integrations_mshutdown(void);
 
+#if PHP_VERSION_ID >= 80100 && !defined(ZTS)
+// The hooks installed by a deferred integration's init() are recorded once per process and replayed in later requests
+#define DDTRACE_INTEGRATION_REPLAY 1
+extern bool ddtrace_integration_recording;
+void ddtrace_integration_record_hook_call(zend_execute_data *execute_data);
+void ddtrace_integration_abort_recording(void);
+#endif
+
 ddtrace_integration *ddtrace_get_integration_from_string(ddtrace_string integration);
 
 #endif  // DD_INTEGRATIONS_INTEGRATIONS_H
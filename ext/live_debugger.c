@@ -108,10 +108,28 @@ typedef struct {
     zend_string *scope;
     zend_string *file;
     zend_string *probe_id;
+    // Last file matched against def->file, holding a reference so that the pointer cannot be reused
+    zend_string *checked_file;
+    bool file_matches;
 } dd_probe_def;
 
 static bool dd_probe_file_mismatch(dd_probe_def *def, zend_execute_data *execute_data) {
-    return def->file && (!execute_data->func->op_array.filename || !ddtrace_uhook_match_filepath(execute_data->func->op_array.filename, def->file));
+    if (!def->file) {
+        return false;
+    }
+    if (!ZEND_USER_CODE(execute_data->func->type) || !execute_data->func->op_array.filename) {
+        return true;
+    }
+
+    zend_string *filename = execute_data->func->op_array.filename;
+    if (filename != def->checked_file) {
+        if (def->checked_file) {
+            zend_string_release(def->checked_file);
+        }
+        def->checked_file = zend_string_copy(filename);
+        def->file_matches = ddtrace_uhook_match_filepath(filename, def->file);
+    }
+    return !def->file_matches;
 }
 
 static void dd_probe_dtor(void *data) {
@@ -122,6 +140,9 @@ static void dd_probe_dtor(void *data) {
     if (def->file) {
         zend_string_release(def->file);
     }
+    if (def->checked_file) {
+        zend_string_release(def->checked_file);
+    }
     if (def->scope) {
         zend_string_release(def->scope);
     }
@@ -148,6 +169,8 @@ static int64_t dd_init_live_debugger_probe(const ddog_Probe *probe, dd_probe_def
     def->probe = *probe;
     def->probe_id = dd_CharSlice_to_zend_string(probe->id);
     def->file = NULL;
+    def->checked_file = NULL;
+    def->file_matches = false;
     def->function = NULL;
     def->scope = NULL;
 
@@ -383,19 +406,35 @@ static void dd_log_probe_ensure_payload(dd_log_probe_dyn *dyn, dd_log_probe_def
 static void dd_log_probe_capture_snapshot(ddog_DebuggerCapture *capture, dd_log_probe_def *def, zend_execute_data *execute_data) {
     const ddog_CaptureConfiguration *capture_config = def->parent.probe.probe.log.capture;
     if (ZEND_USER_CODE(EX(func)->type)) {
-        zend_array *symbol_table = zend_rebuild_symbol_table();
-        zend_string *symbol;
-        zval *variable;
-        ZEND_HASH_FOREACH_STR_KEY_VAL_IND(symbol_table, symbol, variable) {
-            if (symbol) {
-                struct ddog_CaptureValue capture_value = {0};
-                ddog_CharSlice name_slice = dd_zend_string_to_CharSlice(symbol);
-                ddtrace_snapshot_redacted_name(&capture_value, name_slice);
-                ddtrace_create_capture_value(variable, &capture_value, capture_config, capture_config->max_reference_depth);
-                ddog_FieldType type = EX_VAR_NUM(0) <= variable && variable < EX_VAR_NUM(EX(func)->op_array.num_args) ? DDOG_FIELD_TYPE_ARG : DDOG_FIELD_TYPE_LOCAL;
-                ddog_snapshot_add_field(capture, type, name_slice, capture_value);
+        // Read the CV slots directly: rebuilding the symbol table would leave the frame with indirect CVs for the rest of the call
+        const zend_op_array *op_array = &EX(func)->op_array;
+        for (int i = 0; i < op_array->last_var; ++i) {
+            zval *variable = EX_VAR_NUM(i);
+            if (Z_TYPE_P(variable) == IS_UNDEF) {
+                continue;
             }
-        } ZEND_HASH_FOREACH_END();
+            struct ddog_CaptureValue capture_value = {0};
+            ddog_CharSlice name_slice = dd_zend_string_to_CharSlice(op_array->vars[i]);
+            ddtrace_snapshot_redacted_name(&capture_value, name_slice);
+            ddtrace_create_capture_value(variable, &capture_value, capture_config, capture_config->max_reference_depth);
+            ddog_FieldType type = (uint32_t)i < op_array->num_args ? DDOG_FIELD_TYPE_ARG : DDOG_FIELD_TYPE_LOCAL;
+            ddog_snapshot_add_field(capture, type, name_slice, capture_value);
+        }
+
+        // Dynamically created variables only exist in an already materialized symbol table
+        if (ZEND_CALL_INFO(execute_data) & ZEND_CALL_HAS_SYMBOL_TABLE) {
+            zend_string *symbol;
+            zval *variable;
+            ZEND_HASH_FOREACH_STR_KEY_VAL(EX(symbol_table), symbol, variable) {
+                if (symbol && Z_TYPE_P(variable) != IS_INDIRECT && Z_TYPE_P(variable) != IS_UNDEF) {
+                    struct ddog_CaptureValue capture_value = {0};
+                    ddog_CharSlice name_slice = dd_zend_string_to_CharSlice(symbol);
+                    ddtrace_snapshot_redacted_name(&capture_value, name_slice);
+                    ddtrace_create_capture_value(variable, &capture_value, capture_config, capture_config->max_reference_depth);
+                    ddog_snapshot_add_field(capture, DDOG_FIELD_TYPE_LOCAL, name_slice, capture_value);
+                }
+            } ZEND_HASH_FOREACH_END();
+        }
     } else if (EX(func)->internal_function.arg_info) {
         uint32_t num_args = EX(func)->internal_function.num_args;
         for (uintptr_t i = 0; i < num_args; ++i) {
@@ -414,6 +453,32 @@ static void dd_log_probe_capture_snapshot(ddog_DebuggerCapture *capture, dd_log_
     }
 }
 
+// A single capture arena is kept around per request instead of allocating 64k on every probe hit
+static zend_arena *dd_capture_arena_acquire(void) {
+    zend_arena *arena = DDTRACE_G(debugger_spare_arena);
+    if (arena) {
+        DDTRACE_G(debugger_spare_arena) = NULL;
+        return arena;
+    }
+    return zend_arena_create(65536);
+}
+
+static void dd_capture_arena_release(zend_arena *arena) {
+    if (DDTRACE_G(debugger_spare_arena)) {
+        zend_arena_destroy(arena);
+        return;
+    }
+
+    // Only keep the first block, reset to empty
+    while (arena->prev) {
+        zend_arena *prev = arena->prev;
+        efree(arena);
+        arena = prev;
+    }
+    arena->ptr = (char *) arena + ZEND_MM_ALIGNED_SIZE(sizeof(zend_arena));
+    DDTRACE_G(debugger_spare_arena) = arena;
+}
+
 static void dd_log_probe_end(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
     dd_log_probe_dyn *dyn = dynamic;
     dd_log_probe_def *def = auxiliary;
@@ -436,7 +501,7 @@ static void dd_log_probe_end(zend_ulong invocation, zend_execute_data *execute_d
     dd_log_probe_ensure_payload(dyn, def, &result_msg);
 
     if (def->parent.probe.probe.log.capture_snapshot) {
-        DDTRACE_G(debugger_capture_arena) = dyn->capture_arena ? dyn->capture_arena : zend_arena_create(65536);
+        DDTRACE_G(debugger_capture_arena) = dyn->capture_arena ? dyn->capture_arena : dd_capture_arena_acquire();
         ddog_DebuggerCapture *capture = ddog_snapshot_exit(dyn->payload);
         dd_log_probe_capture_snapshot(capture, def, execute_data);
         const ddog_CaptureConfiguration *capture_config = def->parent.probe.probe.log.capture;
@@ -446,7 +511,7 @@ static void dd_log_probe_end(zend_ulong invocation, zend_execute_data *execute_d
     }
     ddtrace_sidecar_send_debugger_datum(dyn->payload);
     if (DDTRACE_G(debugger_capture_arena)) {
-        zend_arena_destroy(DDTRACE_G(debugger_capture_arena));
+        dd_capture_arena_release(DDTRACE_G(debugger_capture_arena));
         DDTRACE_G(debugger_capture_arena) = NULL;
     }
     zend_string_release(result);
@@ -471,7 +536,7 @@ static bool dd_log_probe_begin(zend_ulong invocation, zend_execute_data *execute
         dd_log_probe_ensure_payload(dyn, def, NULL);
         if (def->parent.probe.probe.log.capture_snapshot) {
             ddog_DebuggerCapture *capture = ddog_snapshot_entry(dyn->payload);
-            DDTRACE_G(debugger_capture_arena) = zend_arena_create(65536);
+            DDTRACE_G(debugger_capture_arena) = dd_capture_arena_acquire();
             dd_log_probe_capture_snapshot(capture, def, execute_data);
             dyn->capture_arena = DDTRACE_G(debugger_capture_arena);
             DDTRACE_G(debugger_capture_arena) = NULL;
@@ -487,21 +552,166 @@ static int64_t dd_set_log_probe(const ddog_Probe *probe, const ddog_MaybeShmLimi
     return dd_init_live_debugger_probe(probe, &def->parent, dd_log_probe_begin, dd_log_probe_end, dd_probe_dtor, sizeof(dd_log_probe_dyn));
 }
 
+typedef struct {
+    dd_probe_def parent;
+    zend_string *metric_name;
+} dd_metric_probe_def;
+
+// Metric probes are aggregated per request, keyed by probe id, instead of hitting the sidecar on every call.
+// Histogram and distribution values are folded into a count/sum/min/max summary: the flush submits the mean under the
+// probe's metric name, the number of values as <name>.count and, for more than one value, <name>.min and <name>.max.
+#define DD_METRIC_PROBE_FLUSH_INTERVAL_NS (10 * ZEND_NANO_IN_SEC)
+
+typedef struct {
+    zend_string *name;
+    ddog_MetricKind kind;
+    bool pending;
+    zend_long count;
+    double gauge;
+    double sum;
+    double min;
+    double max;
+} dd_metric_probe_aggregate;
+
+static void dd_metric_probe_aggregate_dtor(zval *zv) {
+    dd_metric_probe_aggregate *agg = Z_PTR_P(zv);
+    zend_string_release(agg->name);
+    efree(agg);
+}
+
+static void dd_metric_probe_flush_summary(dd_metric_probe_aggregate *agg) {
+    double mean = agg->sum / (double)agg->count;
+    if (agg->kind == DDOG_METRIC_KIND_HISTOGRAM) {
+        ddtrace_sidecar_dogstatsd_histogram(agg->name, mean, NULL);
+    } else {
+        ddtrace_sidecar_dogstatsd_distribution(agg->name, mean, NULL);
+    }
+
+    zend_string *name = zend_strpprintf(0, "%s.count", ZSTR_VAL(agg->name));
+    ddtrace_sidecar_dogstatsd_count(name, agg->count, NULL);
+    zend_string_release(name);
+
+    if (agg->count > 1) {
+        name = zend_strpprintf(0, "%s.min", ZSTR_VAL(agg->name));
+        ddtrace_sidecar_dogstatsd_gauge(name, agg->min, NULL);
+        zend_string_release(name);
+        name = zend_strpprintf(0, "%s.max", ZSTR_VAL(agg->name));
+        ddtrace_sidecar_dogstatsd_gauge(name, agg->max, NULL);
+        zend_string_release(name);
+    }
+}
+
+static void dd_metric_probe_flush_aggregate(dd_metric_probe_aggregate *agg) {
+    if (!agg->pending) {
+        return;
+    }
+
+    switch (agg->kind) {
+        case DDOG_METRIC_KIND_COUNT:
+            ddtrace_sidecar_dogstatsd_count(agg->name, agg->count, NULL);
+            break;
+        case DDOG_METRIC_KIND_GAUGE:
+            ddtrace_sidecar_dogstatsd_gauge(agg->name, agg->gauge, NULL);
+            break;
+        case DDOG_METRIC_KIND_HISTOGRAM:
+        case DDOG_METRIC_KIND_DISTRIBUTION:
+            dd_metric_probe_flush_summary(agg);
+            break;
+    }
+    agg->pending = false;
+    agg->count = 0;
+    agg->sum = 0;
+}
+
+static void dd_metric_probe_flush_all(void) {
+    dd_metric_probe_aggregate *agg;
+    ZEND_HASH_FOREACH_PTR(DDTRACE_G(live_debugger_metrics), agg) {
+        dd_metric_probe_flush_aggregate(agg);
+    } ZEND_HASH_FOREACH_END();
+    DDTRACE_G(live_debugger_metrics_since) = zend_hrtime();
+}
+
+static void dd_metric_probe_aggregate_value(dd_metric_probe_def *def, double metric_value) {
+    HashTable *metrics = DDTRACE_G(live_debugger_metrics);
+    if (!metrics) {
+        ALLOC_HASHTABLE(metrics);
+        zend_hash_init(metrics, 8, NULL, dd_metric_probe_aggregate_dtor, 0);
+        DDTRACE_G(live_debugger_metrics) = metrics;
+        DDTRACE_G(live_debugger_metrics_since) = zend_hrtime();
+    }
+
+    dd_metric_probe_aggregate *agg = zend_hash_find_ptr(metrics, def->parent.probe_id);
+    if (!agg) {
+        agg = emalloc(sizeof(*agg));
+        agg->name = zend_string_copy(def->metric_name);
+        agg->kind = def->parent.probe.probe.metric.kind;
+        agg->pending = false;
+        agg->count = 0;
+        agg->gauge = 0;
+        agg->sum = 0;
+        agg->min = 0;
+        agg->max = 0;
+        zend_hash_add_new_ptr(metrics, def->parent.probe_id, agg);
+    }
+
+    switch (agg->kind) {
+        case DDOG_METRIC_KIND_COUNT:
+            agg->count += (zend_long)metric_value;
+            break;
+        case DDOG_METRIC_KIND_GAUGE:
+            agg->gauge = metric_value;
+            break;
+        case DDOG_METRIC_KIND_HISTOGRAM:
+        case DDOG_METRIC_KIND_DISTRIBUTION:
+            if (agg->count == 0 || metric_value < agg->min) {
+                agg->min = metric_value;
+            }
+            if (agg->count == 0 || metric_value > agg->max) {
+                agg->max = metric_value;
+            }
+            ++agg->count;
+            agg->sum += metric_value;
+            break;
+    }
+    agg->pending = true;
+
+    // Long running scripts must not hold on to their metrics until the end of the request
+    if (zend_hrtime() - DDTRACE_G(live_debugger_metrics_since) > DD_METRIC_PROBE_FLUSH_INTERVAL_NS) {
+        dd_metric_probe_flush_all();
+    }
+}
+
+void ddtrace_live_debugger_flush_metrics(void) {
+    if (DDTRACE_G(live_debugger_metrics)) {
+        dd_metric_probe_flush_all();
+    }
+}
+
+void ddtrace_live_debugger_rshutdown(void) {
+    if (DDTRACE_G(debugger_spare_arena)) {
+        zend_arena_destroy(DDTRACE_G(debugger_spare_arena));
+        DDTRACE_G(debugger_spare_arena) = NULL;
+    }
+    if (DDTRACE_G(live_debugger_metrics)) {
+        dd_metric_probe_flush_all();
+        zend_hash_destroy(DDTRACE_G(live_debugger_metrics));
+        FREE_HASHTABLE(DDTRACE_G(live_debugger_metrics));
+        DDTRACE_G(live_debugger_metrics) = NULL;
+    }
+}
+
 static void dd_metric_probe_end(zend_ulong invocation, zend_execute_data *execute_data, zval *retval, void *auxiliary, void *dynamic) {
-    dd_probe_def *def = auxiliary;
+    dd_metric_probe_def *def = auxiliary;
     UNUSED(invocation, dynamic);
-    if (dd_probe_file_mismatch(def, execute_data)) {
+    if (dd_probe_file_mismatch(&def->parent, execute_data)) {
         return;
     }
 
-    dd_probe_mark_active(def);
-
-    ddog_CharSlice *name = &def->probe.probe.metric.name;
-    zend_string *metric_name = zend_strpprintf(0, "dynamic.instrumentation.metric.probe.%.*s", (int)name->len, name->ptr);
+    dd_probe_mark_active(&def->parent);
 
-    ddog_ValueEvaluationResult result = dd_eval_value(def->probe.probe.metric.value, retval);
+    ddog_ValueEvaluationResult result = dd_eval_value(def->parent.probe.probe.metric.value, retval);
     if (result.tag == DDOG_VALUE_EVALUATION_RESULT_ERROR) {
-        dd_submit_probe_eval_error_snapshot(&def->probe, result.error);
+        dd_submit_probe_eval_error_snapshot(&def->parent.probe, result.error);
         return;
     }
 
@@ -526,23 +736,9 @@ static void dd_metric_probe_end(zend_ulong invocation, zend_execute_data *execut
             break;
     }
 
-    switch (def->probe.probe.metric.kind) {
-        case DDOG_METRIC_KIND_COUNT:
-            ddtrace_sidecar_dogstatsd_count(metric_name, (zend_long)metric_value, NULL);
-            break;
-        case DDOG_METRIC_KIND_GAUGE:
-            ddtrace_sidecar_dogstatsd_gauge(metric_name, metric_value, NULL);
-            break;
-        case DDOG_METRIC_KIND_HISTOGRAM:
-            ddtrace_sidecar_dogstatsd_histogram(metric_name, metric_value, NULL);
-            break;
-        case DDOG_METRIC_KIND_DISTRIBUTION:
-            ddtrace_sidecar_dogstatsd_distribution(metric_name, metric_value, NULL);
-            break;
-    }
+    dd_metric_probe_aggregate_value(def, metric_value);
 
     ddog_evaluated_value_drop(result.success);
-    zend_string_release(metric_name);
 }
 
 static bool dd_metric_probe_begin(zend_ulong invocation, zend_execute_data *execute_data, void *auxiliary, void *dynamic) {
@@ -552,8 +748,16 @@ static bool dd_metric_probe_begin(zend_ulong invocation, zend_execute_data *exec
     return true;
 }
 
+static void dd_metric_probe_dtor(void *data) {
+    dd_metric_probe_def *def = data;
+    zend_string_release(def->metric_name);
+    dd_probe_dtor(&def->parent);
+}
+
 static int64_t dd_set_metric_probe(const ddog_Probe *probe) {
-    dd_probe_def *def = emalloc(sizeof(*def));
+    dd_metric_probe_def *def = emalloc(sizeof(*def));
+    const ddog_CharSlice *name = &probe->probe.metric.name;
+    def->metric_name = zend_strpprintf(0, "dynamic.instrumentation.metric.probe.%.*s", (int)name->len, name->ptr);
 
     zai_hook_begin begin = NULL;
     zai_hook_end end = NULL;
@@ -562,7 +766,7 @@ static int64_t dd_set_metric_probe(const ddog_Probe *probe) {
     } else {
         end = dd_metric_probe_end;
     }
-    return dd_init_live_debugger_probe(probe, def, begin, end, dd_probe_dtor, 0);
+    return dd_init_live_debugger_probe(probe, &def->parent, begin, end, dd_metric_probe_dtor, 0);
 }
 
 static int64_t dd_set_probe(const ddog_Probe probe, const ddog_MaybeShmLimiter *limiter) {
@@ -729,16 +933,23 @@ static const void *dd_eval_fetch_identifier(void *ctx, const ddog_CharSlice *nam
 
     if (EX(func)) {
         if (ZEND_USER_CODE(EX(func)->type)) {
-            zend_execute_data *current_execute_data = EG(current_execute_data);
-            EG(current_execute_data) = execute_data;
-            zend_array *symtable = zend_rebuild_symbol_table();
-            if (!symtable) {
-                return NULL;
+            // Resolve against the compiled variables, without materializing the symbol table of the frame
+            const zend_op_array *op_array = &EX(func)->op_array;
+            for (int i = 0; i < op_array->last_var; ++i) {
+                zend_string *var = op_array->vars[i];
+                if (ZSTR_LEN(var) == name->len && memcmp(ZSTR_VAL(var), name->ptr, name->len) == 0) {
+                    zval *zvp = EX_VAR_NUM(i);
+                    if (Z_TYPE_P(zvp) != IS_UNDEF) {
+                        return zvp;
+                    }
+                    break;
+                }
             }
-            zval *zvp = zend_hash_str_find_ind(symtable, name->ptr, name->len);
-            EG(current_execute_data) = current_execute_data;
-            if (zvp) {
-                return zvp;
+            if (ZEND_CALL_INFO(execute_data) & ZEND_CALL_HAS_SYMBOL_TABLE) {
+                zval *zvp = zend_hash_str_find_ind(EX(symbol_table), name->ptr, name->len);
+                if (zvp) {
+                    return zvp;
+                }
             }
         } else {
             int call_args = MIN(EX_NUM_ARGS(), EX(func)->common.num_args);
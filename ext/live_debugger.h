@@ -6,6 +6,9 @@
 extern ddog_LiveDebuggerSetup ddtrace_live_debugger_setup;
 
 void ddtrace_live_debugger_minit(void);
+// Must run while the root span is still open, its service, env and version are the tags of the metrics
+void ddtrace_live_debugger_flush_metrics(void);
+void ddtrace_live_debugger_rshutdown(void);
 
 static inline void ddtrace_snapshot_redacted_name(ddog_CaptureValue *capture_value, ddog_CharSlice name) {
     if (ddog_snapshot_redacted_name(name)) {
@@ -117,22 +117,56 @@ void ddtrace_log_mshutdown(void) {
     }
 }
 
-int ddtrace_log_with_time(int fd, const char *msg, int msg_len) {
-    // todo: we only need 20-ish for the main part, but how much for the timezone?
-    // Wish PHP printed -hhmm or +hhmm instead of the name
-    char *msgbuf = malloc(msg_len + 70);
+// Used from both PHP threads and the background sender, hence real thread locals, not ZEND_TLS
+#ifdef _WIN32
+#define DD_LOG_THREAD_LOCAL __declspec(thread)
+#else
+#define DD_LOG_THREAD_LOCAL __thread
+#endif
 
-    time_t now;
-    time(&now);
-    struct tm *now_local = localtime(&now);
-    char *p = msgbuf;
+// todo: we only need 20-ish for the main part, but how much for the timezone?
+// Wish PHP printed -hhmm or +hhmm instead of the name
+#define DD_LOG_PREFIX_MAX 70
+
+// The "[date] " prefix only changes once per second, there's no need to go through localtime() and strftime() per line
+static DD_LOG_THREAD_LOCAL time_t dd_log_prefix_time = (time_t)-1;
+static DD_LOG_THREAD_LOCAL char dd_log_prefix[DD_LOG_PREFIX_MAX];
+static DD_LOG_THREAD_LOCAL int dd_log_prefix_len;
+
+static void dd_log_update_prefix(time_t now) {
+    struct tm now_local;
+#ifdef _WIN32
+    localtime_s(&now_local, &now);
+#else
+    localtime_r(&now, &now_local);
+#endif
+    char *p = dd_log_prefix;
     *(p++) = '[';
-    int time_len = (int)strftime(p, 64, "%d-%b-%Y %H:%M:%S %Z", now_local);
+    int time_len = (int)strftime(p, DD_LOG_PREFIX_MAX - 3, "%d-%b-%Y %H:%M:%S %Z", &now_local);
     if (time_len > 0) {
         p += time_len;
     }
     *(p++) = ']';
     *(p++) = ' ';
+    dd_log_prefix_len = (int)(p - dd_log_prefix);
+    dd_log_prefix_time = now;
+}
+
+int ddtrace_log_with_time(int fd, const char *msg, int msg_len) {
+    time_t now;
+    time(&now);
+    if (now != dd_log_prefix_time) {
+        dd_log_update_prefix(now);
+    }
+
+    // Typical log lines fit on the stack
+    char stackbuf[1024];
+    size_t needed = (size_t)dd_log_prefix_len + msg_len + 1;
+    char *msgbuf = needed <= sizeof(stackbuf) ? stackbuf : malloc(needed);
+
+    char *p = msgbuf;
+    memcpy(p, dd_log_prefix, dd_log_prefix_len);
+    p += dd_log_prefix_len;
     memcpy(p, msg, msg_len);
     p += msg_len;
     *(p++) = '\n';
@@ -156,7 +190,9 @@ int ddtrace_log_with_time(int fd, const char *msg, int msg_len) {
 
     int ret = write(fd, msgbuf, p - msgbuf);
 
-    free(msgbuf);
+    if (msgbuf != stackbuf) {
+        free(msgbuf);
+    }
     return ret;
 }
 
@@ -172,13 +208,16 @@ int ddtrace_bgs_logf(const char *fmt, ...) {
         int needed_len = vsnprintf(NULL, 0, fmt, args_copy);
         va_end(args_copy);
 
-        char *msgbuf = malloc(needed_len);
-        vsnprintf(msgbuf, needed_len, fmt, args);
+        char stackbuf[512];
+        char *msgbuf = needed_len < (int)sizeof(stackbuf) ? stackbuf : malloc(needed_len + 1);
+        vsnprintf(msgbuf, needed_len + 1, fmt, args);
         va_end(args);
 
         ret = ddtrace_log_with_time(error_log_fd, msgbuf, needed_len);
 
-        free(msgbuf);
+        if (msgbuf != stackbuf) {
+            free(msgbuf);
+        }
     }
 
     return ret;
@@ -43,15 +43,65 @@ int64_t ddtrace_get_memory_limit(void) {
     return limit;
 }
 
-bool ddtrace_is_memory_under_limit(void) {
-    static int64_t limit = -1;
-    static zend_bool fetched_limit = 0;
-    if (!fetched_limit) {  // cache get_memory_limit() result to make this function blazing fast
-        fetched_limit = 1;
-        limit = ddtrace_get_memory_limit();
+// The limit is cached per request and dropped whenever memory_limit or DD_TRACE_MEMORY_LIMIT change
+static int64_t dd_request_memory_limit(void) {
+    if (!DDTRACE_G(memory_limit_fetched)) {
+        DDTRACE_G(memory_limit_fetched) = true;
+        DDTRACE_G(memory_limit) = ddtrace_get_memory_limit();
     }
+    return DDTRACE_G(memory_limit);
+}
+
+bool ddtrace_is_memory_under_limit(void) {
+    int64_t limit = dd_request_memory_limit();
     if (limit > 0) {
         return ((zend_ulong)limit > zend_memory_usage(0)) ? true : false;
     }
     return true;
 }
+
+bool ddtrace_is_memory_limit_reached(void) {
+    if (DDTRACE_G(memory_check_countdown) == 0) {
+        DDTRACE_G(memory_check_countdown) = DDTRACE_MEMORY_LIMIT_CHECK_INTERVAL;
+        DDTRACE_G(memory_limit_reached) = !ddtrace_is_memory_under_limit();
+    }
+    --DDTRACE_G(memory_check_countdown);
+    return DDTRACE_G(memory_limit_reached);
+}
+
+static void dd_invalidate_memory_limit(void) {
+    DDTRACE_G(memory_limit_fetched) = false;
+    DDTRACE_G(memory_check_countdown) = 0;
+}
+
+static ZEND_INI_MH((*dd_memory_limit_orig_on_modify));
+
+static ZEND_INI_MH(dd_memory_limit_on_modify) {
+    int ret = dd_memory_limit_orig_on_modify(entry, new_value, mh_arg1, mh_arg2, mh_arg3, stage);
+    // On startup the ini entries of new threads are refreshed before our globals exist
+    if (ret == SUCCESS && stage != ZEND_INI_STAGE_STARTUP && stage != ZEND_INI_STAGE_SHUTDOWN) {
+        dd_invalidate_memory_limit();
+    }
+    return ret;
+}
+
+void ddtrace_memory_limit_minit(void) {
+    zend_ini_entry *ini = zend_hash_str_find_ptr(EG(ini_directives), ZEND_STRL("memory_limit"));
+    if (ini && ini->on_modify) {
+        dd_memory_limit_orig_on_modify = ini->on_modify;
+        ini->on_modify = dd_memory_limit_on_modify;
+    }
+}
+
+void ddtrace_memory_limit_rinit(void) {
+    dd_invalidate_memory_limit();
+    DDTRACE_G(memory_limit_reached) = false;
+}
+
+bool ddtrace_alter_memory_limit(zval *old_value, zval *new_value, zend_string *new_str) {
+    UNUSED(old_value, new_value, new_str);
+    if (DDTRACE_G(request_initialized)) {
+        dd_invalidate_memory_limit();
+    }
+    return true;
+}
@@ -3,10 +3,20 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <php.h>
 
 #define ALLOWED_MAX_MEMORY_USE_IN_PERCENT_OF_MEMORY_LIMIT 0.8
+// Number of limit checks which reuse the previous memory usage probe
+#define DDTRACE_MEMORY_LIMIT_CHECK_INTERVAL 32
 
 int64_t ddtrace_get_memory_limit(void);
 bool ddtrace_is_memory_under_limit(void);
+// Cheaper variant of !ddtrace_is_memory_under_limit() for hot paths, which only probes the memory usage every
+// DDTRACE_MEMORY_LIMIT_CHECK_INTERVAL calls
+bool ddtrace_is_memory_limit_reached(void);
+
+void ddtrace_memory_limit_minit(void);
+void ddtrace_memory_limit_rinit(void);
+bool ddtrace_alter_memory_limit(zval *old_value, zval *new_value, zend_string *new_str);
 
 #endif  // DD_TRACE_MEMORY_LIMIT_H
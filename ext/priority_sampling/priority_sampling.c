@@ -7,6 +7,9 @@
 #include <json/json.h>
 
 #include "../configuration.h"
+#ifndef _WIN32
+#include "../coms.h"
+#endif
 
 #include "../limiter/limiter.h"
 #include "ddshared.h"
@@ -19,6 +22,12 @@ ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
 
 void ddtrace_try_read_agent_rate(void) {
     ddog_CharSlice data;
+#ifndef _WIN32
+    // Forked children only get an agent config handle once their writer started
+    if (!DDTRACE_G(agent_config_reader) && ddtrace_coms_agent_config_handle && !get_global_DD_TRACE_SIDECAR_TRACE_SENDER()) {
+        ddog_agent_remote_config_reader_for_anon_shm(ddtrace_coms_agent_config_handle, &DDTRACE_G(agent_config_reader));
+    }
+#endif
     if (DDTRACE_G(agent_config_reader) && ddog_agent_remote_config_read(DDTRACE_G(agent_config_reader), &data)) {
         zval json;
         if ((int)data.len > 0 && zai_json_decode_assoc_safe(&json, data.ptr, (int)data.len, 3, true) == SUCCESS) {
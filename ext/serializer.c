@@ -37,6 +37,7 @@
 #include <components/log/log.h>
 #include "priority_sampling/priority_sampling.h"
 #include "span.h"
+#include "tracer_overhead.h"
 #include "uri_normalization.h"
 #include "user_request.h"
 #include "ddshared.h"
@@ -45,6 +46,9 @@
 #include "live_debugger.h"
 #include "exception_serialize.h"
 #include "agent_info.h"
+#ifndef _WIN32
+#include "trace_stats.h"
+#endif
 
 ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
 
@@ -1391,6 +1395,49 @@ static zend_always_inline double strconv_parse_bool(zend_string *str) {
     return -1;
 }
 
+#ifndef _WIN32
+static zend_string *dd_serialized_str(zend_array *serialized, const char *key, size_t key_len) {
+    zval *zv = zend_hash_str_find(serialized, key, key_len);
+    return zv && Z_TYPE_P(zv) == IS_STRING ? Z_STR_P(zv) : NULL;
+}
+
+// Reads the stats dimensions straight off the span properties, without serializing its meta and metrics
+static void dd_trace_stats_add_unsampled_span(ddtrace_span_data *span, zend_array *serialized, zend_array *meta, zend_array *metrics, bool top_level) {
+    zval *measured = zend_hash_str_find(metrics, ZEND_STRL("_dd.measured"));
+    ddtrace_trace_stats_span stats = {
+        .service = dd_serialized_str(serialized, ZEND_STRL("service")),
+        .name = dd_serialized_str(serialized, ZEND_STRL("name")),
+        .resource = dd_serialized_str(serialized, ZEND_STRL("resource")),
+        .type = dd_serialized_str(serialized, ZEND_STRL("type")),
+        .measured = measured && zval_get_double(measured) == 1,
+        .top_level = top_level,
+    };
+    if (!stats.top_level && !stats.measured) {
+        return;
+    }
+
+    zval *status = zend_hash_str_find(meta, ZEND_STRL("http.status_code"));
+    if (status) {
+        stats.http_status_code = (uint32_t)zval_get_long(status);
+    }
+
+    zval *origin = &span->root->property_origin;
+    ZVAL_DEREF(origin);
+    stats.synthetics = Z_TYPE_P(origin) == IS_STRING && ddtrace_trace_stats_is_synthetics(Z_STR_P(origin));
+
+    // Same rules as _serialize_meta: an exception always is an error, error tags unless error.ignored is set
+    zval *exception_zv = &span->property_exception;
+    if (Z_TYPE_P(exception_zv) == IS_OBJECT && instanceof_function(Z_OBJCE_P(exception_zv), zend_ce_throwable)) {
+        stats.error = true;
+    } else if (ddtrace_hash_find_ptr(meta, ZEND_STRL("error.message")) || ddtrace_hash_find_ptr(meta, ZEND_STRL("error.type"))) {
+        zval *ignored = zend_hash_str_find(meta, ZEND_STRL("error.ignored"));
+        stats.error = !ignored || !zend_is_true(ignored);
+    }
+
+    ddtrace_trace_stats_add_span(span, &stats);
+}
+#endif
+
 void ddtrace_serialize_span_to_array(ddtrace_span_data *span, zval *array) {
     bool is_root_span = span->std.ce == ddtrace_ce_root_span_data;
     zval *el;
@@ -1698,6 +1745,26 @@ void ddtrace_serialize_span_to_array(ddtrace_span_data *span, zval *array) {
         zend_hash_str_del(meta, ZEND_STRL("operation.name"));
     }
 
+#ifndef _WIN32
+    bool top_level = false;
+    if (ddtrace_trace_stats_enabled()) {
+        top_level = ddtrace_trace_stats_is_top_level(span);
+
+        // Stats are all the agent needs of an unsampled trace, unless single span sampled: skip the rest of the span
+        if (ddtrace_fetch_priority_sampling_from_span(span->root) <= 0 && !zend_hash_str_exists(metrics, ZEND_STRL("_dd.span_sampling.mechanism"))) {
+            if (!span->parent || ddtrace_span_is_entrypoint_root(span)) {
+                // Root spans are few and their meta carries the request status and error, serialize them as usual
+                _serialize_meta(el, span, Z_TYPE_P(prop_service) > IS_NULL ? Z_STR(prop_service_as_string) : ZSTR_EMPTY_ALLOC());
+                ddtrace_trace_stats_add_serialized_span(span, Z_ARR_P(el), top_level);
+            } else {
+                dd_trace_stats_add_unsampled_span(span, Z_ARR_P(el), meta, metrics, top_level);
+            }
+            zval_ptr_dtor(el);
+            return;
+        }
+    }
+#endif
+
     _serialize_meta(el, span, Z_TYPE_P(prop_service) > IS_NULL ? Z_STR(prop_service_as_string) : ZSTR_EMPTY_ALLOC());
 
     zval metrics_zv;
@@ -1716,6 +1783,13 @@ void ddtrace_serialize_span_to_array(ddtrace_span_data *span, zval *array) {
         }
     }
 
+#ifndef _WIN32
+    if (top_level) {
+        // The agent relies on _dd.top_level when the client computes top-level-ness itself
+        add_assoc_double(&metrics_zv, "_dd.top_level", 1);
+    }
+#endif
+
     if (ddtrace_span_is_entrypoint_root(span)) {
         if (get_DD_TRACE_MEASURE_COMPILE_TIME()) {
             add_assoc_double(&metrics_zv, "php.compilation.total_time_ms", ddtrace_compile_time_get() / 1000.);
@@ -1724,6 +1798,14 @@ void ddtrace_serialize_span_to_array(ddtrace_span_data *span, zval *array) {
             add_assoc_double(&metrics_zv, "php.memory.peak_usage_bytes", zend_memory_peak_usage(false));
             add_assoc_double(&metrics_zv, "php.memory.peak_real_usage_bytes", zend_memory_peak_usage(true));
         }
+        if (DDTRACE_G(measure_overhead)) {
+            // Serialization of this very trace is still in progress, only earlier flushes are part of serialize_ns
+            for (int kind = 0; kind < DDTRACE_OVERHEAD_KINDS; ++kind) {
+                char metric_name[64];
+                snprintf(metric_name, sizeof(metric_name), "_dd.tracer_overhead.%s_ns", ddtrace_overhead_kind_name(kind));
+                add_assoc_double(&metrics_zv, metric_name, (double)ddtrace_overhead_get(kind));
+            }
+        }
     }
 
     LOGEV(SPAN, {
@@ -1775,6 +1857,12 @@ void ddtrace_serialize_span_to_array(ddtrace_span_data *span, zval *array) {
         zend_array_destroy(Z_ARR(metrics_zv));
     }
 
+#ifndef _WIN32
+    if (ddtrace_trace_stats_enabled()) {
+        ddtrace_trace_stats_add_serialized_span(span, Z_ARR_P(el), top_level);
+    }
+#endif
+
     zend_array *meta_struct = ddtrace_property_array(&span->property_meta_struct);
     zval meta_struct_zv;
     array_init(&meta_struct_zv);
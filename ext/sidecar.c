@@ -157,7 +157,18 @@ void ddtrace_sidecar_shutdown(void) {
     }
 }
 
+static void dd_forget_submitted_identity(void) {
+    if (DDTRACE_G(sidecar_submitted_identity).service) {
+        zend_string_release(DDTRACE_G(sidecar_submitted_identity).service);
+        zend_string_release(DDTRACE_G(sidecar_submitted_identity).env);
+        zend_string_release(DDTRACE_G(sidecar_submitted_identity).version);
+        DDTRACE_G(sidecar_submitted_identity).service = NULL;
+    }
+}
+
 void ddtrace_reset_sidecar_globals(void) {
+    // A forked child has a new instance id, everything has to be sent again
+    dd_forget_submitted_identity();
     if (ddtrace_sidecar_instance_id) {
         ddog_sidecar_instanceId_drop(ddtrace_sidecar_instance_id);
         ddtrace_set_resettable_sidecar_globals();
@@ -192,34 +203,54 @@ void ddtrace_sidecar_push_tag(ddog_Vec_Tag *vec, ddog_CharSlice key, ddog_CharSl
     }
 }
 
-void ddtrace_sidecar_push_tags(ddog_Vec_Tag *vec, zval *tags) {
-    // Global tags (https://github.com/DataDog/php-datadogstatsd/blob/0efdd1c38f6d3dd407efbb899ad1fd2e5cd18085/src/DogStatsd.php#L113-L125)
+static void dd_release_base_tags(void) {
+    if (DDTRACE_G(dogstatsd_base_tags).env) {
+        zend_string_release(DDTRACE_G(dogstatsd_base_tags).env);
+        zend_string_release(DDTRACE_G(dogstatsd_base_tags).service);
+        zend_string_release(DDTRACE_G(dogstatsd_base_tags).version);
+        DDTRACE_G(dogstatsd_base_tags).env = NULL;
+    }
+}
+
+// env, service and version only need to be derived again when the active span changes or when one of these properties
+// has been written to (which bumps span_properties_generation). Writes made through a PHP reference to one of these
+// properties are not noticed, as they bypass the object handlers entirely.
+static void dd_resolve_base_tags(void) {
     ddtrace_span_data *span = ddtrace_active_span();
-    zend_string *env;
+    uint64_t span_id = span ? span->span_id : 0;
+    if (DDTRACE_G(dogstatsd_base_tags).env && DDTRACE_G(dogstatsd_base_tags).span_id == span_id
+        && DDTRACE_G(dogstatsd_base_tags).generation == DDTRACE_G(span_properties_generation)) {
+        return;
+    }
+
+    dd_release_base_tags();
     if (span) {
-        env = ddtrace_convert_to_str(&span->property_env);
+        DDTRACE_G(dogstatsd_base_tags).env = ddtrace_convert_to_str(&span->property_env);
+        DDTRACE_G(dogstatsd_base_tags).version = ddtrace_convert_to_str(&span->property_version);
     } else {
-        env = zend_string_copy(get_DD_ENV());
+        DDTRACE_G(dogstatsd_base_tags).env = zend_string_copy(get_DD_ENV());
+        DDTRACE_G(dogstatsd_base_tags).version = zend_string_copy(get_DD_VERSION());
     }
+    DDTRACE_G(dogstatsd_base_tags).service = ddtrace_active_service_name();
+    DDTRACE_G(dogstatsd_base_tags).span_id = span_id;
+    DDTRACE_G(dogstatsd_base_tags).generation = DDTRACE_G(span_properties_generation);
+}
+
+void ddtrace_sidecar_push_tags(ddog_Vec_Tag *vec, zval *tags) {
+    // Global tags (https://github.com/DataDog/php-datadogstatsd/blob/0efdd1c38f6d3dd407efbb899ad1fd2e5cd18085/src/DogStatsd.php#L113-L125)
+    dd_resolve_base_tags();
+    zend_string *env = DDTRACE_G(dogstatsd_base_tags).env;
     if (ZSTR_LEN(env) > 0) {
         ddtrace_sidecar_push_tag(vec, DDOG_CHARSLICE_C("env"), dd_zend_string_to_CharSlice(env));
     }
-    zend_string_release(env);
-    zend_string *service = ddtrace_active_service_name();
+    zend_string *service = DDTRACE_G(dogstatsd_base_tags).service;
     if (ZSTR_LEN(service) > 0) {
         ddtrace_sidecar_push_tag(vec, DDOG_CHARSLICE_C("service"), dd_zend_string_to_CharSlice(service));
     }
-    zend_string_release(service);
-    zend_string *version;
-    if (span) {
-        version = ddtrace_convert_to_str(&span->property_version);
-    } else {
-        version = zend_string_copy(get_DD_VERSION());
-    }
+    zend_string *version = DDTRACE_G(dogstatsd_base_tags).version;
     if (ZSTR_LEN(version) > 0) {
         ddtrace_sidecar_push_tag(vec, DDOG_CHARSLICE_C("version"), dd_zend_string_to_CharSlice(version));
     }
-    zend_string_release(version);
 
     if (ZSTR_LEN(get_DD_TRACE_AGENT_TEST_SESSION_TOKEN())) {
         ddtrace_sidecar_push_tag(vec, DDOG_CHARSLICE_C("x-datadog-test-session-token"), dd_zend_string_to_CharSlice(get_DD_TRACE_AGENT_TEST_SESSION_TOKEN()));
@@ -304,12 +335,33 @@ void ddtrace_sidecar_dogstatsd_set(zend_string *metric, zend_long value, zval *t
     ddog_Vec_Tag_drop(vec);
 }
 
+static inline bool dd_zend_string_equals_CharSlice(zend_string *str, ddog_CharSlice slice) {
+    return ZSTR_LEN(str) == slice.len && memcmp(ZSTR_VAL(str), slice.ptr, slice.len) == 0;
+}
+
+static bool dd_is_submitted_identity(ddog_CharSlice service, ddog_CharSlice env, ddog_CharSlice version) {
+    return DDTRACE_G(sidecar_submitted_identity).service
+        && DDTRACE_G(sidecar_submitted_identity).tags_generation == DDTRACE_G(active_global_tags_source).generation
+        && dd_zend_string_equals_CharSlice(DDTRACE_G(sidecar_submitted_identity).service, service)
+        && dd_zend_string_equals_CharSlice(DDTRACE_G(sidecar_submitted_identity).env, env)
+        && dd_zend_string_equals_CharSlice(DDTRACE_G(sidecar_submitted_identity).version, version);
+}
+
+static void dd_set_submitted_identity(ddog_CharSlice service, ddog_CharSlice env, ddog_CharSlice version) {
+    dd_forget_submitted_identity();
+    DDTRACE_G(sidecar_submitted_identity).service = dd_CharSlice_to_zend_string(service);
+    DDTRACE_G(sidecar_submitted_identity).env = dd_CharSlice_to_zend_string(env);
+    DDTRACE_G(sidecar_submitted_identity).version = dd_CharSlice_to_zend_string(version);
+    DDTRACE_G(sidecar_submitted_identity).tags_generation = DDTRACE_G(active_global_tags_source).generation;
+}
+
 void ddtrace_sidecar_submit_root_span_data_direct_defaults(ddtrace_root_span_data *root) {
     ddtrace_sidecar_submit_root_span_data_direct(root, get_DD_SERVICE(), get_DD_ENV(), get_DD_VERSION());
 }
 
 void ddtrace_sidecar_submit_root_span_data_direct(ddtrace_root_span_data *root, zend_string *cfg_service, zend_string *cfg_env, zend_string *cfg_version) {
-    if (!ddtrace_sidecar || !get_global_DD_REMOTE_CONFIG_ENABLED()) {
+    // active_global_tags is only built on the first RINIT
+    if (!ddtrace_sidecar || !get_global_DD_REMOTE_CONFIG_ENABLED() || !DDTRACE_G(active_global_tags_source).tags) {
         return;
     }
 
@@ -353,12 +405,17 @@ void ddtrace_sidecar_submit_root_span_data_direct(ddtrace_root_span_data *root,
         version_slice = dd_zend_string_to_CharSlice(cfg_version);
     }
 
-    bool changed = true;
-    if (DDTRACE_G(remote_config_state)) {
-        changed = ddog_remote_configs_service_env_change(DDTRACE_G(remote_config_state), service_slice, env_slice, version_slice, &DDTRACE_G(active_global_tags));
-    }
-    if (changed || !root) {
-        ddtrace_ffi_try("Failed sending remote config data", ddog_sidecar_set_remote_config_data(&ddtrace_sidecar, ddtrace_sidecar_instance_id, &DDTRACE_G(sidecar_queue_id), service_slice, env_slice, version_slice, &DDTRACE_G(active_global_tags)));
+    // The queue id changes with every request, so this only skips sending the same data again over the same queue,
+    // e.g. when the entrypoint root span starts with the service data submitted on RINIT
+    if (!dd_is_submitted_identity(service_slice, env_slice, version_slice)) {
+        bool changed = true;
+        if (DDTRACE_G(remote_config_state)) {
+            changed = ddog_remote_configs_service_env_change(DDTRACE_G(remote_config_state), service_slice, env_slice, version_slice, &DDTRACE_G(active_global_tags));
+        }
+        if (changed || !root) {
+            ddtrace_ffi_try("Failed sending remote config data", ddog_sidecar_set_remote_config_data(&ddtrace_sidecar, ddtrace_sidecar_instance_id, &DDTRACE_G(sidecar_queue_id), service_slice, env_slice, version_slice, &DDTRACE_G(active_global_tags)));
+            dd_set_submitted_identity(service_slice, env_slice, version_slice);
+        }
     }
 
     if (free_string) {
@@ -387,39 +444,124 @@ void ddtrace_sidecar_send_debugger_datum(ddog_DebuggerPayload *payload) {
 
 void ddtrace_sidecar_activate(void) {
     DDTRACE_G(sidecar_queue_id) = ddog_sidecar_queueId_generate();
+    // Released at the end of the previous request
+    DDTRACE_G(sidecar_submitted_identity).service = NULL;
+}
+
+static bool dd_zend_string_equals_nullable(zend_string *a, zend_string *b) {
+    return a == b || (a && b && zend_string_equals(a, b));
+}
+
+static bool dd_global_tags_source_matches(zend_array *tags, zend_string *commit, zend_string *repository) {
+    HashTable *source = DDTRACE_G(active_global_tags_source).tags;
+    if (!source || zend_hash_num_elements(source) != zend_hash_num_elements(tags)
+        || !dd_zend_string_equals_nullable(DDTRACE_G(active_global_tags_source).commit, commit)
+        || !dd_zend_string_equals_nullable(DDTRACE_G(active_global_tags_source).repository, repository)) {
+        return false;
+    }
 
-    DDTRACE_G(active_global_tags) = ddog_Vec_Tag_new();
     zend_string *tag;
     zval *value;
-    ZEND_HASH_FOREACH_STR_KEY_VAL(get_DD_TAGS(), tag, value) {
-        UNUSED(ddog_Vec_Tag_push(&DDTRACE_G(active_global_tags), dd_zend_string_to_CharSlice(tag), dd_zend_string_to_CharSlice(Z_STR_P(value))));
+    ZEND_HASH_FOREACH_STR_KEY_VAL(tags, tag, value) {
+        zval *source_value = zend_hash_find(source, tag);
+        if (!source_value || !zend_string_equals(Z_STR_P(source_value), Z_STR_P(value))) {
+            return false;
+        }
     } ZEND_HASH_FOREACH_END();
+    return true;
 }
 
-void ddtrace_sidecar_rinit(void) {
+static inline zend_string *dd_persistent_string_copy(zend_string *str) {
+    return str ? zend_string_init(ZSTR_VAL(str), ZSTR_LEN(str), 1) : NULL;
+}
+
+static void dd_save_global_tags_source(zend_array *tags, zend_string *commit, zend_string *repository) {
+    HashTable *source = DDTRACE_G(active_global_tags_source).tags;
+    if (source) {
+        zend_hash_clean(source);
+        if (DDTRACE_G(active_global_tags_source).commit) {
+            zend_string_release(DDTRACE_G(active_global_tags_source).commit);
+        }
+        if (DDTRACE_G(active_global_tags_source).repository) {
+            zend_string_release(DDTRACE_G(active_global_tags_source).repository);
+        }
+    } else {
+        source = pemalloc(sizeof(HashTable), 1);
+        zend_hash_init(source, zend_hash_num_elements(tags), NULL, ZVAL_INTERNAL_PTR_DTOR, 1);
+        DDTRACE_G(active_global_tags_source).tags = source;
+    }
+
+    zend_string *tag;
+    zval *value;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(tags, tag, value) {
+        zval copy;
+        ZVAL_STR(&copy, dd_persistent_string_copy(Z_STR_P(value)));
+        zend_hash_str_update(source, ZSTR_VAL(tag), ZSTR_LEN(tag), &copy);
+    } ZEND_HASH_FOREACH_END();
+    DDTRACE_G(active_global_tags_source).commit = dd_persistent_string_copy(commit);
+    DDTRACE_G(active_global_tags_source).repository = dd_persistent_string_copy(repository);
+    ++DDTRACE_G(active_global_tags_source).generation;
+}
+
+// The tags almost never change within a process, only build the vector again if DD_TAGS or the git metadata did
+static void dd_update_global_tags(void) {
+    zend_string *commit = NULL, *repository = NULL;
+    ddtrace_git_metadata *git_metadata = NULL;
     if (get_DD_TRACE_GIT_METADATA_ENABLED()) {
         zval git_object;
         ZVAL_UNDEF(&git_object);
         ddtrace_inject_git_metadata(&git_object);
         if (Z_TYPE(git_object) == IS_OBJECT) {
-            ddtrace_git_metadata *git_metadata = (ddtrace_git_metadata *) Z_OBJ(git_object);
+            git_metadata = (ddtrace_git_metadata *) Z_OBJ(git_object);
             if (Z_TYPE(git_metadata->property_commit) == IS_STRING) {
-                UNUSED(ddog_Vec_Tag_push(&DDTRACE_G(active_global_tags), DDOG_CHARSLICE_C("DD_GIT_COMMIT_SHA"),
-                                         dd_zend_string_to_CharSlice(Z_STR(git_metadata->property_commit))));
+                commit = Z_STR(git_metadata->property_commit);
             }
             if (Z_TYPE(git_metadata->property_repository) == IS_STRING) {
-                UNUSED(ddog_Vec_Tag_push(&DDTRACE_G(active_global_tags), DDOG_CHARSLICE_C("DD_GIT_REPOSITORY_URL"),
-                                         dd_zend_string_to_CharSlice(Z_STR(git_metadata->property_repository))));
+                repository = Z_STR(git_metadata->property_repository);
             }
-            OBJ_RELEASE(&git_metadata->std);
         }
     }
 
+    zend_array *tags = get_DD_TAGS();
+    if (!dd_global_tags_source_matches(tags, commit, repository)) {
+        if (DDTRACE_G(active_global_tags_source).tags) {
+            ddog_Vec_Tag_drop(DDTRACE_G(active_global_tags));
+        }
+
+        zend_string *tag;
+        zval *value;
+        DDTRACE_G(active_global_tags) = ddog_Vec_Tag_new();
+        ZEND_HASH_FOREACH_STR_KEY_VAL(tags, tag, value) {
+            UNUSED(ddog_Vec_Tag_push(&DDTRACE_G(active_global_tags), dd_zend_string_to_CharSlice(tag), dd_zend_string_to_CharSlice(Z_STR_P(value))));
+        } ZEND_HASH_FOREACH_END();
+        if (commit) {
+            UNUSED(ddog_Vec_Tag_push(&DDTRACE_G(active_global_tags), DDOG_CHARSLICE_C("DD_GIT_COMMIT_SHA"), dd_zend_string_to_CharSlice(commit)));
+        }
+        if (repository) {
+            UNUSED(ddog_Vec_Tag_push(&DDTRACE_G(active_global_tags), DDOG_CHARSLICE_C("DD_GIT_REPOSITORY_URL"), dd_zend_string_to_CharSlice(repository)));
+        }
+        dd_save_global_tags_source(tags, commit, repository);
+    }
+
+    if (git_metadata) {
+        OBJ_RELEASE(&git_metadata->std);
+    }
+}
+
+void ddtrace_sidecar_rinit(void) {
+    dd_update_global_tags();
+
     ddtrace_sidecar_submit_root_span_data_direct_defaults(NULL);
 }
 
 void ddtrace_sidecar_rshutdown(void) {
-    ddog_Vec_Tag_drop(DDTRACE_G(active_global_tags));
+    // active_global_tags is kept for the next request
+    dd_forget_submitted_identity();
+}
+
+void ddtrace_sidecar_post_deactivate(void) {
+    // Not in RSHUTDOWN: metrics may still be submitted from other extensions' RSHUTDOWN, caching request memory again
+    dd_release_base_tags();
 }
 
 bool ddtrace_alter_test_session_token(zval *old_value, zval *new_value, zend_string *new_str) {
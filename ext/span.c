@@ -1,4 +1,5 @@
 #include "span.h"
+#include "tracer_overhead.h"
 
 #include <SAPI.h>
 #include "priority_sampling/priority_sampling.h"
@@ -9,6 +10,7 @@
 #include "compat_string.h"
 #include "configuration.h"
 #include "ddtrace.h"
+#include "exception_serialize.h"
 #include <components/log/log.h>
 #include "random.h"
 #include "serializer.h"
@@ -151,6 +153,9 @@ uint64_t ddtrace_nanoseconds_realtime(void) {
 }
 
 ddtrace_span_data *ddtrace_open_span(enum ddtrace_span_dataype type) {
+    DDTRACE_OVERHEAD_START(DDTRACE_OVERHEAD_SPANS);
+    ddtrace_ensure_fiber_span_stack();
+
     ddtrace_span_stack *stack = DDTRACE_G(active_stack);
     // The primary stack is ancestor to all stacks, which signifies that any root spans created on top of it will inherit the distributed tracing context
     bool primary_stack = stack->parent_stack == NULL;
@@ -225,6 +230,7 @@ ddtrace_span_data *ddtrace_open_span(enum ddtrace_span_dataype type) {
         LOG(SPAN_TRACE, "Starting new span: trace_id=%s, span_id=%" PRIu64 ", parent_id=%" PRIu64 ", SpanStack=%d", Z_STRVAL(span->root->property_trace_id), span->span_id, SPANDATA(span->parent)->span_id, span->stack->std.handle);
     }
 
+    DDTRACE_OVERHEAD_END();
     return span;
 }
 
@@ -543,6 +549,8 @@ void ddtrace_close_span(ddtrace_span_data *span) {
         return;
     }
 
+    DDTRACE_OVERHEAD_START(DDTRACE_OVERHEAD_SPANS);
+
     // Closing a span (esp. when leaving a traced function) autoswitches the stacks if necessary
     if (span->stack != DDTRACE_G(active_stack)) {
         ddtrace_switch_span_stack(span->stack);
@@ -555,6 +563,8 @@ void ddtrace_close_span(ddtrace_span_data *span) {
     ddtrace_close_stack_userland_spans_until(span);
 
     ddtrace_close_top_span_without_stack_swap(span);
+
+    DDTRACE_OVERHEAD_END();
 }
 
 void ddtrace_close_span_restore_stack(ddtrace_span_data *span) {
@@ -724,6 +734,8 @@ void ddtrace_drop_span(ddtrace_span_data *span) {
 }
 
 void ddtrace_serialize_closed_spans(zval *serialized) {
+    DDTRACE_OVERHEAD_START(DDTRACE_OVERHEAD_SERIALIZE);
+
     if (DDTRACE_G(top_closed_stack)) {
         ddtrace_span_stack *rootstack = DDTRACE_G(top_closed_stack);
         DDTRACE_G(top_closed_stack) = NULL;
@@ -759,9 +771,13 @@ void ddtrace_serialize_closed_spans(zval *serialized) {
         } while (rootstack);
     }
 
+    ddtrace_exception_stack_cache_clear();
+
     // Reset closed span counter for limit-refresh, don't touch open spans
     DDTRACE_G(closed_spans_count) = 0;
     DDTRACE_G(dropped_spans_count) = 0;
+
+    DDTRACE_OVERHEAD_END();
 }
 
 void ddtrace_serialize_closed_spans_with_cycle(zval *serialized) {
@@ -210,6 +210,17 @@ ddtrace_span_data *ddtrace_open_span(enum ddtrace_span_dataype type);
 ddtrace_span_data *ddtrace_init_dummy_span(void);
 ddtrace_span_stack *ddtrace_init_span_stack(void);
 ddtrace_span_stack *ddtrace_init_root_span_stack(void);
+#if PHP_VERSION_ID >= 80200
+void ddtrace_fiber_materialize_span_stack(void);
+// Fibers run on the stack of their parent until they actually need one of their own
+static inline void ddtrace_ensure_fiber_span_stack(void) {
+    if (UNEXPECTED(DDTRACE_G(lazy_stack_fiber))) {
+        ddtrace_fiber_materialize_span_stack();
+    }
+}
+#else
+static inline void ddtrace_ensure_fiber_span_stack(void) {}
+#endif
 void ddtrace_push_root_span(void);
 
 ddtrace_span_data *ddtrace_active_span(void);
@@ -6,6 +6,7 @@
 #include "telemetry.h"
 #include "serializer.h"
 #include "sidecar.h"
+#include "tracer_overhead.h"
 
 ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
 
@@ -143,6 +144,16 @@ void ddtrace_telemetry_finalize(void) {
         }
     }
 
+    if (DDTRACE_G(measure_overhead)) {
+        metric_name = DDOG_CHARSLICE_C("tracer_overhead.ns");
+        ddog_sidecar_telemetry_register_metric_type_buffer(buffer, metric_name, DDOG_METRIC_NAMESPACE_TRACERS, DDOG_METRIC_TYPE_DISTRIBUTION);
+        for (int kind = 0; kind < DDTRACE_OVERHEAD_KINDS; ++kind) {
+            char tags[64];
+            int tags_len = snprintf(tags, sizeof(tags), "component:%s", ddtrace_overhead_kind_name(kind));
+            ddog_sidecar_telemetry_add_span_metric_point_buffer(buffer, metric_name, (double)ddtrace_overhead_get(kind), (ddog_CharSlice){.ptr = tags, .len = (uintptr_t)tags_len});
+        }
+    }
+
     ddtrace_ffi_try("Failed flushing telemetry buffer",
                     ddog_sidecar_telemetry_buffer_flush(&ddtrace_sidecar, ddtrace_sidecar_instance_id, &DDTRACE_G(sidecar_queue_id), buffer));
 
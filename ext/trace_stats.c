@@ -0,0 +1,487 @@
+// Note: Not included on Windows
+#include <php.h>
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <Zend/zend_smart_str.h>
+
+#include <components-rs/ddtrace.h>
+#include <components/log/log.h>
+
+#include "compatibility.h"
+#include "configuration.h"
+#include "ddtrace.h"
+#include "ext/version.h"
+#include "mpack/mpack.h"
+#include "trace_stats.h"
+#include "zend_hrtime.h"
+
+// Stats are aggregated in 10 second buckets, keyed by the end time of the span, as the agent does.
+#define DD_TRACE_STATS_BUCKET_DURATION (10 * ZEND_NANO_IN_SEC)
+// Keep a few buckets around in case the writer does not get around to flushing them in time.
+#define DD_TRACE_STATS_MAX_BUCKETS 6
+
+// Same parameters as the agent uses for its DDSketches: 1% relative accuracy, collapsing the lowest bins.
+#define DD_SKETCH_RELATIVE_ACCURACY 0.01
+#define DD_SKETCH_MAX_BINS 2048
+#define DD_SKETCH_MIN_INDEXABLE 1e-9
+
+typedef struct {
+    double *bins;
+    int32_t offset;  // index of bins[0]
+    uint32_t len;
+    uint32_t cap;
+    double zero_count;
+} dd_trace_stats_sketch;
+
+typedef struct {
+    zend_string *service;
+    zend_string *name;
+    zend_string *resource;
+    zend_string *type;
+    uint32_t http_status_code;
+    bool synthetics;
+
+    uint64_t hits;
+    uint64_t errors;
+    uint64_t top_level_hits;
+    uint64_t duration;
+    dd_trace_stats_sketch ok_summary;
+    dd_trace_stats_sketch error_summary;
+} dd_trace_stats_group;
+
+typedef struct {
+    uint64_t start;
+    HashTable groups;  // persistent, aggregation key => dd_trace_stats_group *
+} dd_trace_stats_bucket;
+
+bool ddtrace_trace_stats_active = false;
+
+static pthread_mutex_t dd_trace_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static dd_trace_stats_bucket *dd_trace_stats_buckets[DD_TRACE_STATS_MAX_BUCKETS];
+static uint64_t dd_trace_stats_sequence = 0;
+static double dd_sketch_multiplier;  // 1 / ln(gamma)
+static double dd_sketch_gamma;
+
+static void dd_sketch_destroy(dd_trace_stats_sketch *sketch) {
+    free(sketch->bins);
+}
+
+static void dd_sketch_reserve(dd_trace_stats_sketch *sketch, uint32_t len) {
+    if (len > sketch->cap) {
+        uint32_t cap = MAX(sketch->cap * 2, 32);
+        while (cap < len) {
+            cap *= 2;
+        }
+        cap = MIN(cap, DD_SKETCH_MAX_BINS);
+        sketch->bins = realloc(sketch->bins, cap * sizeof(double));
+        sketch->cap = cap;
+    }
+}
+
+static void dd_sketch_add(dd_trace_stats_sketch *sketch, double value) {
+    if (value <= DD_SKETCH_MIN_INDEXABLE) {
+        sketch->zero_count += 1;
+        return;
+    }
+
+    int32_t index = (int32_t)ceil(log(value) * dd_sketch_multiplier);
+
+    if (sketch->len == 0) {
+        dd_sketch_reserve(sketch, 1);
+        sketch->offset = index;
+        sketch->bins[0] = 0;
+        sketch->len = 1;
+    } else if (index >= sketch->offset + (int32_t)sketch->len) {
+        uint32_t new_len = index - sketch->offset + 1;
+        if (new_len > DD_SKETCH_MAX_BINS) {
+            // Collapse the lowest bins into the new lowest bin
+            uint32_t shift = new_len - DD_SKETCH_MAX_BINS;
+            double collapsed = 0;
+            for (uint32_t i = 0; i <= shift && i < sketch->len; ++i) {
+                collapsed += sketch->bins[i];
+            }
+            if (shift < sketch->len) {
+                memmove(sketch->bins, sketch->bins + shift, (sketch->len - shift) * sizeof(double));
+                sketch->len -= shift;
+            } else {
+                sketch->len = 1;
+            }
+            sketch->bins[0] = collapsed;
+            sketch->offset += shift;
+            new_len = DD_SKETCH_MAX_BINS;
+        }
+        dd_sketch_reserve(sketch, new_len);
+        memset(sketch->bins + sketch->len, 0, (new_len - sketch->len) * sizeof(double));
+        sketch->len = new_len;
+    } else if (index < sketch->offset) {
+        int32_t lowest = sketch->offset + (int32_t)sketch->len - DD_SKETCH_MAX_BINS;
+        if (index < lowest) {
+            index = lowest;
+        }
+        if (index < sketch->offset) {
+            uint32_t grow = sketch->offset - index;
+            dd_sketch_reserve(sketch, sketch->len + grow);
+            memmove(sketch->bins + grow, sketch->bins, sketch->len * sizeof(double));
+            memset(sketch->bins, 0, grow * sizeof(double));
+            sketch->len += grow;
+            sketch->offset = index;
+        }
+    }
+
+    sketch->bins[index - sketch->offset] += 1;
+}
+
+static void dd_proto_varint(smart_str *buf, uint64_t value) {
+    while (value >= 0x80) {
+        smart_str_appendc_ex(buf, (char)(value | 0x80), 1);
+        value >>= 7;
+    }
+    smart_str_appendc_ex(buf, (char)value, 1);
+}
+
+static void dd_proto_double(smart_str *buf, double value) {
+    // protobuf fixed64 values are little endian, like all platforms we support
+    smart_str_appendl_ex(buf, (const char *)&value, sizeof(double), 1);
+}
+
+// Encodes the sketch as pb.DDSketch, which is what the agent expects in the Ok/ErrorSummary fields
+static void dd_sketch_encode(dd_trace_stats_sketch *sketch, smart_str *buf) {
+    // IndexMapping mapping = 1; with double gamma = 1;
+    smart_str_appendc_ex(buf, 0x0a, 1);
+    dd_proto_varint(buf, 1 + sizeof(double));
+    smart_str_appendc_ex(buf, 0x09, 1);
+    dd_proto_double(buf, dd_sketch_gamma);
+
+    // Store positiveValues = 2; with repeated double contiguousBinCounts = 2 [packed]; sint32 contiguousBinIndexOffset = 3;
+    if (sketch->len) {
+        size_t counts_len = sketch->len * sizeof(double);
+        uint32_t zigzag_offset = ((uint32_t)sketch->offset << 1) ^ (uint32_t)(sketch->offset >> 31);
+        smart_str store = {0};
+        smart_str_appendc_ex(&store, 0x12, 1);
+        dd_proto_varint(&store, counts_len);
+        smart_str_appendl_ex(&store, (const char *)sketch->bins, counts_len, 1);
+        smart_str_appendc_ex(&store, 0x18, 1);
+        dd_proto_varint(&store, zigzag_offset);
+
+        smart_str_appendc_ex(buf, 0x12, 1);
+        dd_proto_varint(buf, ZSTR_LEN(store.s));
+        smart_str_append_ex(buf, store.s, 1);
+        smart_str_free_ex(&store, 1);
+    }
+
+    // double zeroCount = 4;
+    if (sketch->zero_count) {
+        smart_str_appendc_ex(buf, 0x21, 1);
+        dd_proto_double(buf, sketch->zero_count);
+    }
+}
+
+static void dd_trace_stats_group_dtor(zval *zv) {
+    dd_trace_stats_group *group = Z_PTR_P(zv);
+    zend_string_release(group->service);
+    zend_string_release(group->name);
+    zend_string_release(group->resource);
+    zend_string_release(group->type);
+    dd_sketch_destroy(&group->ok_summary);
+    dd_sketch_destroy(&group->error_summary);
+    free(group);
+}
+
+static void dd_trace_stats_bucket_free(dd_trace_stats_bucket *bucket) {
+    zend_hash_destroy(&bucket->groups);
+    free(bucket);
+}
+
+void ddtrace_trace_stats_minit(void) {
+    ddtrace_trace_stats_active = get_global_DD_TRACE_STATS_COMPUTATION_ENABLED() && !get_global_DD_TRACE_SIDECAR_TRACE_SENDER();
+
+    dd_sketch_gamma = (1 + DD_SKETCH_RELATIVE_ACCURACY) / (1 - DD_SKETCH_RELATIVE_ACCURACY);
+    dd_sketch_multiplier = 1 / log(dd_sketch_gamma);
+}
+
+void ddtrace_trace_stats_mshutdown(void) {
+    pthread_mutex_lock(&dd_trace_stats_mutex);
+    for (int i = 0; i < DD_TRACE_STATS_MAX_BUCKETS; ++i) {
+        if (dd_trace_stats_buckets[i]) {
+            dd_trace_stats_bucket_free(dd_trace_stats_buckets[i]);
+            dd_trace_stats_buckets[i] = NULL;
+        }
+    }
+    pthread_mutex_unlock(&dd_trace_stats_mutex);
+}
+
+void ddtrace_trace_stats_clean_after_fork(void) {
+    // The parent process is responsible for submitting its own stats, we must not count them twice.
+    // The mutex may have been held by another thread while forking, just reinitialize it.
+    pthread_mutex_init(&dd_trace_stats_mutex, NULL);
+    ddtrace_trace_stats_mshutdown();
+    dd_trace_stats_sequence = 0;
+}
+
+bool ddtrace_trace_stats_is_top_level(ddtrace_span_data *span) {
+    if (!span->parent) {
+        return true;
+    }
+
+    // A root span nested in another trace starts a new trace and thus always is top-level
+    if (span->std.ce == ddtrace_ce_root_span_data) {
+        return true;
+    }
+
+    ddtrace_span_data *parent = SPANDATA(span->parent);
+    zend_string *service = ddtrace_convert_to_str(&span->property_service);
+    zend_string *parent_service = ddtrace_convert_to_str(&parent->property_service);
+    bool top_level = !zend_string_equals(service, parent_service);
+    zend_string_release(service);
+    zend_string_release(parent_service);
+    return top_level;
+}
+
+static zend_string *dd_trace_stats_str(zend_array *arr, const char *key, size_t key_len) {
+    zval *zv = zend_hash_str_find(arr, key, key_len);
+    if (zv && Z_TYPE_P(zv) == IS_STRING) {
+        return Z_STR_P(zv);
+    }
+    return ZSTR_EMPTY_ALLOC();
+}
+
+bool ddtrace_trace_stats_is_synthetics(zend_string *origin) {
+    return ZSTR_LEN(origin) >= strlen("synthetics") && memcmp(ZSTR_VAL(origin), ZEND_STRL("synthetics")) == 0;
+}
+
+void ddtrace_trace_stats_add_serialized_span(ddtrace_span_data *span, zend_array *serialized, bool top_level) {
+    ddtrace_trace_stats_span stats = {
+        .service = dd_trace_stats_str(serialized, ZEND_STRL("service")),
+        .name = dd_trace_stats_str(serialized, ZEND_STRL("name")),
+        .resource = dd_trace_stats_str(serialized, ZEND_STRL("resource")),
+        .type = dd_trace_stats_str(serialized, ZEND_STRL("type")),
+        .top_level = top_level,
+    };
+
+    zval *metrics = zend_hash_str_find(serialized, ZEND_STRL("metrics"));
+    if (metrics && Z_TYPE_P(metrics) == IS_ARRAY) {
+        zval *measured_zv = zend_hash_str_find(Z_ARR_P(metrics), ZEND_STRL("_dd.measured"));
+        stats.measured = measured_zv && zval_get_double(measured_zv) == 1;
+    }
+
+    zval *meta = zend_hash_str_find(serialized, ZEND_STRL("meta"));
+    if (meta && Z_TYPE_P(meta) == IS_ARRAY) {
+        zval *status = zend_hash_str_find(Z_ARR_P(meta), ZEND_STRL("http.status_code"));
+        if (status) {
+            stats.http_status_code = (uint32_t)zval_get_long(status);
+        }
+        stats.synthetics = ddtrace_trace_stats_is_synthetics(dd_trace_stats_str(Z_ARR_P(meta), ZEND_STRL("_dd.origin")));
+    }
+
+    zval *error_zv = zend_hash_str_find(serialized, ZEND_STRL("error"));
+    stats.error = error_zv && zval_get_long(error_zv);
+
+    ddtrace_trace_stats_add_span(span, &stats);
+}
+
+void ddtrace_trace_stats_add_span(ddtrace_span_data *span, const ddtrace_trace_stats_span *stats) {
+    // The agent only computes stats for top-level and measured spans
+    if (!stats->top_level && !stats->measured) {
+        return;
+    }
+
+    zend_string *service = stats->service ? stats->service : ZSTR_EMPTY_ALLOC();
+    zend_string *name = stats->name ? stats->name : ZSTR_EMPTY_ALLOC();
+    zend_string *resource = stats->resource ? stats->resource : ZSTR_EMPTY_ALLOC();
+    zend_string *type = stats->type ? stats->type : ZSTR_EMPTY_ALLOC();
+    uint32_t http_status_code = stats->http_status_code;
+    bool synthetics = stats->synthetics;
+    bool top_level = stats->top_level;
+    bool error = stats->error;
+
+    // Aggregation key: all dimensions separated by NUL bytes
+    smart_str key = {0};
+    smart_str_append(&key, service);
+    smart_str_appendc(&key, 0);
+    smart_str_append(&key, name);
+    smart_str_appendc(&key, 0);
+    smart_str_append(&key, resource);
+    smart_str_appendc(&key, 0);
+    smart_str_append(&key, type);
+    smart_str_appendc(&key, 0);
+    smart_str_append_unsigned(&key, http_status_code);
+    smart_str_appendc(&key, synthetics ? '1' : '0');
+    smart_str_0(&key);
+
+    uint64_t end = span->start + span->duration;
+    uint64_t bucket_start = end - end % DD_TRACE_STATS_BUCKET_DURATION;
+
+    pthread_mutex_lock(&dd_trace_stats_mutex);
+
+    dd_trace_stats_bucket *bucket = NULL, **oldest = &dd_trace_stats_buckets[0];
+    for (int i = 0; i < DD_TRACE_STATS_MAX_BUCKETS; ++i) {
+        dd_trace_stats_bucket **cur = &dd_trace_stats_buckets[i];
+        if (*cur && (*cur)->start == bucket_start) {
+            bucket = *cur;
+            break;
+        }
+        if (!*cur || (*oldest && (*cur)->start < (*oldest)->start)) {
+            oldest = cur;
+        }
+    }
+
+    if (!bucket) {
+        if (*oldest) {
+            // The writer did not flush in time, we cannot hold more buckets
+            LOG(WARN, "Dropping client side stats for bucket starting at %" PRIu64 " as it was not flushed in time", (*oldest)->start);
+            dd_trace_stats_bucket_free(*oldest);
+        }
+        bucket = malloc(sizeof(*bucket));
+        bucket->start = bucket_start;
+        zend_hash_init(&bucket->groups, 8, NULL, dd_trace_stats_group_dtor, 1);
+        *oldest = bucket;
+    }
+
+    dd_trace_stats_group *group = zend_hash_str_find_ptr(&bucket->groups, ZSTR_VAL(key.s), ZSTR_LEN(key.s));
+    if (!group) {
+        group = calloc(1, sizeof(*group));
+        group->service = zend_string_init(ZSTR_VAL(service), ZSTR_LEN(service), 1);
+        group->name = zend_string_init(ZSTR_VAL(name), ZSTR_LEN(name), 1);
+        group->resource = zend_string_init(ZSTR_VAL(resource), ZSTR_LEN(resource), 1);
+        group->type = zend_string_init(ZSTR_VAL(type), ZSTR_LEN(type), 1);
+        group->http_status_code = http_status_code;
+        group->synthetics = synthetics;
+        zend_hash_str_add_new_ptr(&bucket->groups, ZSTR_VAL(key.s), ZSTR_LEN(key.s), group);
+    }
+
+    ++group->hits;
+    if (top_level) {
+        ++group->top_level_hits;
+    }
+    group->duration += span->duration;
+    if (error) {
+        ++group->errors;
+        dd_sketch_add(&group->error_summary, (double)span->duration);
+    } else {
+        dd_sketch_add(&group->ok_summary, (double)span->duration);
+    }
+
+    pthread_mutex_unlock(&dd_trace_stats_mutex);
+
+    smart_str_free(&key);
+}
+
+static void dd_write_zstr(mpack_writer_t *writer, zend_string *str) {
+    mpack_write_str(writer, ZSTR_VAL(str), ZSTR_LEN(str));
+}
+
+static void dd_write_sketch(mpack_writer_t *writer, dd_trace_stats_sketch *sketch) {
+    smart_str buf = {0};
+    dd_sketch_encode(sketch, &buf);
+    mpack_write_bin(writer, ZSTR_VAL(buf.s), ZSTR_LEN(buf.s));
+    smart_str_free_ex(&buf, 1);
+}
+
+static void dd_write_bucket(mpack_writer_t *writer, dd_trace_stats_bucket *bucket) {
+    mpack_start_map(writer, 3);
+    mpack_write_cstr(writer, "Start");
+    mpack_write_u64(writer, bucket->start);
+    mpack_write_cstr(writer, "Duration");
+    mpack_write_u64(writer, DD_TRACE_STATS_BUCKET_DURATION);
+    mpack_write_cstr(writer, "Stats");
+    mpack_start_array(writer, zend_hash_num_elements(&bucket->groups));
+    dd_trace_stats_group *group;
+    ZEND_HASH_FOREACH_PTR(&bucket->groups, group) {
+        mpack_start_map(writer, 12);
+        mpack_write_cstr(writer, "Service");
+        dd_write_zstr(writer, group->service);
+        mpack_write_cstr(writer, "Name");
+        dd_write_zstr(writer, group->name);
+        mpack_write_cstr(writer, "Resource");
+        dd_write_zstr(writer, group->resource);
+        mpack_write_cstr(writer, "Type");
+        dd_write_zstr(writer, group->type);
+        mpack_write_cstr(writer, "HTTPStatusCode");
+        mpack_write_u32(writer, group->http_status_code);
+        mpack_write_cstr(writer, "Synthetics");
+        mpack_write_bool(writer, group->synthetics);
+        mpack_write_cstr(writer, "Hits");
+        mpack_write_u64(writer, group->hits);
+        mpack_write_cstr(writer, "Errors");
+        mpack_write_u64(writer, group->errors);
+        mpack_write_cstr(writer, "TopLevelHits");
+        mpack_write_u64(writer, group->top_level_hits);
+        mpack_write_cstr(writer, "Duration");
+        mpack_write_u64(writer, group->duration);
+        mpack_write_cstr(writer, "OkSummary");
+        dd_write_sketch(writer, &group->ok_summary);
+        mpack_write_cstr(writer, "ErrorSummary");
+        dd_write_sketch(writer, &group->error_summary);
+        mpack_finish_map(writer);
+    } ZEND_HASH_FOREACH_END();
+    mpack_finish_array(writer);
+    mpack_finish_map(writer);
+}
+
+bool ddtrace_trace_stats_serialize(bool force, char **data, size_t *size) {
+    dd_trace_stats_bucket *flushable[DD_TRACE_STATS_MAX_BUCKETS];
+    int count = 0;
+
+    uint64_t now = ddtrace_nanoseconds_realtime();
+    uint64_t current_bucket_start = now - now % DD_TRACE_STATS_BUCKET_DURATION;
+
+    // Only hold the lock for detaching the buckets, the encoding happens unlocked
+    pthread_mutex_lock(&dd_trace_stats_mutex);
+    for (int i = 0; i < DD_TRACE_STATS_MAX_BUCKETS; ++i) {
+        dd_trace_stats_bucket *bucket = dd_trace_stats_buckets[i];
+        if (bucket && (force || bucket->start < current_bucket_start)) {
+            flushable[count++] = bucket;
+            dd_trace_stats_buckets[i] = NULL;
+        }
+    }
+    uint64_t sequence = count ? ++dd_trace_stats_sequence : 0;
+    pthread_mutex_unlock(&dd_trace_stats_mutex);
+
+    if (!count) {
+        return false;
+    }
+
+    uint8_t runtime_id[36];
+    ddtrace_format_runtime_id(&runtime_id);
+    char hostname[256] = {0};
+    if (get_global_DD_TRACE_REPORT_HOSTNAME()) {
+        gethostname(hostname, sizeof(hostname) - 1);
+    }
+
+    mpack_writer_t writer;
+    mpack_writer_init_growable(&writer, data, size);
+    mpack_start_map(&writer, 8);
+    mpack_write_cstr(&writer, "Hostname");
+    mpack_write_cstr(&writer, hostname);
+    mpack_write_cstr(&writer, "Env");
+    dd_write_zstr(&writer, get_global_DD_ENV());
+    mpack_write_cstr(&writer, "Version");
+    dd_write_zstr(&writer, get_global_DD_VERSION());
+    mpack_write_cstr(&writer, "Lang");
+    mpack_write_cstr(&writer, "php");
+    mpack_write_cstr(&writer, "TracerVersion");
+    mpack_write_cstr(&writer, PHP_DDTRACE_VERSION);
+    mpack_write_cstr(&writer, "RuntimeID");
+    mpack_write_str(&writer, (const char *)runtime_id, sizeof(runtime_id));
+    mpack_write_cstr(&writer, "Sequence");
+    mpack_write_u64(&writer, sequence);
+    mpack_write_cstr(&writer, "Stats");
+    mpack_start_array(&writer, count);
+    for (int i = 0; i < count; ++i) {
+        dd_write_bucket(&writer, flushable[i]);
+        dd_trace_stats_bucket_free(flushable[i]);
+    }
+    mpack_finish_array(&writer);
+    mpack_finish_map(&writer);
+
+    if (mpack_writer_destroy(&writer) != mpack_ok) {
+        free(*data);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef DD_TRACE_STATS_H
+#define DD_TRACE_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "span.h"
+
+// Note: client side stats are only shipped via the background sender, not on Windows.
+
+extern bool ddtrace_trace_stats_active;
+
+void ddtrace_trace_stats_minit(void);
+void ddtrace_trace_stats_mshutdown(void);
+void ddtrace_trace_stats_clean_after_fork(void);
+
+static inline bool ddtrace_trace_stats_enabled(void) {
+    return ddtrace_trace_stats_active;
+}
+
+bool ddtrace_trace_stats_is_top_level(ddtrace_span_data *span);
+
+// The aggregation dimensions of a span, with service mapping and name/resource defaults already applied. Strings are
+// borrowed and may be NULL.
+typedef struct {
+    zend_string *service;
+    zend_string *name;
+    zend_string *resource;
+    zend_string *type;
+    uint32_t http_status_code;
+    bool synthetics;
+    bool error;
+    bool measured;
+    bool top_level;
+} ddtrace_trace_stats_span;
+
+bool ddtrace_trace_stats_is_synthetics(zend_string *origin);
+
+/* Aggregates a span into the current bucket. */
+void ddtrace_trace_stats_add_span(ddtrace_span_data *span, const ddtrace_trace_stats_span *stats);
+/* Same, for an already serialized span (as produced by ddtrace_serialize_span_to_array). */
+void ddtrace_trace_stats_add_serialized_span(ddtrace_span_data *span, zend_array *serialized, bool top_level);
+
+/* Called from the writer thread. Encodes all buckets which are complete (or all buckets if force is set) into a
+ * msgpack ClientStatsPayload. Returns false if there was nothing to send. data must be freed with free(). */
+bool ddtrace_trace_stats_serialize(bool force, char **data, size_t *size);
+
+#endif  // DD_TRACE_STATS_H
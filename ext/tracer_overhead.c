@@ -0,0 +1,56 @@
+#include "tracer_overhead.h"
+#include "configuration.h"
+
+static const char *dd_overhead_kind_names[DDTRACE_OVERHEAD_KINDS] = {
+    [DDTRACE_OVERHEAD_HOOKS] = "hooks",
+    [DDTRACE_OVERHEAD_SPANS] = "spans",
+    [DDTRACE_OVERHEAD_SERIALIZE] = "serialize",
+    [DDTRACE_OVERHEAD_PROPAGATION] = "propagation",
+};
+
+void ddtrace_overhead_rinit(void) {
+    memset(DDTRACE_G(overhead_ns), 0, sizeof(DDTRACE_G(overhead_ns)));
+#if DDTRACE_OVERHEAD_ACCOUNTING
+    DDTRACE_G(measure_overhead) = get_DD_TRACE_MEASURE_OVERHEAD();
+    DDTRACE_G(overhead_kind) = DDTRACE_OVERHEAD_NONE;
+#else
+    DDTRACE_G(measure_overhead) = false;
+#endif
+}
+
+#if DDTRACE_OVERHEAD_ACCOUNTING
+int ddtrace_overhead_enter(ddtrace_overhead_kind kind) {
+    zend_hrtime_t now = zend_hrtime();
+    int previous_kind = DDTRACE_G(overhead_kind);
+    if (previous_kind != DDTRACE_OVERHEAD_NONE) {
+        DDTRACE_G(overhead_ns)[previous_kind] += now - DDTRACE_G(overhead_since);
+    }
+    DDTRACE_G(overhead_kind) = (int)kind;
+    DDTRACE_G(overhead_since) = now;
+    return previous_kind;
+}
+
+void ddtrace_overhead_leave(int previous_kind) {
+    zend_hrtime_t now = zend_hrtime();
+    int kind = DDTRACE_G(overhead_kind);
+    if (kind != DDTRACE_OVERHEAD_NONE) {
+        DDTRACE_G(overhead_ns)[kind] += now - DDTRACE_G(overhead_since);
+    }
+    DDTRACE_G(overhead_kind) = previous_kind;
+    DDTRACE_G(overhead_since) = now;
+}
+
+void ddtrace_overhead_unwind(void) {
+    if (DDTRACE_G(measure_overhead) && DDTRACE_G(overhead_kind) != DDTRACE_OVERHEAD_NONE) {
+        ddtrace_overhead_leave(DDTRACE_OVERHEAD_NONE);
+    }
+}
+#endif
+
+uint64_t ddtrace_overhead_get(ddtrace_overhead_kind kind) {
+    return DDTRACE_G(overhead_ns)[kind];
+}
+
+const char *ddtrace_overhead_kind_name(ddtrace_overhead_kind kind) {
+    return dd_overhead_kind_names[kind];
+}
@@ -0,0 +1,79 @@
+#ifndef DD_TRACER_OVERHEAD_H
+#define DD_TRACER_OVERHEAD_H
+
+#include <stdint.h>
+
+#include "ddtrace.h"
+#include "zend_hrtime.h"
+
+ZEND_EXTERN_MODULE_GLOBALS(ddtrace);
+
+// Accounts the time spent within the tracer itself, per ddtrace_overhead_kind. Times are exclusive: when a measured
+// section is entered from within another one (e.g. an auto flush while closing a span), the outer one is paused.
+// The accounting is compiled in unless DDTRACE_OVERHEAD_ACCOUNTING is defined to 0, and only active with
+// DD_TRACE_MEASURE_OVERHEAD, which is read once per request.
+#ifndef DDTRACE_OVERHEAD_ACCOUNTING
+#define DDTRACE_OVERHEAD_ACCOUNTING 1
+#endif
+
+#if DDTRACE_OVERHEAD_ACCOUNTING
+#define DDTRACE_OVERHEAD_NONE (-1)
+#define DDTRACE_OVERHEAD_DISABLED (-2)
+
+int ddtrace_overhead_enter(ddtrace_overhead_kind kind);
+void ddtrace_overhead_leave(int previous_kind);
+
+static inline int ddtrace_overhead_start(ddtrace_overhead_kind kind) {
+    if (EXPECTED(!DDTRACE_G(measure_overhead))) {
+        return DDTRACE_OVERHEAD_DISABLED;
+    }
+    return ddtrace_overhead_enter(kind);
+}
+
+static inline void ddtrace_overhead_end(int previous_kind) {
+    if (EXPECTED(previous_kind == DDTRACE_OVERHEAD_DISABLED)) {
+        return;
+    }
+    ddtrace_overhead_leave(previous_kind);
+}
+
+#define DDTRACE_OVERHEAD_START(kind) int dd_overhead_previous_kind = ddtrace_overhead_start(kind)
+#define DDTRACE_OVERHEAD_END() ddtrace_overhead_end(dd_overhead_previous_kind)
+
+// For sections running user code: a bailout (exit, fatal error) would skip DDTRACE_OVERHEAD_END() and leave the rest
+// of the request accounted to that kind. The zend_try is only entered when measuring.
+#define DDTRACE_OVERHEAD_MEASURE_USER_CODE(kind, call)                           \
+    do {                                                                         \
+        DDTRACE_OVERHEAD_START(kind);                                            \
+        if (EXPECTED(dd_overhead_previous_kind == DDTRACE_OVERHEAD_DISABLED)) { \
+            call;                                                                \
+            break;                                                               \
+        }                                                                        \
+        bool dd_overhead_bailout = false;                                        \
+        zend_try {                                                               \
+            call;                                                                \
+        } zend_catch {                                                           \
+            dd_overhead_bailout = true;                                          \
+        } zend_end_try();                                                        \
+        DDTRACE_OVERHEAD_END();                                                  \
+        if (dd_overhead_bailout) {                                               \
+            zend_bailout();                                                      \
+        }                                                                        \
+    } while (0)
+
+// Closes whichever section is still open, e.g. when a bailout unwound through it
+void ddtrace_overhead_unwind(void);
+#else
+#define DDTRACE_OVERHEAD_START(kind) do { } while (0)
+#define DDTRACE_OVERHEAD_END() do { } while (0)
+#define DDTRACE_OVERHEAD_MEASURE_USER_CODE(kind, call) do { call; } while (0)
+#define ddtrace_overhead_unwind() do { } while (0)
+#endif
+
+void ddtrace_overhead_rinit(void);
+// Total nanoseconds spent so far in this request in the given kind of tracer code; 0 if not measured
+uint64_t ddtrace_overhead_get(ddtrace_overhead_kind kind);
+// Name of the kind, as used in the _dd.tracer_overhead.<name>_ns metrics and the telemetry tags
+const char *ddtrace_overhead_kind_name(ddtrace_overhead_kind kind);
+
+#endif  // DD_TRACER_OVERHEAD_H
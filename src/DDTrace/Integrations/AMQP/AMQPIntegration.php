@@ -63,7 +63,8 @@ class AMQPIntegration extends Integration
         hook_method(
             'PhpAmqpLib\Connection\AbstractConnection',
             '__construct',
-            function ($This) use ($integration) {
+            static function ($This) {
+                $integration = AMQPIntegration::get();
                 $integration->protocolVersion = $This::getProtocolVersion();
             }
         );
@@ -72,7 +73,8 @@ class AMQPIntegration extends Integration
             "PhpAmqpLib\Channel\AMQPChannel",
             "basic_deliver",
             [
-                'prehook' => function (SpanData $span, $args) use ($integration, &$newTrace) {
+                'prehook' => static function (SpanData $span, $args) use (&$newTrace) {
+                    $integration = AMQPIntegration::get();
                     /** @var AMQPMessage $message */
                     $message = $args[1];
                     if ($integration->hasDistributedHeaders($message)) {
@@ -82,7 +84,8 @@ class AMQPIntegration extends Integration
                         $newTrace->links[] = $span->getLink();
                     }
                 },
-                'posthook' => function (SpanData $span, $args) use ($integration, &$newTrace) {
+                'posthook' => static function (SpanData $span, $args) use (&$newTrace) {
+                    $integration = AMQPIntegration::get();
                     /** @var AMQPMessage $message */
                     $message = $args[1];
 
@@ -129,14 +132,16 @@ class AMQPIntegration extends Integration
             "PhpAmqpLib\Channel\AMQPChannel",
             "basic_publish",
             [
-                'prehook' => function (SpanData $span, $args) use ($integration) {
+                'prehook' => static function (SpanData $span, $args) {
+                    $integration = AMQPIntegration::get();
                     /** @var AMQPMessage $message */
                     $message = $args[0];
                     if (!is_null($message)) {
                         $integration->injectContext($message);
                     }
                 },
-                'posthook' => function (SpanData $span, $args, $exception) use ($integration) {
+                'posthook' => static function (SpanData $span, $args, $exception) {
+                    $integration = AMQPIntegration::get();
                     /** @var AMQPMessage $message */
                     $message = $args[0];
                     /** @var string $exchange */
@@ -171,14 +176,16 @@ class AMQPIntegration extends Integration
             "PhpAmqpLib\Channel\AMQPChannel",
             "batch_basic_publish",
             [
-                'prehook' => function (SpanData $span, $args) use ($integration) {
+                'prehook' => static function (SpanData $span, $args) {
+                    $integration = AMQPIntegration::get();
                     /** @var AMQPMessage $message */
                     $message = $args[0];
                     if (!is_null($message)) {
                         $integration->injectContext($message);
                     }
                 },
-                'posthook' => function (SpanData $span, $args, $exception) use ($integration) {
+                'posthook' => static function (SpanData $span, $args, $exception) {
+                    $integration = AMQPIntegration::get();
                     /** @var AMQPMessage $message */
                     $message = $args[0];
                     /** @var string $exchange */
@@ -211,7 +218,8 @@ class AMQPIntegration extends Integration
         trace_method(
             "PhpAmqpLib\Channel\AMQPChannel",
             "publish_batch",
-            function (SpanData $span, $args, $exception) use ($integration) {
+            static function (SpanData $span, $args, $exception) {
+                $integration = AMQPIntegration::get();
                 $integration->setGenericTags(
                     $span,
                     'publish_batch',
@@ -226,7 +234,8 @@ class AMQPIntegration extends Integration
         trace_method(
             "PhpAmqpLib\Channel\AMQPChannel",
             "basic_consume",
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var string $queue */
                 $queue = $args[0];
                 /** @var string $consumer_tag */
@@ -250,7 +259,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'exchange_declare',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var string $exchange */
                 $exchange = $args[0];
 
@@ -270,7 +280,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'queue_declare',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var string $queue */
                 $queue = $args[0];
                 if (empty($queue) && is_array($retval)) {
@@ -293,7 +304,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'queue_bind',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
 
                 /** @var string $queue */
                 $queue = $args[0];
@@ -323,7 +335,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'basic_consume_ok',
-            function (SpanData $span) use ($integration) {
+            static function (SpanData $span) {
+                $integration = AMQPIntegration::get();
                 $integration->setGenericTags($span, 'basic.consume_ok', 'server');
 
                 $span->meta[Tag::MQ_OPERATION] = 'process';
@@ -333,7 +346,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'basic_cancel',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var string $consumerTag */
                 $consumerTag = $args[0];
 
@@ -351,7 +365,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'basic_cancel_ok',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 $integration->setGenericTags($span, 'basic.cancel_ok', 'server', null, $exception);
             }
         );
@@ -359,7 +374,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Connection\AbstractConnection',
             'connect',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 $integration->setGenericTags($span, 'connect', 'client', null, $exception);
             }
         );
@@ -367,7 +383,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Connection\AbstractConnection',
             'reconnect',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 $integration->setGenericTags($span, 'reconnect', 'client', null, $exception);
             }
         );
@@ -375,7 +392,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'basic_ack',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var int $deliveryTag */
                 $deliveryTag = $args[0];
 
@@ -386,7 +404,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'basic_nack',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var int $deliveryTag */
                 $deliveryTag = $args[0];
 
@@ -397,7 +416,8 @@ class AMQPIntegration extends Integration
         trace_method(
             'PhpAmqpLib\Channel\AMQPChannel',
             'basic_get',
-            function (SpanData $span, $args, $message, $exception) use ($integration) {
+            static function (SpanData $span, $args, $message, $exception) {
+                $integration = AMQPIntegration::get();
                 /** @var string $queue */
                 $queue = $args[0];
 
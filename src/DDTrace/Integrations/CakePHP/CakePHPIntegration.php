@@ -30,7 +30,8 @@ class CakePHPIntegration extends Integration
     {
         $integration = $this;
 
-        $integration->setRootSpanInfoFn = function () use ($integration) {
+        $integration->setRootSpanInfoFn = static function () {
+            $integration = CakePHPIntegration::get();
             $rootSpan = \DDTrace\root_span();
             if ($rootSpan === null) {
                 return;
@@ -51,21 +52,24 @@ class CakePHPIntegration extends Integration
             $rootSpan->meta[Tag::COMPONENT] = CakePHPIntegration::NAME;
         };
 
-        $integration->handleExceptionFn = function ($This, $scope, $args) use ($integration) {
+        $integration->handleExceptionFn = static function ($This, $scope, $args) {
+            $integration = CakePHPIntegration::get();
             $rootSpan = \DDTrace\root_span();
             if ($rootSpan !== null) {
                 $rootSpan->exception = $args[0];
             }
         };
 
-        $integration->setStatusCodeFn =  function ($This, $scope, $args, $retval) use ($integration) {
+        $integration->setStatusCodeFn =  static function ($This, $scope, $args, $retval) {
+            $integration = CakePHPIntegration::get();
             $rootSpan = \DDTrace\root_span();
             if ($rootSpan) {
                 $rootSpan->meta[Tag::HTTP_STATUS_CODE] = $retval;
             }
         };
 
-        $integration->parseRouteFn = function ($app, $appClass, $args, $retval) use ($integration) {
+        $integration->parseRouteFn = static function ($app, $appClass, $args, $retval) {
+            $integration = CakePHPIntegration::get();
             if (!$retval) {
                 return;
             }
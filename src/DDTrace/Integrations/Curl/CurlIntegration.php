@@ -40,7 +40,8 @@ final class CurlIntegration extends Integration
         \DDTrace\trace_function('curl_exec', [
             // the ddtrace extension will handle distributed headers
             'instrument_when_limited' => 0,
-            'posthook' => function (SpanData $span, $args, $retval) use ($integration) {
+            'posthook' => static function (SpanData $span, $args, $retval) {
+                $integration = CurlIntegration::get();
                 $integration->setup_curl_span($span);
 
                 if (!isset($args[0])) {
@@ -59,7 +60,8 @@ final class CurlIntegration extends Integration
         ]);
 
         $lastMh = [0, null];
-        \DDTrace\install_hook('curl_multi_exec', function (HookData $hook) use ($integration, &$lastMh) {
+        \DDTrace\install_hook('curl_multi_exec', static function (HookData $hook) use (&$lastMh) {
+            $integration = CurlIntegration::get();
             if (\count($hook->args) >= 2) {
                 $data = null;
                 if (\PHP_MAJOR_VERSION > 7) {
@@ -90,7 +92,8 @@ final class CurlIntegration extends Integration
             Integration::handleInternalSpanServiceName($span, CurlIntegration::NAME);
             $span->meta[Tag::COMPONENT] = CurlIntegration::NAME;
             $span->peerServiceSources = HttpClientIntegrationHelper::PEER_SERVICE_SOURCES;
-        }, function (HookData $hook) use ($integration, &$lastMh) {
+        }, static function (HookData $hook) use (&$lastMh) {
+            $integration = CurlIntegration::get();
             if (empty($hook->data) || $hook->exception) {
                 return;
             }
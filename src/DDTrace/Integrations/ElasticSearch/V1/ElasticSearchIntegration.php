@@ -19,7 +19,8 @@ class ElasticSearchIntegration extends Integration
         // Dynamically generate namespace traces to ensure forward compatibility with future ES versions
         $integration = $this;
         \DDTrace\trace_method('Elasticsearch\Client', '__construct', [
-            "posthook" => function (SpanData $span) use (&$constructorCalled, $integration) {
+            "posthook" => function (SpanData $span) use (&$constructorCalled) {
+                $integration = ElasticSearchIntegration::get();
                 if (!$constructorCalled) {
                     $nsPattern = "(^Elasticsearch\\\\Namespaces\\\\([^\\\\]+Namespace)$)";
                     foreach ($this as $property) {
@@ -151,7 +152,8 @@ class ElasticSearchIntegration extends Integration
             $class,
             $name,
             [
-                'prehook' => function (SpanData $span, $args) use ($name, $isTraceAnalyticsCandidate, $integration) {
+                'prehook' => static function (SpanData $span, $args) use ($name, $isTraceAnalyticsCandidate) {
+                    $integration = ElasticSearchIntegration::get();
                     $span->name = "Elasticsearch.Client.$name";
 
                     if ($isTraceAnalyticsCandidate) {
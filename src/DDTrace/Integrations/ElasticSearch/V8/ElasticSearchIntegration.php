@@ -23,10 +23,12 @@ class ElasticSearchIntegration extends Integration
         // Dynamically generate namespace traces to ensure forward compatibility with future ES versions
         $integration = $this;
         \DDTrace\trace_method('Elastic\Elasticsearch\Client', '__construct', [
-            "posthook" => function (SpanData $span) use (&$constructorCalled, $integration) {
+            "posthook" => static function (SpanData $span) use (&$constructorCalled) {
+                $integration = ElasticSearchIntegration::get();
                 if (!$constructorCalled) {
                     foreach (get_class_methods('Elastic\Elasticsearch\Traits\NamespaceTrait') as $method) {
-                        $hook = function (HookData $hook) use ($integration, $method) {
+                        $hook = static function (HookData $hook) use ($method) {
+                            $integration = ElasticSearchIntegration::get();
                             $ret = $hook->returned;
                             \DDTrace\remove_hook($hook->id);
                             $class = get_class($ret);
@@ -77,7 +79,8 @@ class ElasticSearchIntegration extends Integration
         $this->traceSimpleMethod('Elastic\Transport\Serializer\XmlSerializer', 'unserialize');
 
         // Endpoints
-        $hook = function ($span, $args) use ($integration) {
+        $hook = static function ($span, $args) {
+            $integration = ElasticSearchIntegration::get();
             $span->name = "Elasticsearch.Endpoint.performRequest";
             $span->resource = 'performRequest';
             Integration::handleInternalSpanServiceName($span, ElasticSearchIntegration::NAME);
@@ -129,7 +132,8 @@ class ElasticSearchIntegration extends Integration
             $class,
             $name,
             [
-                'prehook' => function (SpanData $span, $args) use ($name, $isTraceAnalyticsCandidate, $integration) {
+                'prehook' => static function (SpanData $span, $args) use ($name, $isTraceAnalyticsCandidate) {
+                    $integration = ElasticSearchIntegration::get();
                     $span->name = "Elasticsearch.Client.$name";
 
                     if ($isTraceAnalyticsCandidate) {
@@ -143,7 +147,8 @@ class ElasticSearchIntegration extends Integration
                     $span->resource = ElasticSearchCommon::buildResourceName($name, isset($args[0]) ? $args[0] : []);
                     $span->meta[Tag::COMPONENT] = ElasticSearchIntegration::NAME;
                 },
-                'posthook' => function () use ($integration) {
+                'posthook' => static function () {
+                    $integration = ElasticSearchIntegration::get();
                     $integration->logNextBody = false;
                 }
             ]
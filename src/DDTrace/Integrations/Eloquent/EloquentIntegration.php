@@ -26,7 +26,8 @@ class EloquentIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Database\Eloquent\Builder',
             'getModels',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = EloquentIntegration::get();
                 $span->name = 'eloquent.get';
                 $sql = $this->getQuery()->toSql();
                 $span->resource = $sql;
@@ -38,7 +39,8 @@ class EloquentIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Database\Eloquent\Model',
             'performInsert',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = EloquentIntegration::get();
                 $span->name = 'eloquent.insert';
                 $span->resource = get_class($this);
                 $integration->setCommonValues($span);
@@ -48,7 +50,8 @@ class EloquentIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Database\Eloquent\Model',
             'performUpdate',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = EloquentIntegration::get();
                 $span->name = 'eloquent.update';
                 $span->resource = get_class($this);
                 $integration->setCommonValues($span);
@@ -58,7 +61,8 @@ class EloquentIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Database\Eloquent\Model',
             'delete',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = EloquentIntegration::get();
                 $span->name = 'eloquent.delete';
                 $span->resource = get_class($this);
                 $integration->setCommonValues($span);
@@ -68,7 +72,8 @@ class EloquentIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Database\Eloquent\Model',
             'destroy',
-            function (SpanData $span) use ($integration) {
+            static function (SpanData $span) {
+                $integration = EloquentIntegration::get();
                 $span->name = 'eloquent.destroy';
                 $span->resource = get_called_class();
                 $integration->setCommonValues($span);
@@ -78,7 +83,8 @@ class EloquentIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Database\Eloquent\Model',
             'refresh',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = EloquentIntegration::get();
                 $span->name = 'eloquent.refresh';
                 $span->resource = get_class($this);
                 $integration->setCommonValues($span);
@@ -29,7 +29,8 @@ class FrankenphpIntegration extends Integration
         ini_set("datadog.trace.generate_root_span", 0);
 
         $is_hooked = new \WeakMap();
-        \DDTrace\install_hook('frankenphp_handle_request', function (HookData $hook) use ($integration, $is_hooked) {
+        \DDTrace\install_hook('frankenphp_handle_request', static function (HookData $hook) use ($is_hooked) {
+            $integration = FrankenphpIntegration::get();
             $handler = $hook->args[0];
             if (isset($is_hooked[$handler])) {
                 return;
@@ -38,7 +39,8 @@ class FrankenphpIntegration extends Integration
 
             \DDTrace\install_hook(
                 $handler,
-                function (HookData $hook) use ($integration) {
+                static function (HookData $hook) {
+                    $integration = FrankenphpIntegration::get();
                     $rootSpan = $hook->span(new SpanStack());
                     $rootSpan->name = "web.request";
                     $rootSpan->service = \ddtrace_config_app_name('frankenphp');
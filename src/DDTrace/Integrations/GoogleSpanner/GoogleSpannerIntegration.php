@@ -20,7 +20,8 @@ class GoogleSpannerIntegration extends Integration
     {
         $integration = $this;
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\SpannerClient', 'instance', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\SpannerClient', 'instance', function (SpanData $span, $args) {
+            $integration = GoogleSpannerIntegration::get();
             $instanceName =$args[0];
             $span->meta[Tag::DB_INSTANCE] = $instanceName;
             $integration->setDefaultAttributes($span, 'google_spanner.instance', $args[0]);
@@ -28,7 +29,8 @@ class GoogleSpannerIntegration extends Integration
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Instance', 'database', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Instance', 'database', function (SpanData $span, $args) {
+            $integration = GoogleSpannerIntegration::get();
             $dbName =$args[0];
             $span->meta[Tag::DB_NAME] = $dbName;
             $integration->setDefaultAttributes($span, 'google_spanner.database', $args[0]);
@@ -36,33 +38,39 @@ class GoogleSpannerIntegration extends Integration
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Database', 'execute', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Database', 'execute', function (SpanData $span, $args) {
+            $integration = GoogleSpannerIntegration::get();
             $span->meta[Tag::DB_NAME] = $this->name();
             $integration->setDefaultAttributes($span, 'google_spanner.execute', $args[0]);
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Database', 'runTransaction', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Database', 'runTransaction', static function (SpanData $span, $args) {
+            $integration = GoogleSpannerIntegration::get();
             $integration->setDefaultAttributes($span, 'google_spanner.run_transaction', 'transaction');
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Database', 'transaction', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Database', 'transaction', static function (SpanData $span, $args) {
+            $integration = GoogleSpannerIntegration::get();
             $integration->setDefaultAttributes($span, 'google_spanner.transaction', 'transaction');
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Transaction', 'commit', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Transaction', 'commit', static function (SpanData $span) {
+            $integration = GoogleSpannerIntegration::get();
             $integration->setDefaultAttributes($span, 'google_spanner.commit', "commit");
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Transaction', 'executeUpdate', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Transaction', 'executeUpdate', static function (SpanData $span, $args) {
+            $integration = GoogleSpannerIntegration::get();
             $integration->setDefaultAttributes($span, 'google_spanner.execute_update', $args[0]);
             $integration->addTraceAnalyticsIfEnabled($span);
         });
 
-        \DDTrace\trace_method('Google\Cloud\Spanner\Transaction', 'executeUpdateBatch', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_method('Google\Cloud\Spanner\Transaction', 'executeUpdateBatch', static function (SpanData $span) {
+            $integration = GoogleSpannerIntegration::get();
             $integration->setDefaultAttributes($span, 'google_spanner.execute_update_batch', 'execute_update_batch');
             $integration->addTraceAnalyticsIfEnabled($span);
         });
@@ -25,7 +25,8 @@ class GuzzleIntegration extends Integration
         \DDTrace\trace_method(
             'GuzzleHttp\Client',
             'send',
-            function (SpanData $span, $args, $retval) use ($integration) {
+            static function (SpanData $span, $args, $retval) {
+                $integration = GuzzleIntegration::get();
                 $span->resource = 'send';
                 $span->name = 'GuzzleHttp\Client.send';
                 Integration::handleInternalSpanServiceName($span, GuzzleIntegration::NAME);
@@ -67,7 +68,8 @@ class GuzzleIntegration extends Integration
         \DDTrace\trace_method(
             'GuzzleHttp\Client',
             'transfer',
-            function (SpanData $span, $args, $retval) use ($integration) {
+            static function (SpanData $span, $args, $retval) {
+                $integration = GuzzleIntegration::get();
                 $span->resource = 'transfer';
                 $span->name = 'GuzzleHttp\Client.transfer';
                 Integration::handleInternalSpanServiceName($span, GuzzleIntegration::NAME);
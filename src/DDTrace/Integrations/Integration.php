@@ -8,6 +8,29 @@ use DDTrace\Tag;
 
 abstract class Integration implements \DDTrace\Integration
 {
+    /**
+     * @var Integration[] The integrations loaded in the current request, by class
+     */
+    private static $instances = [];
+
+    public function __construct()
+    {
+        if (!isset(self::$instances[static::class])) {
+            self::$instances[static::class] = $this;
+        }
+    }
+
+    /**
+     * The instance of this integration in the current request. Hook closures fetch it from here rather than
+     * capturing it, so that they can be static and the extension may install them again without running init().
+     *
+     * @return static
+     */
+    public static function get()
+    {
+        return isset(self::$instances[static::class]) ? self::$instances[static::class] : new static();
+    }
+
     /**
      * @return string The integration name.
      */
@@ -170,7 +170,8 @@ class LaminasIntegration extends Integration
         trace_method(
             'Laminas\Mvc\Application',
             'init',
-            function (SpanData $span) use ($integration) {
+            static function (SpanData $span) {
+                $integration = LaminasIntegration::get();
                 $span->name = 'laminas.application.init';
                 $span->resource = 'laminas.application.init';
                 $span->type = Type::WEB_SERVLET;
@@ -306,7 +307,8 @@ class LaminasIntegration extends Integration
             'Laminas\Mvc\Controller\AbstractController',
             'onDispatch',
             null,
-            function ($This, $score, $args) use ($integration) {
+            static function ($This, $score, $args) {
+                $integration = LaminasIntegration::get();
                 $rootSpan = root_span();
                 if ($rootSpan === null) {
                     return false;
@@ -326,7 +328,8 @@ class LaminasIntegration extends Integration
         trace_method(
             'Laminas\Mvc\Application',
             'completeRequest',
-            function (SpanData $span, $args) use ($integration) {
+            static function (SpanData $span, $args) {
+                $integration = LaminasIntegration::get();
                 $span->name = 'laminas.application.completeRequest';
                 $span->service = \ddtrace_config_app_name('laminas');
                 $span->type = Type::WEB_SERVLET;
@@ -390,7 +393,8 @@ class LaminasIntegration extends Integration
         trace_method(
             'Laminas\Mvc\View\Http\DefaultRenderingStrategy',
             'render',
-            function (SpanData $span, $args) use ($integration) {
+            function (SpanData $span, $args) {
+                $integration = LaminasIntegration::get();
                 $span->name = 'laminas.view.http.renderer';
                 $span->service = \ddtrace_config_app_name('laminas');
                 $span->type = Type::WEB_SERVLET;
@@ -410,7 +414,8 @@ class LaminasIntegration extends Integration
         trace_method(
             'Laminas\Mvc\View\Console\DefaultRenderingStrategy',
             'render',
-            function (SpanData $span, $args) use ($integration) {
+            function (SpanData $span, $args) {
+                $integration = LaminasIntegration::get();
                 $span->name = 'laminas.view.console.renderer';
                 $span->service = \ddtrace_config_app_name('laminas');
                 $span->type = Type::WEB_SERVLET;
@@ -431,7 +436,8 @@ class LaminasIntegration extends Integration
         trace_method(
             'Laminas\Mvc\MvcEvent',
             'setError',
-            function (SpanData $span, $args, $retval) use ($integration) {
+            static function (SpanData $span, $args, $retval) {
+                $integration = LaminasIntegration::get();
                 $span->name = 'laminas.mvcEvent.setError';
                 $span->service = \ddtrace_config_app_name('laminas');
                 $span->type = Type::WEB_SERVLET;
@@ -487,7 +493,8 @@ class LaminasIntegration extends Integration
         hook_method(
             'Laminas\ApiTools\Rest\AbstractResourceListener',
             'dispatch',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaminasIntegration::get();
                 $rootSpan = root_span();
                 if ($rootSpan === null) {
                     return false;
@@ -521,7 +528,8 @@ class LaminasIntegration extends Integration
         // ApiProblem
         install_hook(
             'Laminas\ApiTools\ApiProblem\ApiProblem::__construct',
-            function (HookData $hook) use ($integration) {
+            function (HookData $hook) {
+                $integration = LaminasIntegration::get();
                 $args = $hook->args;
                 $detail = $args[1] ?? null;
                 $activeSpan = active_span();
@@ -551,7 +559,8 @@ class LaminasIntegration extends Integration
             'Laminas\ApiTools\ApiProblem\Listener\SendApiProblemResponseListener',
             'sendContent',
             null,
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaminasIntegration::get();
                 $rootSpan = root_span();
                 if ($rootSpan === null) {
                     return;
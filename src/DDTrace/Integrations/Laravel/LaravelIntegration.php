@@ -60,7 +60,8 @@ class LaravelIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Foundation\Application',
             'handle',
-            function (SpanData $span, $args, $response) use ($integration) {
+            static function (SpanData $span, $args, $response) {
+                $integration = LaravelIntegration::get();
                 $span->name = 'laravel.application.handle';
                 $span->type = Type::WEB_SERVLET;
                 $span->service = $integration->getServiceName();
@@ -84,7 +85,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Illuminate\Contracts\Foundation\Application',
             'bootstrapWith',
-            function ($app) use ($integration) {
+            static function ($app) {
+                $integration = LaravelIntegration::get();
                 $integration->serviceName = ddtrace_config_app_name();
                 if (empty($integration->serviceName) && file_exists($app->environmentPath() . '/' . $app->environmentFile())) {
                     $app->make('Illuminate\Foundation\Bootstrap\LoadEnvironmentVariables')->bootstrap($app);
@@ -101,7 +103,8 @@ class LaravelIntegration extends Integration
             'Illuminate\Routing\Router',
             'findRoute',
             null,
-            function ($This, $scope, $args, $route) use ($integration) {
+            static function ($This, $scope, $args, $route) {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null) {
                     return;
@@ -145,7 +148,8 @@ class LaravelIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Routing\Route',
             'run',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = LaravelIntegration::get();
                 $span->name = 'laravel.action';
                 $span->type = Type::WEB_SERVLET;
                 $span->service = $integration->getServiceName();
@@ -157,7 +161,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Illuminate\Http\Response',
             'send',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null) {
                     return;
@@ -175,7 +180,8 @@ class LaravelIntegration extends Integration
             'Illuminate\Events\Dispatcher',
             'fire',
             [
-                'prehook' => function (SpanData $span, $args) use ($integration) {
+                'prehook' => static function (SpanData $span, $args) {
+                    $integration = LaravelIntegration::get();
                     Integration::handleOrphan($span);
 
                     $span->name = 'laravel.event.handle';
@@ -212,7 +218,8 @@ class LaravelIntegration extends Integration
             'Illuminate\Events\Dispatcher',
             'dispatch',
             [
-                'prehook' => function (SpanData $span, $args) use ($integration) {
+                'prehook' => static function (SpanData $span, $args) {
+                    $integration = LaravelIntegration::get();
                     Integration::handleOrphan($span);
 
                     $span->name = 'laravel.event.handle';
@@ -225,7 +232,8 @@ class LaravelIntegration extends Integration
             ]
         );
 
-        \DDTrace\trace_method('Illuminate\View\View', 'render', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_method('Illuminate\View\View', 'render', function (SpanData $span) {
+            $integration = LaravelIntegration::get();
             $span->name = 'laravel.view.render';
             $span->type = Type::WEB_SERVLET;
             $span->service = $integration->getServiceName();
@@ -236,7 +244,8 @@ class LaravelIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\View\Engines\CompilerEngine',
             'get',
-            function (SpanData $span, $args) use ($integration) {
+            static function (SpanData $span, $args) {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
 
                 // This is used by both laravel and lumen. For consistency we rename it for lumen traces as otherwise
@@ -256,7 +265,8 @@ class LaravelIntegration extends Integration
         \DDTrace\trace_method(
             'Illuminate\Foundation\ProviderRepository',
             'load',
-            function (SpanData $span) use ($integration) {
+            static function (SpanData $span) {
+                $integration = LaravelIntegration::get();
                 $serviceName = $integration->getServiceName();
 
                 $span->name = 'laravel.provider.load';
@@ -277,7 +287,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Illuminate\Console\Application',
             '__construct',
-            function () use ($integration) {
+            static function () {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null) {
                     return;
@@ -295,7 +306,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Symfony\Component\Console\Application',
             'renderException',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan !== null) {
                     $rootSpan->exception = $args[0];
@@ -308,7 +320,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Symfony\Component\Console\Application',
             'renderThrowable',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan !== null) {
                     $rootSpan->exception = $args[0];
@@ -320,7 +333,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Illuminate\Contracts\Debug\ExceptionHandler',
             'report',
-            function ($exceptionHandler, $scope, $args) use ($integration) {
+            static function ($exceptionHandler, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null) {
                     return;
@@ -340,7 +354,8 @@ class LaravelIntegration extends Integration
             'Illuminate\Auth\SessionGuard',
             'attempt',
             null,
-            function ($This, $scope, $args, $loginSuccess) use ($integration) {
+            static function ($This, $scope, $args, $loginSuccess) {
+                $integration = LaravelIntegration::get();
                 if ($loginSuccess || !function_exists('\datadog\appsec\track_user_login_failure_event')) {
                     return;
                 }
@@ -352,7 +367,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Illuminate\Auth\Events\Login',
             '__construct',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $authClass = 'Illuminate\Contracts\Auth\Authenticatable';
                 if (
                     !function_exists('\datadog\appsec\track_user_login_success_event') ||
@@ -381,7 +397,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Illuminate\Auth\Guard',
             'login',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $authClass = 'Illuminate\Auth\UserInterface';
                 if (
                     !function_exists('\datadog\appsec\track_user_login_success_event') ||
@@ -413,7 +430,8 @@ class LaravelIntegration extends Integration
             'Illuminate\Auth\Guard',
             'attempt',
             null,
-            function ($This, $scope, $args, $loginSuccess) use ($integration) {
+            static function ($This, $scope, $args, $loginSuccess) {
+                $integration = LaravelIntegration::get();
                 if ($loginSuccess || !function_exists('\datadog\appsec\track_user_login_failure_event')) {
                     return;
                 }
@@ -425,7 +443,8 @@ class LaravelIntegration extends Integration
             'Illuminate\Auth\Events\Registered',
             '__construct',
             null,
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = LaravelIntegration::get();
                 $authClass = 'Illuminate\Contracts\Auth\Authenticatable';
                 if (
                     !function_exists('\datadog\appsec\track_user_signup_event') ||
@@ -447,7 +466,8 @@ class LaravelIntegration extends Integration
         \DDTrace\hook_method(
             'Laravel\Octane\Worker',
             'handle',
-            function () use ($integration) {
+            static function () {
+                $integration = LaravelIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null) {
                     return;
@@ -61,7 +61,8 @@ class LaravelQueueIntegration extends Integration
             'Illuminate\Queue\Worker',
             'process',
             [
-                'prehook' => function (SpanData $span, $args) use ($integration, &$newTrace) {
+                'prehook' => static function (SpanData $span, $args) use (&$newTrace) {
+                    $integration = LaravelQueueIntegration::get();
                     /** @var Job $job */
                     $job = $args[1];
 
@@ -80,7 +81,8 @@ class LaravelQueueIntegration extends Integration
                         }
                     }
                 },
-                'posthook' => function (SpanData $span, $args, $retval, $exception) use ($integration, &$newTrace) {
+                'posthook' => static function (SpanData $span, $args, $retval, $exception) use (&$newTrace) {
+                    $integration = LaravelQueueIntegration::get();
                     /** @var Job $job */
                     $job = $args[1];
 
@@ -128,7 +130,8 @@ class LaravelQueueIntegration extends Integration
             'Illuminate\Queue\Worker',
             'maxAttemptsExceededException',
             null,
-            function ($worker, $scope, $args, $retval) use ($integration) {
+            static function ($worker, $scope, $args, $retval) {
+                $integration = LaravelQueueIntegration::get();
                 if (($rootSpan = \DDTrace\root_span()) !== null) {
                     $rootSpan->exception = $retval;
                 }
@@ -139,10 +142,12 @@ class LaravelQueueIntegration extends Integration
             'Illuminate\Queue\Jobs\Job',
             'fire',
             [
-                'prehook' => function (SpanData $span, $args, $retval) use ($integration) {
+                'prehook' => function (SpanData $span, $args, $retval) {
+                    $integration = LaravelQueueIntegration::get();
                     $integration->setSpanAttributes($span, 'laravel.queue.fire', 'process', $this);
                 },
-                'posthook' => function (SpanData $span, $args, $retval, $exception) use ($integration) {
+                'posthook' => static function (SpanData $span, $args, $retval, $exception) {
+                    $integration = LaravelQueueIntegration::get();
                     if ($exception) {
                         $span->exception = $exception;
                     }
@@ -152,7 +157,8 @@ class LaravelQueueIntegration extends Integration
 
         install_hook(
             'Illuminate\Queue\Jobs\Job::fire',
-            function (HookData $fireHook) use ($integration) {
+            function (HookData $fireHook) {
+                $integration = LaravelQueueIntegration::get();
                 /** @var \Illuminate\Queue\Jobs\Job $this */
                 $payload = $this->payload();
                 list($class, $method) = JobName::parse($payload['job']);
@@ -164,7 +170,8 @@ class LaravelQueueIntegration extends Integration
 
                 $fireHook->data['id'] = install_hook(
                     "$class::$method",
-                    function (HookData $hook) use ($integration, $class, $method, $fireHook) {
+                    function (HookData $hook) use ($class, $method, $fireHook) {
+                        $integration = LaravelQueueIntegration::get();
                         $span = $hook->span();
                         $span->name = 'laravel.queue.action';
                         $span->type = 'queue';
@@ -200,7 +207,8 @@ class LaravelQueueIntegration extends Integration
         trace_method(
             'Illuminate\Queue\Jobs\Job',
             'resolve',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            function (SpanData $span, $args, $retval, $exception) {
+                $integration = LaravelQueueIntegration::get();
                 $integration->setSpanAttributes($span, 'laravel.queue.resolve', 'process', $this, $exception);
             }
         );
@@ -209,7 +217,8 @@ class LaravelQueueIntegration extends Integration
         trace_method(
             'Illuminate\Queue\Queue',
             'enqueueUsing',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, $args, $retval, $exception) {
+                $integration = LaravelQueueIntegration::get();
                 $integration->setSpanAttributes(
                     $span,
                     'laravel.queue.enqueueUsing',
@@ -224,7 +233,8 @@ class LaravelQueueIntegration extends Integration
         install_hook(
             'Illuminate\Queue\Queue::createPayload',
             null,
-            function (HookData $hook) use ($integration) {
+            static function (HookData $hook) {
+                $integration = LaravelQueueIntegration::get();
                 // $hook->returned, a.k.a. the payload, should be a json encoded string
                 // Decode it, add the distributed tracing headers, re-encode it, return this one instead
                 $payload = $integration->injectContext(json_decode($hook->returned, true));
@@ -235,7 +245,8 @@ class LaravelQueueIntegration extends Integration
         trace_method(
             'Illuminate\Contracts\Queue\Queue',
             'push',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            function (SpanData $span, $args, $retval, $exception) {
+                $integration = LaravelQueueIntegration::get();
                 $integration->setSpanAttributes(
                     $span,
                     'laravel.queue.push',
@@ -251,7 +262,8 @@ class LaravelQueueIntegration extends Integration
         trace_method(
             'Illuminate\Contracts\Queue\Queue',
             'later',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            function (SpanData $span, $args, $retval, $exception) {
+                $integration = LaravelQueueIntegration::get();
                 $integration->setSpanAttributes(
                     $span,
                     'laravel.queue.later',
@@ -268,7 +280,8 @@ class LaravelQueueIntegration extends Integration
         trace_method(
             'Illuminate\Bus\Batch',
             'add',
-            function (SpanData $span, $args, $retval, $exception) use ($integration) {
+            function (SpanData $span, $args, $retval, $exception) {
+                $integration = LaravelQueueIntegration::get();
                 $integration->setSpanAttributes(
                     $span,
                     'laravel.queue.batch.add',
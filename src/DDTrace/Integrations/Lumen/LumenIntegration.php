@@ -44,7 +44,8 @@ class LumenIntegration extends Integration
         \DDTrace\trace_method(
             'Laravel\Lumen\Application',
             'prepareRequest',
-            function (SpanData $span, $args) use ($integration, $appName) {
+            static function (SpanData $span, $args) use ($appName) {
+                $integration = LumenIntegration::get();
                 $span->meta[Tag::COMPONENT] = LumenIntegration::NAME;
 
                 $rootSpan = \DDTrace\root_span();
@@ -101,7 +102,8 @@ class LumenIntegration extends Integration
             ]
         );
 
-        $exceptionRender = function (SpanData $span, $args) use ($appName, $integration) {
+        $exceptionRender = static function (SpanData $span, $args) use ($appName) {
+            $integration = LumenIntegration::get();
             $span->service = $appName;
             $span->type = 'web';
             if (count($args) < 1 || !\is_a($args[0], 'Throwable')) {
@@ -543,7 +543,8 @@ class MagentoIntegration extends Integration
         trace_method(
             'Magento\Framework\View\Element\AbstractBlock',
             'toHtml',
-            function (SpanData $span) use ($integration) {
+            function (SpanData $span) {
+                $integration = MagentoIntegration::get();
                 MagentoIntegration::setCommonSpanInfo($span, 'magento.block.render');
 
                 /** @var \Magento\Framework\View\Element\AbstractBlock $block */
@@ -601,7 +602,8 @@ class MagentoIntegration extends Integration
             'Magento\Framework\AppInterface',
             'catchException',
             null,
-            function ($http, $scope, $args) use ($integration) {
+            static function ($http, $scope, $args) {
+                $integration = MagentoIntegration::get();
                 $rootSpan = root_span();
                 if ($rootSpan !== null) {
                     $rootSpan->exception = $args[1];
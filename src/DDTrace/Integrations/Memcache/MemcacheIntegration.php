@@ -50,10 +50,12 @@ class MemcacheIntegration extends Integration
         $this->traceCommand('prepend');
         $this->traceCommand('replace');
 
-        \DDTrace\trace_method('Memcache', 'flush', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_method('Memcache', 'flush', static function (SpanData $span) {
+            $integration = MemcacheIntegration::get();
             $integration->setCommonData($span, 'flush');
         });
-        \DDTrace\trace_function('memcache_flush', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_function('memcache_flush', static function (SpanData $span) {
+            $integration = MemcacheIntegration::get();
             $integration->setCommonData($span, 'flush');
         });
 
@@ -70,7 +72,8 @@ class MemcacheIntegration extends Integration
         \DDTrace\hook_function('memcache_pconnect', $this->wrapClosureForHookFunction($memcache_addServer));
         \DDTrace\hook_method('Memcache', 'pconnect', $memcache_addServer);
 
-        $memcache_cas = function (SpanData $span, $args) use ($integration) {
+        $memcache_cas = function (SpanData $span, $args) {
+            $integration = MemcacheIntegration::get();
             $integration->setCommonData($span, 'cas');
             if (isset($args[4])) {
                 $span->meta['memcache.cas_token'] = $args[4];
@@ -90,7 +93,8 @@ class MemcacheIntegration extends Integration
     public function traceCommand($command)
     {
         $integration = $this;
-        $trace = function (SpanData $span, $args, $retval) use ($integration, $command) {
+        $trace = function (SpanData $span, $args, $retval) use ($command) {
+            $integration = MemcacheIntegration::get();
             $integration->setCommonData($span, $command);
             if ($command === 'get') {
                 $span->metrics[Tag::DB_ROW_COUNT] = empty($retval) ? 0 : 1;
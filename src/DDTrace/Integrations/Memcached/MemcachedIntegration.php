@@ -85,13 +85,15 @@ class MemcachedIntegration extends Integration
         $this->traceCommand('touch');
         $this->traceCommandByKey('touchByKey');
 
-        \DDTrace\trace_method('Memcached', 'flush', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_method('Memcached', 'flush', function (SpanData $span) {
+            $integration = MemcachedIntegration::get();
             $integration->setCommonData($span, 'flush');
             $span->peerServiceSources = DatabaseIntegrationHelper::PEER_SERVICE_SOURCES;
             $integration->setServerTags($span, $this);
         });
 
-        \DDTrace\trace_method('Memcached', 'cas', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Memcached', 'cas', function (SpanData $span, $args) {
+            $integration = MemcachedIntegration::get();
             $integration->setCommonData($span, 'cas');
             $span->meta['memcached.cas_token'] = $args[0];
             $span->meta['memcached.query'] = 'cas ?';
@@ -99,7 +101,8 @@ class MemcachedIntegration extends Integration
             $integration->setServerTags($span, $this);
         });
 
-        \DDTrace\trace_method('Memcached', 'casByKey', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Memcached', 'casByKey', function (SpanData $span, $args) {
+            $integration = MemcachedIntegration::get();
             $integration->setCommonData($span, 'casByKey');
             $span->meta['memcached.cas_token'] = $args[0];
             $span->meta['memcached.query'] = 'casByKey ?';
@@ -118,7 +121,8 @@ class MemcachedIntegration extends Integration
         \DDTrace\trace_method(
             'Memcached',
             $command,
-            function (SpanData $span, $args, $retval) use ($integration, $command) {
+            function (SpanData $span, $args, $retval) use ($command) {
+                $integration = MemcachedIntegration::get();
                 $integration->setCommonData($span, $command);
                 if ($command === 'get') {
                     $span->metrics[Tag::DB_ROW_COUNT] = empty($retval) ? 0 : 1;
@@ -140,7 +144,8 @@ class MemcachedIntegration extends Integration
         \DDTrace\trace_method(
             'Memcached',
             $command,
-            function (SpanData $span, $args, $retval) use ($integration, $command) {
+            function (SpanData $span, $args, $retval) use ($command) {
+                $integration = MemcachedIntegration::get();
                 $integration->setCommonData($span, $command);
                 if ($command === 'getByKey') {
                     $span->metrics[Tag::DB_ROW_COUNT] = empty($retval) ? 0 : 1;
@@ -163,7 +168,8 @@ class MemcachedIntegration extends Integration
         \DDTrace\trace_method(
             'Memcached',
             $command,
-            function (SpanData $span, $args, $retval) use ($integration, $command) {
+            function (SpanData $span, $args, $retval) use ($command) {
+                $integration = MemcachedIntegration::get();
                 $integration->setCommonData($span, $command);
                 if ($command === 'getMulti') {
                     $span->metrics[Tag::DB_ROW_COUNT] = isset($retval) ? (is_array($retval) ? count($retval) : 1) : 0;
@@ -182,7 +188,8 @@ class MemcachedIntegration extends Integration
         \DDTrace\trace_method(
             'Memcached',
             $command,
-            function (SpanData $span, $args, $retval) use ($integration, $command) {
+            function (SpanData $span, $args, $retval) use ($command) {
+                $integration = MemcachedIntegration::get();
                 $integration->setCommonData($span, $command);
                 if ($command === 'getMultiByKey') {
                     $span->metrics[Tag::DB_ROW_COUNT] = isset($retval) ? (is_array($retval) ? count($retval) : 1) : 0;
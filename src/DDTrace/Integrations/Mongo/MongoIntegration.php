@@ -30,7 +30,8 @@ class MongoIntegration extends Integration
          * MongoClient
          */
 
-        \DDTrace\trace_method('MongoClient', '__construct', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoClient', '__construct', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoClient', '__construct');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_SERVER] = Obfuscation::dsn($args[0]);
@@ -44,7 +45,8 @@ class MongoIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('MongoClient', 'selectCollection', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoClient', 'selectCollection', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoClient', 'selectCollection');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_DATABASE] = $args[0];
@@ -54,14 +56,16 @@ class MongoIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('MongoClient', 'selectDB', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoClient', 'selectDB', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoClient', 'selectDB');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_DATABASE] = $args[0];
             }
         });
 
-        \DDTrace\trace_method('MongoClient', 'setReadPreference', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoClient', 'setReadPreference', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoClient', 'setReadPreference');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_READ_PREFERENCE] = $args[0];
@@ -78,7 +82,8 @@ class MongoIntegration extends Integration
          * MongoCollection
          */
 
-        \DDTrace\trace_method('MongoCollection', '__construct', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoCollection', '__construct', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoCollection', '__construct');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_DATABASE] = Integration::toString($args[0]);
@@ -91,7 +96,8 @@ class MongoIntegration extends Integration
         \DDTrace\trace_method(
             'MongoCollection',
             'createDBRef',
-            function (SpanData $span, $args, $return) use ($integration) {
+            static function (SpanData $span, $args, $return) {
+                $integration = MongoIntegration::get();
                 $integration->addSpanDefaultMetadata($span, 'MongoCollection', 'createDBRef');
                 if (!is_array($return)) {
                     return;
@@ -105,7 +111,8 @@ class MongoIntegration extends Integration
             }
         );
 
-        \DDTrace\trace_method('MongoCollection', 'getDBRef', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoCollection', 'getDBRef', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoCollection', 'getDBRef');
 
             if (isset($args[0]['$id'])) {
@@ -116,7 +123,8 @@ class MongoIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('MongoCollection', 'distinct', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoCollection', 'distinct', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoCollection', 'distinct');
             $integration->addTraceAnalyticsIfEnabled($span);
             if (isset($args[1])) {
@@ -127,7 +135,8 @@ class MongoIntegration extends Integration
         \DDTrace\trace_method(
             'MongoCollection',
             'setReadPreference',
-            function (SpanData $span, $args) use ($integration) {
+            static function (SpanData $span, $args) {
+                $integration = MongoIntegration::get();
                 $integration->addSpanDefaultMetadata($span, 'MongoCollection', 'setReadPreference');
                 if (isset($args[0])) {
                     $span->meta[Tag::MONGODB_READ_PREFERENCE] = $args[0];
@@ -164,21 +173,24 @@ class MongoIntegration extends Integration
          * MongoDB
          */
 
-        \DDTrace\trace_method('MongoDB', 'setReadPreference', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'setReadPreference', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'setReadPreference');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_READ_PREFERENCE] = $args[0];
             }
         });
 
-        \DDTrace\trace_method('MongoDB', 'setProfilingLevel', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'setProfilingLevel', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'setProfilingLevel');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_PROFILING_LEVEL] = json_encode($args[0]);
             }
         });
 
-        \DDTrace\trace_method('MongoDB', 'command', function (SpanData $span, $args, $return) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'command', static function (SpanData $span, $args, $return) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'command');
             if (isset($args[0]['query'])) {
                 $span->meta[Tag::MONGODB_QUERY] = json_encode($args[0]['query']);
@@ -190,7 +202,8 @@ class MongoIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('MongoDB', 'createDBRef', function (SpanData $span, $args, $return) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'createDBRef', static function (SpanData $span, $args, $return) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'createDBRef');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_COLLECTION] = Integration::toString($args[0]);
@@ -200,21 +213,24 @@ class MongoIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('MongoDB', 'getDBRef', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'getDBRef', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'getDBRef');
             if (isset($args[0]['$ref'])) {
                 $span->meta[Tag::MONGODB_COLLECTION] = Integration::toString($args[0]['$ref']);
             }
         });
 
-        \DDTrace\trace_method('MongoDB', 'createCollection', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'createCollection', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'createCollection');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_COLLECTION] = Integration::toString($args[0]);
             }
         });
 
-        \DDTrace\trace_method('MongoDB', 'selectCollection', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('MongoDB', 'selectCollection', static function (SpanData $span, $args) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, 'MongoDB', 'selectCollection');
             if (isset($args[0])) {
                 $span->meta[Tag::MONGODB_COLLECTION] = Integration::toString($args[0]);
@@ -249,7 +265,8 @@ class MongoIntegration extends Integration
     public function traceMongoMethod($class, $method)
     {
         $integration = $this;
-        \DDTrace\trace_method($class, $method, function (SpanData $span) use ($class, $method, $integration) {
+        \DDTrace\trace_method($class, $method, static function (SpanData $span) use ($class, $method) {
+            $integration = MongoIntegration::get();
             $integration->addSpanDefaultMetadata($span, $class, $method);
         });
     }
@@ -269,7 +286,8 @@ class MongoIntegration extends Integration
         \DDTrace\trace_method(
             $class,
             $method,
-            function (SpanData $span, $args) use ($class, $method, $isTraceAnalithicsCandidate, $integration) {
+            static function (SpanData $span, $args) use ($class, $method, $isTraceAnalithicsCandidate) {
+                $integration = MongoIntegration::get();
                 $integration->addSpanDefaultMetadata($span, $class, $method);
                 if ($isTraceAnalithicsCandidate) {
                     $integration->addTraceAnalyticsIfEnabled($span);
@@ -354,7 +354,8 @@ class MongoDBIntegration extends Integration
         \DDTrace\trace_method(
             'MongoDB\Collection',
             $method,
-            function (SpanData $span, $args) use ($method, $integration) {
+            function (SpanData $span, $args) use ($method) {
+                $integration = MongoDBIntegration::get();
                 $integration->setMetadata(
                     $span,
                     'mongodb.cmd',
@@ -382,7 +383,8 @@ class MongoDBIntegration extends Integration
         \DDTrace\trace_method(
             'MongoDB\Collection',
             $method,
-            function (SpanData $span, $args) use ($method, $integration) {
+            function (SpanData $span, $args) use ($method) {
+                $integration = MongoDBIntegration::get();
                 $integration->setMetadata(
                     $span,
                     'mongodb.cmd',
@@ -408,7 +410,8 @@ class MongoDBIntegration extends Integration
     public function traceExecuteQuery($class, $method)
     {
         $integration = $this;
-        \DDTrace\trace_method($class, $method, function ($span, $args) use ($integration) {
+        \DDTrace\trace_method($class, $method, static function ($span, $args) {
+            $integration = MongoDBIntegration::get();
             list($database, $collection) = MongoDBIntegration::parseNamespace(isset($args[0]) ? $args[0] : null);
 
             $integration->setMetadata(
@@ -435,7 +438,8 @@ class MongoDBIntegration extends Integration
     public function traceExecuteBulkWrite($class, $method)
     {
         $integration = $this;
-        \DDTrace\trace_method($class, $method, function ($span, $args) use ($integration) {
+        \DDTrace\trace_method($class, $method, static function ($span, $args) {
+            $integration = MongoDBIntegration::get();
             list($database, $collection) = MongoDBIntegration::parseNamespace(isset($args[0]) ? $args[0] : null);
 
             $integration->setMetadata(
@@ -477,7 +481,8 @@ class MongoDBIntegration extends Integration
     public function traceExecuteCommand($class, $method, $knownCommands)
     {
         $integration = $this;
-        \DDTrace\trace_method($class, $method, function ($span, $args) use ($method, $knownCommands, $integration) {
+        \DDTrace\trace_method($class, $method, static function ($span, $args) use ($method, $knownCommands) {
+            $integration = MongoDBIntegration::get();
             // DB name
             $dbName = 'unknown_db';
             if (isset($args[0]) && \is_string($args[0])) {
@@ -34,7 +34,8 @@ class MysqliIntegration extends Integration
 
         $integration = $this;
 
-        \DDTrace\trace_function('mysqli_connect', function (SpanData $span, $args, $result) use ($integration) {
+        \DDTrace\trace_function('mysqli_connect', static function (SpanData $span, $args, $result) {
+            $integration = MysqliIntegration::get();
             list($host) = $args;
             $dbName = empty($args[3]) ? null : $args[3];
             if ($dbName) {
@@ -56,7 +57,8 @@ class MysqliIntegration extends Integration
         \DDTrace\trace_method(
             'mysqli',
             '__construct',
-            function (SpanData $span, $args) use ($integration) {
+            function (SpanData $span, $args) {
+                $integration = MysqliIntegration::get();
                 $dbName = empty($args[3]) ? null : $args[3];
                 if ($dbName) {
                     ObjectKVStore::put($this, MysqliIntegration::KEY_DATABASE_NAME, $dbName);
@@ -75,7 +77,8 @@ class MysqliIntegration extends Integration
             }
         );
 
-        \DDTrace\trace_function('mysqli_real_connect', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_function('mysqli_real_connect', static function (SpanData $span, $args) {
+            $integration = MysqliIntegration::get();
             list($mysqli) = $args;
             $host = empty($args[1]) ? null : $args[0];
             $dbName = empty($args[4]) ? null : $args[4];
@@ -93,7 +96,8 @@ class MysqliIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('mysqli', 'real_connect', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('mysqli', 'real_connect', function (SpanData $span, $args) {
+            $integration = MysqliIntegration::get();
             $dbName = empty($args[3]) ? null : $args[3];
             if ($dbName) {
                 ObjectKVStore::put($this, MysqliIntegration::KEY_DATABASE_NAME, $dbName);
@@ -103,7 +107,8 @@ class MysqliIntegration extends Integration
             $integration->setConnectionInfo($span, $this);
         });
 
-        \DDTrace\install_hook('mysqli_query', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('mysqli_query', static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($mysqli, $query) = $hook->args;
 
             $span = $hook->span();
@@ -113,7 +118,8 @@ class MysqliIntegration extends Integration
             $integration->setConnectionInfo($span, $mysqli);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql', 1);
-        }, function (HookData $hook) use ($integration) {
+        }, static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($mysqli, $query) = $hook->args;
             $span = $hook->span();
             $integration->setConnectionInfo($span, $mysqli);
@@ -127,7 +133,8 @@ class MysqliIntegration extends Integration
             }
         });
 
-        \DDTrace\install_hook('mysqli_real_query', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('mysqli_real_query', static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($mysqli, $query) = $hook->args;
 
             $span = $hook->span();
@@ -137,7 +144,8 @@ class MysqliIntegration extends Integration
             $integration->setConnectionInfo($span, $mysqli);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql', 1);
-        }, function (HookData $hook) use ($integration) {
+        }, static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($mysqli, $query) = $hook->args;
             $span = $hook->span();
             $integration->setConnectionInfo($span, $mysqli);
@@ -145,14 +153,16 @@ class MysqliIntegration extends Integration
             MysqliCommon::storeQuery($mysqli, $query);
         });
 
-        \DDTrace\install_hook('mysqli_prepare', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('mysqli_prepare', static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list(, $query) = $hook->args;
 
             $span = $hook->span();
             $integration->setDefaultAttributes($span, 'mysqli_prepare', $query);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql', 1);
-        }, function (HookData $hook) use ($integration) {
+        }, static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($mysqli, $query) = $hook->args;
             $span = $hook->span();
             $integration->setConnectionInfo($span, $mysqli);
@@ -167,7 +177,8 @@ class MysqliIntegration extends Integration
             }
         });
 
-        \DDTrace\install_hook('mysqli::query', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('mysqli::query', function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($query) = $hook->args;
 
             $span = $hook->span();
@@ -177,7 +188,8 @@ class MysqliIntegration extends Integration
             $integration->setConnectionInfo($span, $this);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql');
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($query) = $hook->args;
             $span = $hook->span();
             $integration->setConnectionInfo($span, $this);
@@ -192,7 +204,8 @@ class MysqliIntegration extends Integration
             }
         });
 
-        \DDTrace\install_hook('mysqli::real_query', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('mysqli::real_query', function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($query) = $hook->args;
 
             $span = $hook->span();
@@ -202,7 +215,8 @@ class MysqliIntegration extends Integration
             $integration->setConnectionInfo($span, $this);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql');
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($query) = $hook->args;
             $span = $hook->span();
             $integration->setConnectionInfo($span, $this);
@@ -210,14 +224,16 @@ class MysqliIntegration extends Integration
             MysqliCommon::storeQuery($this, $query);
         });
 
-        \DDTrace\install_hook('mysqli::prepare', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('mysqli::prepare', static function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($query) = $hook->args;
 
             $span = $hook->span();
             $integration->setDefaultAttributes($span, 'mysqli.prepare', $query);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql');
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = MysqliIntegration::get();
             list($query) = $hook->args;
             $span = $hook->span();
             $integration->setConnectionInfo($span, $this);
@@ -243,7 +259,8 @@ class MysqliIntegration extends Integration
         });
 
         if (PHP_VERSION_ID >= 80200) {
-            \DDTrace\install_hook('mysqli_execute_query', function (HookData $hook) use ($integration) {
+            \DDTrace\install_hook('mysqli_execute_query', static function (HookData $hook) {
+                $integration = MysqliIntegration::get();
                 list(, $query) = $hook->args;
 
                 $span = $hook->span();
@@ -252,7 +269,8 @@ class MysqliIntegration extends Integration
                 $integration->addTraceAnalyticsIfEnabled($span);
 
                 DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql', 1);
-            }, function (HookData $hook) use ($integration) {
+            }, static function (HookData $hook) {
+                $integration = MysqliIntegration::get();
                 list($mysqli, $query) = $hook->args;
                 $span = $hook->span();
                 $integration->setConnectionInfo($span, $mysqli);
@@ -267,7 +285,8 @@ class MysqliIntegration extends Integration
                 }
             });
 
-            \DDTrace\install_hook('mysqli::execute_query', function (HookData $hook) use ($integration) {
+            \DDTrace\install_hook('mysqli::execute_query', static function (HookData $hook) {
+                $integration = MysqliIntegration::get();
                 list($query) = $hook->args;
 
                 $span = $hook->span();
@@ -276,7 +295,8 @@ class MysqliIntegration extends Integration
                 $integration->addTraceAnalyticsIfEnabled($span);
 
                 DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'mysql');
-            }, function (HookData $hook) use ($integration) {
+            }, function (HookData $hook) {
+                $integration = MysqliIntegration::get();
                 list($query) = $hook->args;
                 $span = $hook->span();
                 $integration->setConnectionInfo($span, $this);
@@ -292,7 +312,8 @@ class MysqliIntegration extends Integration
             });
         }
 
-        \DDTrace\trace_function('mysqli_commit', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_function('mysqli_commit', static function (SpanData $span, $args) {
+            $integration = MysqliIntegration::get();
             list($mysqli) = $args;
             $resource = MysqliCommon::retrieveQuery($mysqli, 'mysqli_commit');
             $integration->setDefaultAttributes($span, 'mysqli_commit', $resource);
@@ -303,7 +324,8 @@ class MysqliIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_function('mysqli_stmt_execute', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_function('mysqli_stmt_execute', static function (SpanData $span, $args) {
+            $integration = MysqliIntegration::get();
             list($statement) = $args;
             $resource = MysqliCommon::retrieveQuery($statement, 'mysqli_stmt_execute');
             $integration->setDefaultAttributes($span, 'mysqli_stmt_execute', $resource);
@@ -323,7 +345,8 @@ class MysqliIntegration extends Integration
             return false;
         });
 
-        \DDTrace\trace_method('mysqli', 'commit', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('mysqli', 'commit', function (SpanData $span, $args) {
+            $integration = MysqliIntegration::get();
             $resource = MysqliCommon::retrieveQuery($this, 'mysqli.commit');
             $integration->setDefaultAttributes($span, 'mysqli.commit', $resource);
             $integration->setConnectionInfo($span, $this);
@@ -333,7 +356,8 @@ class MysqliIntegration extends Integration
             }
         });
 
-        \DDTrace\trace_method('mysqli_stmt', 'execute', function (SpanData $span) use ($integration) {
+        \DDTrace\trace_method('mysqli_stmt', 'execute', function (SpanData $span) {
+            $integration = MysqliIntegration::get();
             $resource = MysqliCommon::retrieveQuery($this, 'mysqli_stmt.execute');
             $integration->setDefaultAttributes($span, 'mysqli_stmt.execute', $resource);
             $integration->addTraceAnalyticsIfEnabled($span);
@@ -341,7 +365,8 @@ class MysqliIntegration extends Integration
             $span->peerServiceSources = DatabaseIntegrationHelper::PEER_SERVICE_SOURCES;
         });
 
-        \DDTrace\trace_method('mysqli_stmt', 'get_result', function (SpanData $span, $a, $result) use ($integration) {
+        \DDTrace\trace_method('mysqli_stmt', 'get_result', function (SpanData $span, $a, $result) {
+            $integration = MysqliIntegration::get();
             $resource = MysqliCommon::retrieveQuery($this, 'mysqli_stmt.get_result');
             $integration->setDefaultAttributes($span, 'mysqli_stmt.get_result', $resource, $result);
             $integration->setConnectionInfo($span, $this);
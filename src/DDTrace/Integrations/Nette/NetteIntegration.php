@@ -27,7 +27,8 @@ class NetteIntegration extends Integration
         $service = \ddtrace_config_app_name(NetteIntegration::NAME);
 
         $integration = $this;
-        $setRootSpanFn = function () use ($service, $integration) {
+        $setRootSpanFn = static function () use ($service) {
+            $integration = NetteIntegration::get();
             $rootSpan = \DDTrace\root_span();
             if ($rootSpan === null) {
                 return;
@@ -55,7 +55,8 @@ class PDOIntegration extends Integration
         });
 
         // public int PDO::exec(string $query)
-        \DDTrace\install_hook('PDO::exec', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('PDO::exec', function (HookData $hook) {
+            $integration = PDOIntegration::get();
             list($query) = $hook->args;
 
             $span = $hook->span();
@@ -67,7 +68,8 @@ class PDOIntegration extends Integration
             $integration->addTraceAnalyticsIfEnabled($span);
 
             PDOIntegration::injectDBIntegration($this, $hook);
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = PDOIntegration::get();
             $span = $hook->span();
             if (is_numeric($hook->returned)) {
                 $span->metrics[Tag::DB_ROW_COUNT] = $hook->returned;
@@ -80,7 +82,8 @@ class PDOIntegration extends Integration
         // public PDOStatement PDO::query(string $query, int PDO::FETCH_CLASS, string $classname, array $ctorargs)
         // public PDOStatement PDO::query(string $query, int PDO::FETCH_INFO, object $object)
         // public int PDO::exec(string $query)
-        \DDTrace\install_hook('PDO::query', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('PDO::query', function (HookData $hook) {
+            $integration = PDOIntegration::get();
             list($query) = $hook->args;
 
             $span = $hook->span();
@@ -91,7 +94,8 @@ class PDOIntegration extends Integration
             $integration->addTraceAnalyticsIfEnabled($span);
 
             PDOIntegration::injectDBIntegration($this, $hook);
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = PDOIntegration::get();
             $span = $hook->span();
             if ($hook->returned instanceof \PDOStatement) {
                 $span->metrics[Tag::DB_ROW_COUNT] = $hook->returned->rowCount();
@@ -101,7 +105,8 @@ class PDOIntegration extends Integration
         });
 
         // public PDOStatement PDO::prepare ( string $statement [, array $driver_options = array() ] )
-        \DDTrace\install_hook('PDO::prepare', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('PDO::prepare', function (HookData $hook) {
+            $integration = PDOIntegration::get();
             list($query) = $hook->args;
 
             $span = $hook->span();
@@ -111,7 +116,8 @@ class PDOIntegration extends Integration
             PDOIntegration::setCommonSpanInfo($this, $span);
 
             PDOIntegration::injectDBIntegration($this, $hook);
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = PDOIntegration::get();
             ObjectKVStore::propagate($this, $hook->returned, PDOIntegration::CONNECTION_TAGS_KEY);
         });
 
@@ -126,7 +132,8 @@ class PDOIntegration extends Integration
         \DDTrace\trace_method(
             'PDOStatement',
             'execute',
-            function (SpanData $span, array $args, $retval) use ($integration) {
+            function (SpanData $span, array $args, $retval) {
+                $integration = PDOIntegration::get();
                 Integration::handleOrphan($span);
                 $span->name = 'PDOStatement.execute';
                 Integration::handleInternalSpanServiceName($span, PDOIntegration::NAME);
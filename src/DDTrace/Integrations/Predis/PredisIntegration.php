@@ -48,7 +48,8 @@ class PredisIntegration extends Integration
             PredisIntegration::setMetaAndServiceFromConnection($this, $span);
         });
 
-        \DDTrace\trace_method('Predis\Client', 'executeCommand', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Predis\Client', 'executeCommand', function (SpanData $span, $args) {
+            $integration = PredisIntegration::get();
             Integration::handleOrphan($span);
 
             $span->name = 'Predis.Client.executeCommand';
@@ -73,7 +74,8 @@ class PredisIntegration extends Integration
             $span->meta['redis.raw_command'] = $query;
         });
 
-        \DDTrace\trace_method('Predis\Client', 'executeRaw', function (SpanData $span, $args) use ($integration) {
+        \DDTrace\trace_method('Predis\Client', 'executeRaw', function (SpanData $span, $args) {
+            $integration = PredisIntegration::get();
             Integration::handleOrphan($span);
 
             $span->name = 'Predis.Client.executeRaw';
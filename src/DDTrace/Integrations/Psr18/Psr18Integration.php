@@ -24,7 +24,8 @@ class Psr18Integration extends Integration
         \DDTrace\trace_method(
             'Psr\Http\Client\ClientInterface',
             'sendRequest',
-            function (SpanData $span, $args, $retval) use ($integration) {
+            static function (SpanData $span, $args, $retval) {
+                $integration = Psr18Integration::get();
                 $span->resource = 'sendRequest';
                 $span->name = 'Psr\Http\Client\ClientInterface.sendRequest';
                 $span->type = Type::HTTP_CLIENT;
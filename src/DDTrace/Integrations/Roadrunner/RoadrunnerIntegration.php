@@ -145,7 +145,8 @@ class RoadrunnerIntegration extends Integration
                 $activeSpan = null;
                 $suppressResponse = null;
             },
-            function (HookData $hook) use (&$activeSpan, &$suppressResponse, $integration, $service, &$recCall) {
+            function (HookData $hook) use (&$activeSpan, &$suppressResponse, $service, &$recCall) {
+                $integration = RoadrunnerIntegration::get();
                 /** @var ?\Spiral\RoadRunner\Http\Request $retval */
                 $retval = $hook->returned;
                 if (!$retval && !$hook->exception) {
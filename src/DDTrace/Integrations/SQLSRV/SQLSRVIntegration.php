@@ -31,7 +31,8 @@ class SQLSRVIntegration extends Integration
         $integration = $this;
 
         // sqlsrv_connect ( string $serverName [, array $connectionInfo] ) : resource
-        \DDTrace\trace_function('sqlsrv_connect', function (SpanData $span, $args, $retval) use ($integration) {
+        \DDTrace\trace_function('sqlsrv_connect', function (SpanData $span, $args, $retval) {
+            $integration = SQLSRVIntegration::get();
             $connectionMetadata = $integration->extractConnectionMetadata($args);
             ObjectKVStore::put($this, SQLSRVIntegration::CONNECTION_TAGS_KEY, $connectionMetadata);
             self::setDefaultAttributes($connectionMetadata, $span, 'sqlsrv_connect');
@@ -40,7 +41,8 @@ class SQLSRVIntegration extends Integration
         });
 
         // sqlsrv_query ( resource $conn , string $query [, array $params [, array $options ]] ) : resource
-        \DDTrace\install_hook('sqlsrv_query', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('sqlsrv_query', function (HookData $hook) {
+            $integration = SQLSRVIntegration::get();
             list(, $query) = $hook->args;
 
             $span = $hook->span();
@@ -51,7 +53,8 @@ class SQLSRVIntegration extends Integration
             ObjectKVStore::put($this, SQLSRVIntegration::QUERY_TAGS_KEY, $query);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'sqlsrv', 1);
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = SQLSRVIntegration::get();
             $span = $hook->span();
             if (is_object($hook->returned)) {
                 ObjectKVStore::propagate($this, $hook->returned, SQLSRVIntegration::CONNECTION_TAGS_KEY);
@@ -63,7 +66,8 @@ class SQLSRVIntegration extends Integration
         });
 
         // sqlsrv_prepare ( resource $conn , string $query [, array $params [, array $options ]] ) : resource
-        \DDTrace\install_hook('sqlsrv_prepare', function (HookData $hook) use ($integration) {
+        \DDTrace\install_hook('sqlsrv_prepare', function (HookData $hook) {
+            $integration = SQLSRVIntegration::get();
             list(, $query) = $hook->args;
 
             ObjectKVStore::put($this, SQLSRVIntegration::QUERY_TAGS_KEY, $query);
@@ -72,7 +76,8 @@ class SQLSRVIntegration extends Integration
             self::setDefaultAttributes($this, $span, 'sqlsrv_prepare', $query);
 
             DatabaseIntegrationHelper::injectDatabaseIntegrationData($hook, 'sqlsrv', 1);
-        }, function (HookData $hook) use ($integration) {
+        }, function (HookData $hook) {
+            $integration = SQLSRVIntegration::get();
             $span = $hook->span();
             if (is_object($hook->returned)) {
                 ObjectKVStore::propagate($this, $hook->returned, SQLSRVIntegration::CONNECTION_TAGS_KEY);
@@ -82,14 +87,16 @@ class SQLSRVIntegration extends Integration
         });
 
         // sqlsrv_commit ( resource $conn ) : bool
-        \DDTrace\trace_function('sqlsrv_commit', function (SpanData $span, $args, $retval) use ($integration) {
+        \DDTrace\trace_function('sqlsrv_commit', function (SpanData $span, $args, $retval) {
+            $integration = SQLSRVIntegration::get();
             self::setDefaultAttributes($this, $span, 'sqlsrv_commit', null, $retval);
 
             $integration->detectError($retval, $span);
         });
 
         // sqlsrv_execute ( resource $stmt ) : bool
-        \DDTrace\trace_function('sqlsrv_execute', function (SpanData $span, $args, $retval) use ($integration) {
+        \DDTrace\trace_function('sqlsrv_execute', function (SpanData $span, $args, $retval) {
+            $integration = SQLSRVIntegration::get();
             $query = ObjectKVStore::get($this, SQLSRVIntegration::QUERY_TAGS_KEY);
             self::setDefaultAttributes($this, $span, 'sqlsrv_execute', $query, $retval);
             $integration->addTraceAnalyticsIfEnabled($span);
@@ -25,7 +25,8 @@ class SlimIntegration extends Integration
             'Slim\App',
             '__construct',
             null,
-            function ($app) use ($integration, $appName) {
+            function ($app) use ($appName) {
+                $integration = SlimIntegration::get();
                 $majorVersion = substr($app::VERSION, 0, 1);
                 if ('3' !== $majorVersion && '4' !== $majorVersion) {
                     return;
@@ -131,7 +131,8 @@ class SwooleIntegration extends Integration
             'Swoole\Http\Server',
             '__construct',
             null,
-            function ($server) use ($integration) {
+            static function ($server) {
+                $integration = SwooleIntegration::get();
                 $server->on('workerstart', function () { });
             }
         );
@@ -140,7 +141,8 @@ class SwooleIntegration extends Integration
             'Swoole\Http\Server',
             'on',
             null,
-            function ($server, $scope, $args, $retval) use ($integration) {
+            static function ($server, $scope, $args, $retval) {
+                $integration = SwooleIntegration::get();
                 if ($retval === false) {
                     return; // Callback wasn't set
                 }
@@ -163,7 +165,8 @@ class SwooleIntegration extends Integration
         \DDTrace\hook_method(
             'Swoole\Http\Response',
             'end',
-            function ($response, $scope, $args) use ($integration) {
+            static function ($response, $scope, $args) {
+                $integration = SwooleIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null) {
                     return;
@@ -183,7 +186,8 @@ class SwooleIntegration extends Integration
         \DDTrace\hook_method(
             'Swoole\Http\Response',
             'header',
-            function ($response, $scope, $args) use ($integration) {
+            static function ($response, $scope, $args) {
+                $integration = SwooleIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan === null || \count($args) < 2) {
                     return;
@@ -203,7 +207,8 @@ class SwooleIntegration extends Integration
         \DDTrace\hook_method(
             'Swoole\Http\Response',
             'status',
-            function ($response, $scope, $args) use ($integration) {
+            static function ($response, $scope, $args) {
+                $integration = SwooleIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan && \count($args) > 0) {
                     $rootSpan->meta[Tag::HTTP_STATUS_CODE] = $args[0];
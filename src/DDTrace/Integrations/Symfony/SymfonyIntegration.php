@@ -43,7 +43,8 @@ class SymfonyIntegration extends Integration
             'Symfony\Component\HttpKernel\Kernel',
             'handle',
             [
-                'prehook' => function (SpanData $span) use ($integration) {
+                'prehook' => function (SpanData $span) {
+                    $integration = SymfonyIntegration::get();
                     $rootSpan = \DDTrace\root_span();
                     if ($rootSpan === $span) {
                         return false;
@@ -251,7 +252,8 @@ class SymfonyIntegration extends Integration
                  * - https://symfony.com/doc/current/components/console/events.html.
                  */
                 'recurse' => true,
-                'prehook' => function (SpanData $span) use ($integration) {
+                'prehook' => function (SpanData $span) {
+                    $integration = SymfonyIntegration::get();
                     if (\DDTrace\root_span() === $span) {
                         return false;
                     }
@@ -288,7 +290,8 @@ class SymfonyIntegration extends Integration
         \DDTrace\hook_method(
             'Symfony\Component\Console\Application',
             'renderException',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = SymfonyIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan !== null) {
                     $rootSpan->exception = $args[0];
@@ -299,7 +302,8 @@ class SymfonyIntegration extends Integration
         \DDTrace\hook_method(
             'Symfony\Component\Console\Application',
             'renderThrowable',
-            function ($This, $scope, $args) use ($integration) {
+            static function ($This, $scope, $args) {
+                $integration = SymfonyIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if ($rootSpan !== null) {
                     $rootSpan->exception = $args[0];
@@ -42,7 +42,8 @@ class SymfonyMessengerIntegration extends Integration
         trace_method(
             'Symfony\Component\Messenger\MessageBusInterface',
             'dispatch',
-            function (SpanData $span, array $args, $retval, $exception) use ($integration) {
+            static function (SpanData $span, array $args, $retval, $exception) {
+                $integration = SymfonyMessengerIntegration::get();
                 $integration->setSpanAttributes($span, 'symfony.messenger.dispatch', null, $retval ?? $args[0], null, null, true);
                 if ($exception) {
                     // Worker::handleMessage() will catch the exception. We need to manually attach it to the root span.
@@ -71,7 +72,8 @@ class SymfonyMessengerIntegration extends Integration
         trace_method(
            'Symfony\Component\Messenger\Transport\TransportInterface',
            'send',
-           function (SpanData $span, array $args, $envelope) use ($integration) {
+           static function (SpanData $span, array $args, $envelope) {
+               $integration = SymfonyMessengerIntegration::get();
                $integration->setSpanAttributes($span, 'symfony.messenger.send', null, $envelope ?? $args[0], null, 'send', true);
            }
         );
@@ -80,7 +82,8 @@ class SymfonyMessengerIntegration extends Integration
             'Symfony\Component\Messenger\Worker',
             'handleMessage',
             [
-                'prehook' => function (SpanData $span, array $args) use ($integration) {
+                'prehook' => static function (SpanData $span, array $args) {
+                    $integration = SymfonyMessengerIntegration::get();
                     /** @var \Symfony\Component\Messenger\Envelope $envelope */
                     $envelope = $args[0];
                     /** @var string|ReceiverInterface $transportName */
@@ -112,7 +115,8 @@ class SymfonyMessengerIntegration extends Integration
                         }
                     }
                 },
-                'posthook' => function (SpanData $span) use ($integration) {
+                'posthook' => static function (SpanData $span) {
+                    $integration = SymfonyMessengerIntegration::get();
                     if ($span->exception !== null) {
                         // Used by Logs Correlation to track the origin of an exception
                         ObjectKVStore::put(
@@ -135,9 +139,11 @@ class SymfonyMessengerIntegration extends Integration
             hook_method(
                 'Symfony\Component\Messenger\Middleware\HandleMessageMiddleware',
                 'callHandler',
-                function ($This, $scope, $args) use ($integration) {
+                function ($This, $scope, $args) {
+                    $integration = SymfonyMessengerIntegration::get();
                     $message = $args[1];
-                    install_hook($args[0], function (HookData $hook) use ($integration, $message) {
+                    install_hook($args[0], function (HookData $hook) use ($message) {
+                        $integration = SymfonyMessengerIntegration::get();
                         $integration->setSpanAttributes($hook->span(), 'symfony.messenger.handle', \get_class($this), $message, false, 'process');
                         remove_hook($hook->id);
                     });
@@ -157,7 +163,8 @@ class SymfonyMessengerIntegration extends Integration
             hook_method(
                 'Symfony\Component\Messenger\Middleware\HandleMessageMiddleware',
                 'handle',
-                function ($This, $scope, $args) use ($integration) {
+                function ($This, $scope, $args) {
+                    $integration = SymfonyMessengerIntegration::get();
                     $envelope = $args[0];
                     $handlersLocator = ObjectKVStore::get($This, 'handlersLocator');
                     $message = $envelope->getMessage();
@@ -167,7 +174,8 @@ class SymfonyMessengerIntegration extends Integration
                         }
 
                         $handler = $handlerDescriptor->getHandler();
-                        install_hook($handler, function (HookData $hook) use ($integration, $message) {
+                        install_hook($handler, function (HookData $hook) use ($message) {
+                            $integration = SymfonyMessengerIntegration::get();
                             $integration->setSpanAttributes($hook->span(), 'symfony.messenger.handle', \get_class($this), $message, false, 'process');
                             remove_hook($hook->id);
                         });
@@ -177,7 +185,8 @@ class SymfonyMessengerIntegration extends Integration
         }
 
         if (dd_trace_env_config('DD_TRACE_SYMFONY_MESSENGER_MIDDLEWARES')) {
-            $handleFn = function (SpanData $span, array $args) use ($integration) {
+            $handleFn = function (SpanData $span, array $args) {
+                $integration = SymfonyMessengerIntegration::get();
                 $integration->setSpanAttributes($span, 'symfony.messenger.middleware', \get_class($this), $args[0]);
             };
 
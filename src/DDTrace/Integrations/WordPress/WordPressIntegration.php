@@ -40,7 +40,8 @@ class WordPressIntegration extends Integration
         $integration = $this;
 
         // This call happens right in central config initialization
-        \DDTrace\hook_function('wp_check_php_mysql_versions', null, function () use ($integration) {
+        \DDTrace\hook_function('wp_check_php_mysql_versions', null, static function () {
+            $integration = WordPressIntegration::get();
             if (!isset($GLOBALS['wp_version']) || !is_string($GLOBALS['wp_version'])) {
                 return false;
             }
@@ -44,7 +44,8 @@ class ZendFrameworkIntegration extends Integration
         \DDTrace\hook_method(
             'Zend_Controller_Plugin_Broker',
             'preDispatch',
-            function ($broker, $scope, $args) use ($integration, $appName) {
+            static function ($broker, $scope, $args) use ($appName) {
+                $integration = ZendFrameworkIntegration::get();
                 $rootSpan = \DDTrace\root_span();
                 if (null === $rootSpan) {
                     return;
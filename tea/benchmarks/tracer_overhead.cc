@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cstdlib>
+#include <benchmark/benchmark.h>
+#include <include/testing/fixture.hpp>
+
+extern "C" {
+#include <Zend/zend_API.h>
+}
+
+/* Quantifies the cost of the tracer self-overhead accounting (DD_TRACE_MEASURE_OVERHEAD).
+ *
+ * The tracer is loaded from DDTRACE_EXTENSION and configured through the environment, which it only reads once per
+ * process. Run the binary once with DD_TRACE_MEASURE_OVERHEAD=0 and once with =1 and compare: each hooked call enters
+ * and leaves the hooks and spans sections, the flush at request shutdown the serialize one. For the cost of the
+ * compiled-in but disabled gate, compare against a tracer built with -DDDTRACE_OVERHEAD_ACCOUNTING=0.
+ */
+
+static TeaTestCaseFixture fixture;
+
+static const char *hook_installers[] = {
+    "DDTrace\\trace_function('dd_overhead_bench_target', function () {});",
+    "DDTrace\\install_hook('dd_overhead_bench_target', function (DDTrace\\HookData $hook) { $hook->span(); });",
+};
+
+static void BM_TracerOverheadHookedCalls(benchmark::State& state) {
+    char script[512];
+    snprintf(script, sizeof(script),
+             "function dd_overhead_bench_target() { return 1; }\n"
+             "%s\n"
+             "for ($i = 0; $i < %ld; ++$i) { dd_overhead_bench_target(); }",
+             hook_installers[state.range(0)], (long)state.range(1));
+
+    for (auto _ : state) {
+        fixture.tea_sapi_rinit();
+        if (zend_eval_string(script, NULL, (char *)"tracer_overhead") != SUCCESS) {
+            state.SkipWithError("Failed to run the hooked calls");
+        }
+        fixture.tea_sapi_rshutdown();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+// Arguments: hook kind (0: trace_function, 1: install_hook), calls per request
+BENCHMARK(BM_TracerOverheadHookedCalls)->ArgsProduct({{0, 1}, {1, 100, 1000}});
+
+int main(int argc, char** argv) {
+    const char *extension = getenv("DDTRACE_EXTENSION");
+    if (!extension || !*extension) {
+        fprintf(stderr, "DDTRACE_EXTENSION must point to the ddtrace.so to benchmark\n");
+        return 1;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    if (!fixture.tea_sapi_sinit() || !tea_sapi_append_system_ini_entry("extension", extension)
+        // The traces have nowhere to go, but they are still serialized at request shutdown
+        || !tea_sapi_append_system_ini_entry("datadog.trace.agent_url", "http://127.0.0.1:1")
+        || !tea_sapi_append_system_ini_entry("datadog.instrumentation_telemetry_enabled", "0")
+        || !tea_sapi_append_system_ini_entry("datadog.remote_config_enabled", "0")
+        || !fixture.tea_sapi_minit()) {
+        fprintf(stderr, "Failed to start the TEA SAPI\n");
+        return 1;
+    }
+
+    if (!zend_hash_str_exists(&module_registry, ZEND_STRL("ddtrace"))) {
+        fprintf(stderr, "Failed to load %s\n", extension);
+        return 1;
+    }
+
+    const char *measure = getenv("DD_TRACE_MEASURE_OVERHEAD");
+    benchmark::AddCustomContext("measure_overhead", measure && *measure ? measure : "0");
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    fixture.tea_sapi_mshutdown();
+    fixture.tea_sapi_sshutdown();
+    return 0;
+}
@@ -43,26 +43,50 @@ zend_string *zai_exception_message(zend_object *ex) {
 /* Modeled after Exception::getTraceAsString:
  * @see https://heap.space/xref/PHP-8.0/Zend/zend_exceptions.c#getTraceAsString
  */
-zend_string *zai_get_trace_without_args_skip_frames(zend_array *trace, int skip) {
+void zai_append_trace_without_args_skip_frames(smart_str *str, zend_array *trace, int skip, uint32_t max_frames) {
     if (!trace) {
         // should never happen; TODO: fail in CI
-        return zend_string_init_interned(ZEND_STRL("[broken trace]"), 1);
+        smart_str_appends(str, "[broken trace]");
+        return;
+    }
+
+    uint32_t frames = zend_hash_num_elements(trace);
+    frames = skip > 0 ? (frames > (uint32_t)skip ? frames - skip : 0) : frames;
+
+    // Keep the outermost and innermost frames, drop the middle ones
+    uint32_t elide_from = UINT32_MAX, elide_to = 0;
+    if (max_frames && frames > max_frames) {
+        elide_from = max_frames / 2;
+        elide_to = frames - (max_frames - elide_from);
     }
 
+    // Rough estimate of a rendered frame, to avoid most reallocations
+    uint32_t rendered = max_frames && frames > max_frames ? max_frames : frames;
+    smart_str_alloc(str, (size_t)rendered * 100 + 16, 0);
+
     zval *frame;
-    smart_str str = {0};
     uint32_t num = 0;
     ZEND_HASH_FOREACH_VAL(trace, frame) {
         if (skip-- > 0) {
             continue;
         }
 
-        smart_str_appendc(&str, '#');
-        smart_str_append_long(&str, num++);
-        smart_str_appendc(&str, ' ');
+        if (num >= elide_from && num < elide_to) {
+            if (num == elide_from) {
+                smart_str_appends(str, "[... ");
+                smart_str_append_long(str, (zend_long)(elide_to - elide_from));
+                smart_str_appends(str, " frames omitted ...]\n");
+            }
+            ++num;
+            continue;
+        }
+
+        smart_str_appendc(str, '#');
+        smart_str_append_long(str, num++);
+        smart_str_appendc(str, ' ');
 
         if (UNEXPECTED(Z_TYPE_P(frame) != IS_ARRAY)) {
-            smart_str_appends(&str, "[invalid frame]\n");
+            smart_str_appends(str, "[invalid frame]\n");
             continue;
         }
 
@@ -72,38 +96,38 @@ zend_string *zai_get_trace_without_args_skip_frames(zend_array *trace, int skip)
         if (file) {
             if (Z_TYPE_P(file) != IS_STRING) {
                 // before PHP 8.0.7 this was unknown function, but unknown file is much better
-                smart_str_appends(&str, "[unknown file]");
+                smart_str_appends(str, "[unknown file]");
             } else {
                 zend_long line = 0;
                 zval *tmp = zend_hash_find_ex(ht, ZSTR_KNOWN(ZEND_STR_LINE), 1);
                 if (tmp && Z_TYPE_P(tmp) == IS_LONG) {
                     line = Z_LVAL_P(tmp);
                 }
-                smart_str_append(&str, Z_STR_P(file));
-                smart_str_appendc(&str, '(');
-                smart_str_append_long(&str, line);
-                smart_str_appends(&str, "): ");
+                smart_str_append(str, Z_STR_P(file));
+                smart_str_appendc(str, '(');
+                smart_str_append_long(str, line);
+                smart_str_appends(str, "): ");
             }
         } else {
-            smart_str_appends(&str, "[internal function]: ");
+            smart_str_appends(str, "[internal function]: ");
         }
 
         {
             zval *tmp = zend_hash_find_ex(ht, ZSTR_KNOWN(ZEND_STR_CLASS), 1);
             if (tmp) {
-                smart_str_appends(&str, Z_TYPE_P(tmp) == IS_STRING ? Z_STRVAL_P(tmp) : "[unknown]");
+                smart_str_appends(str, Z_TYPE_P(tmp) == IS_STRING ? Z_STRVAL_P(tmp) : "[unknown]");
             }
         }
         {
             zval *tmp = zend_hash_find_ex(ht, ZSTR_KNOWN(ZEND_STR_TYPE), 1);
             if (tmp) {
-                smart_str_appends(&str, Z_TYPE_P(tmp) == IS_STRING ? Z_STRVAL_P(tmp) : "[unknown]");
+                smart_str_appends(str, Z_TYPE_P(tmp) == IS_STRING ? Z_STRVAL_P(tmp) : "[unknown]");
             }
         }
         {
             zval *tmp = zend_hash_find_ex(ht, ZSTR_KNOWN(ZEND_STR_FUNCTION), 1);
             if (tmp) {
-                smart_str_appends(&str, Z_TYPE_P(tmp) == IS_STRING ? Z_STRVAL_P(tmp) : "[unknown]");
+                smart_str_appends(str, Z_TYPE_P(tmp) == IS_STRING ? Z_STRVAL_P(tmp) : "[unknown]");
             }
         }
 
@@ -112,15 +136,24 @@ zend_string *zai_get_trace_without_args_skip_frames(zend_array *trace, int skip)
          * setting called zend.exception_ignore_args that prevents them from
          * being generated, so we can't even reliably know if there are args.
          */
-        smart_str_appends(&str, "()\n");
+        smart_str_appends(str, "()\n");
     }
     ZEND_HASH_FOREACH_END();
 
-    smart_str_appendc(&str, '#');
-    smart_str_append_long(&str, num);
-    smart_str_appends(&str, " {main}");
-    smart_str_0(&str);
+    smart_str_appendc(str, '#');
+    smart_str_append_long(str, num);
+    smart_str_appends(str, " {main}");
+}
+
+zend_string *zai_get_trace_without_args_skip_frames(zend_array *trace, int skip) {
+    if (!trace) {
+        // should never happen; TODO: fail in CI
+        return zend_string_init_interned(ZEND_STRL("[broken trace]"), 1);
+    }
 
+    smart_str str = {0};
+    zai_append_trace_without_args_skip_frames(&str, trace, skip, 0);
+    smart_str_0(&str);
     return str.s;
 }
 
@@ -144,4 +177,17 @@ zend_string *zai_get_trace_without_args_from_exception_skip_frames(zend_object *
 
 zend_string *zai_get_trace_without_args_from_exception(zend_object *ex) {
     return zai_get_trace_without_args_from_exception_skip_frames(ex, 0);
+}
+
+void zai_append_trace_without_args_from_exception(smart_str *buf, zend_object *ex, uint32_t max_frames) {
+    if (!ex) {
+        return;  // should never happen; TODO: fail in CI
+    }
+
+    zval *trace = ZAI_EXCEPTION_PROPERTY(ex, ZEND_STR_TRACE);
+    if (Z_TYPE_P(trace) != IS_ARRAY) {
+        return;  // should never happen in PHP 8 as the property is typed and always initialized
+    }
+
+    zai_append_trace_without_args_skip_frames(buf, Z_ARR_P(trace), 0, max_frames);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <main/php.h>
 // dummy comment here to prevent clang format fixer from reordering includes here
 #include <Zend/zend_exceptions.h>
+#include <Zend/zend_smart_str.h>
 #include <symbols/symbols.h>
 #include <zai_string/string.h>
 
@@ -53,5 +54,8 @@ zend_string *zai_get_trace_without_args(zend_array *trace);
 zend_string *zai_get_trace_without_args_from_exception(zend_object *ex);
 zend_string *zai_get_trace_without_args_skip_frames(zend_array *trace, int skip);
 zend_string *zai_get_trace_without_args_from_exception_skip_frames(zend_object *ex, int skip);
+// Append variants, max_frames = 0 means no limit; frames in the middle of the trace are omitted beyond that limit
+void zai_append_trace_without_args_skip_frames(smart_str *buf, zend_array *trace, int skip, uint32_t max_frames);
+void zai_append_trace_without_args_from_exception(smart_str *buf, zend_object *ex, uint32_t max_frames);
 
 #endif  // ZAI_EXCEPTIONS_H
@@ -1,9 +1,64 @@
 #include "../tsrmls_cache.h"
 #include "headers.h"
 
+#include <SAPI.h>
 #include <php.h>
 #include <zai_assert/zai_assert.h>
 
+// Values read directly from the SAPI, keyed by HTTP_HEADERNAME. Headers which are not set are cached as IS_NULL.
+ZEND_TLS HashTable *zai_headers_sapi_cache;
+
+static zai_header_result zai_read_header_from_sapi(zend_string *var_name, zend_string **header_value) {
+    if (zai_headers_sapi_cache) {
+        zval *cached = zend_hash_find(zai_headers_sapi_cache, var_name);
+        if (cached) {
+            if (Z_TYPE_P(cached) != IS_STRING) {
+                return ZAI_HEADER_NOT_SET;
+            }
+            *header_value = Z_STR_P(cached);
+            return ZAI_HEADER_SUCCESS;
+        }
+    } else {
+        ALLOC_HASHTABLE(zai_headers_sapi_cache);
+        zend_hash_init(zai_headers_sapi_cache, 8, NULL, ZVAL_PTR_DTOR, 0);
+    }
+
+    char *value;
+    if (sapi_module.getenv) {
+        // Same as what register_server_variables would put into $_SERVER, including the input filter
+        value = sapi_getenv(ZSTR_VAL(var_name), ZSTR_LEN(var_name));
+    } else {
+        // The CLI SAPI has no getenv handler, but populates $_SERVER from the process environment
+        value = getenv(ZSTR_VAL(var_name));
+        if (value) {
+            value = estrdup(value);
+        }
+    }
+
+    zval zv;
+    if (value) {
+        ZVAL_STRING(&zv, value);
+        efree(value);
+    } else {
+        ZVAL_NULL(&zv);
+    }
+    // var_name lives on the stack, have the hashtable allocate its own key
+    zend_hash_str_add_new(zai_headers_sapi_cache, ZSTR_VAL(var_name), ZSTR_LEN(var_name), &zv);
+
+    if (!value) {
+        return ZAI_HEADER_NOT_SET;
+    }
+
+    *header_value = Z_STR(zv);
+    return ZAI_HEADER_SUCCESS;
+}
+
+static bool zai_headers_sapi_readable(void) {
+    // Only SAPIs which expose the raw request variables allow us to bypass $_SERVER.
+    // Other SAPIs (e.g. cli-server or embed) register request headers only in register_server_variables.
+    return sapi_module.getenv || strcmp(sapi_module.name, "cli") == 0;
+}
+
 zai_header_result zai_read_header(zai_str uppercase_header_name, zend_string **header_value) {
     if (zai_str_is_empty(uppercase_header_name) || !header_value) return ZAI_HEADER_ERROR;
 
@@ -11,22 +66,36 @@ zai_header_result zai_read_header(zai_str uppercase_header_name, zend_string **h
 
     if (!PG(modules_activated) && !PG(during_request_startup)) return ZAI_HEADER_NOT_READY;
 
-    if (PG(auto_globals_jit)) {
+    // headers are present in HTTP_HEADERNAME from in the _SERVER array
+    ALLOCA_FLAG(use_heap)
+    zend_string *var_name;
+    size_t var_len = uppercase_header_name.len + sizeof("HTTP_") - 1;
+    ZSTR_ALLOCA_ALLOC(var_name, var_len, use_heap);
+    memcpy(ZSTR_VAL(var_name), "HTTP_", 5);
+    memcpy(ZSTR_VAL(var_name) + 5, uppercase_header_name.ptr, uppercase_header_name.len);
+    ZSTR_VAL(var_name)[var_len] = 0;
+
+    zval *server_var = &PG(http_globals)[TRACK_VARS_SERVER];
+    if (PG(auto_globals_jit) && Z_TYPE_P(server_var) != IS_ARRAY) {
+        // $_SERVER has not been materialized yet. Building it computes the *whole* array (which is observable from
+        // userland and expensive), even though we just want to access a single value. Ask the SAPI directly instead.
+        if (zai_headers_sapi_readable()) {
+            zai_header_result result = zai_read_header_from_sapi(var_name, header_value);
+            ZSTR_ALLOCA_FREE(var_name, use_heap);
+            return result;
+        }
+
         // !!!
         // This has side effects: while it does not realistically affect anybodys code - it materializes the
         // $_SERVER array for users with auto_globals_jit On (which is observable from userland).
         // In reality, it does not affect us much, as we anyway have that sort of side effect as part of initializing
         // any span.
         // As long as this function is not called with tracing disabled, this should be fine.
-        //
-        // The alternative would be calling sapi_module_struct.register_server_variables manually, but this has an
-        // unacceptable overhead as that always computes the *whole* _SERVER array, even if we just want to access
-        // a single value.
         zend_is_auto_global_str(ZEND_STRL("_SERVER"));
     }
 
-    zval *server_var = &PG(http_globals)[TRACK_VARS_SERVER];
     if (Z_TYPE_P(server_var) != IS_ARRAY) {
+        ZSTR_ALLOCA_FREE(var_name, use_heap);
         return ZAI_HEADER_NOT_READY;  // should be impossible to reach
     }
 
@@ -36,15 +105,6 @@ zai_header_result zai_read_header(zai_str uppercase_header_name, zend_string **h
     // is a default filter configured via ini. This should not impact us, but if it turns out to, we may have to
     // optionally access filter globals in a best-effort attempt at getting the original raw headers.
 
-    // headers are present in HTTP_HEADERNAME from in the _SERVER array
-    ALLOCA_FLAG(use_heap)
-    zend_string *var_name;
-    size_t var_len = uppercase_header_name.len + sizeof("HTTP_") - 1;
-    ZSTR_ALLOCA_ALLOC(var_name, var_len, use_heap);
-    memcpy(ZSTR_VAL(var_name), "HTTP_", 5);
-    memcpy(ZSTR_VAL(var_name) + 5, uppercase_header_name.ptr, uppercase_header_name.len);
-    ZSTR_VAL(var_name)[var_len] = 0;
-
     zval *header_zv = zend_hash_find(Z_ARR_P(server_var), var_name);
 
     ZSTR_ALLOCA_FREE(var_name, use_heap);
@@ -57,3 +117,11 @@ zai_header_result zai_read_header(zai_str uppercase_header_name, zend_string **h
 
     return ZAI_HEADER_SUCCESS;
 }
+
+void zai_headers_rshutdown(void) {
+    if (zai_headers_sapi_cache) {
+        zend_hash_destroy(zai_headers_sapi_cache);
+        FREE_HASHTABLE(zai_headers_sapi_cache);
+        zai_headers_sapi_cache = NULL;
+    }
+}
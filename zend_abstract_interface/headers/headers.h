@@ -15,8 +15,13 @@ typedef enum {
     ZAI_HEADER_ERROR,
 } zai_header_result;
 
+/* Reads a request header. With auto_globals_jit, if $_SERVER was not materialized yet, the header is fetched directly
+ * from the SAPI where possible and cached until zai_headers_rshutdown(). */
 zai_header_result zai_read_header(zai_str uppercase_header_name, zend_string **header_value);
 
+/* Releases the per-request header cache. Call this late, after any module may have read headers. */
+void zai_headers_rshutdown(void);
+
 #define zai_read_header_literal(uppercase_header_name, header_value) \
     zai_read_header(ZAI_STRL(uppercase_header_name), header_value)
 
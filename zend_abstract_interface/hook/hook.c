@@ -83,8 +83,22 @@ typedef struct {
     zend_function *functions[];
 } zai_function_location_entry;
 
+typedef struct {
+    uint32_t used;
+    uint32_t holes;
+} zai_function_location_scan_pos;
+
 // zai_function_location_map maps from a filename to a possibly ordered array of values
-ZEND_TLS HashTable zai_function_location_map; /* }}} */
+// It is only filled when it is first needed, from the functions and classes declared since the last lookup
+ZEND_TLS HashTable zai_function_location_map;
+ZEND_TLS zai_function_location_scan_pos zai_function_location_scanned_functions;
+ZEND_TLS zai_function_location_scan_pos zai_function_location_scanned_classes; /* }}} */
+
+// zai_hook_hooked_classes is a bloom filter of the classes having at least one resolved hook on one of their functions
+// Classes whose ancestors all miss the filter cannot inherit any hooks, so looking up inherited hooks can be skipped.
+// Bits are never cleared within a request when hooks are removed, false positives only cost the lookup.
+#define ZAI_HOOKED_CLASSES_BITS 2048
+ZEND_TLS uint64_t zai_hook_hooked_classes[ZAI_HOOKED_CLASSES_BITS / 64];
 
 #define ZAI_IS_SHARED_HOOK_PTR (IS_PTR+1)
 
@@ -386,6 +400,45 @@ static zai_hooks_entry *zai_hook_alloc_hooks_entry(void) {
     return hooks;
 }
 
+static inline void zai_hook_hooked_class_bits(zend_class_entry *ce, uint32_t *first, uint32_t *second) {
+    uint64_t addr = ((uint64_t)(uintptr_t)ce) >> 3;
+    *first = (uint32_t)(addr % ZAI_HOOKED_CLASSES_BITS);
+    *second = (uint32_t)((addr * 0x9E3779B97F4A7C15ULL) >> 53) % ZAI_HOOKED_CLASSES_BITS;
+}
+
+static inline void zai_hook_mark_hooked_class(zend_class_entry *ce) {
+    if (!ce) {
+        return;
+    }
+    uint32_t first, second;
+    zai_hook_hooked_class_bits(ce, &first, &second);
+    zai_hook_hooked_classes[first / 64] |= 1ULL << (first % 64);
+    zai_hook_hooked_classes[second / 64] |= 1ULL << (second % 64);
+}
+
+static inline bool zai_hook_is_hooked_class(zend_class_entry *ce) {
+    uint32_t first, second;
+    zai_hook_hooked_class_bits(ce, &first, &second);
+    return (zai_hook_hooked_classes[first / 64] & (1ULL << (first % 64)))
+        && (zai_hook_hooked_classes[second / 64] & (1ULL << (second % 64)));
+}
+
+static bool zai_hook_may_inherit_hooks(zend_class_entry *ce) {
+    // abstract methods may be inherited without being redeclared, hence the whole chain needs to be checked
+    for (zend_class_entry *parent = ce->parent; parent; parent = parent->parent) {
+        if (zai_hook_is_hooked_class(parent)) {
+            return true;
+        }
+    }
+    // interfaces of the parents are part of ce->interfaces
+    for (uint32_t i = 0; i < ce->num_interfaces; ++i) {
+        if (zai_hook_is_hooked_class(ce->interfaces[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void zai_hook_resolve_hooks_entry(zai_hooks_entry *hooks, zend_function *resolved) {
 #if PHP_VERSION_ID >= 80000
     if ((resolved->common.fn_flags & ZEND_ACC_HEAP_RT_CACHE) == 0
@@ -439,6 +492,8 @@ static inline zai_hooks_entry *zai_hook_resolved_ensure_hooks_entry(zend_functio
     if (!hooks) {
         hooks = zai_hook_alloc_hooks_entry();
         zend_hash_index_add_ptr(&zai_hook_resolved, addr, hooks);
+        zai_hook_mark_hooked_class(resolved->common.scope);
+        zai_hook_mark_hooked_class(ce);
 
 #if PHP_VERSION_ID >= 80000
 #if PHP_VERSION_ID < 80200
@@ -627,6 +682,7 @@ static inline void zai_hook_merge_inherited_hooks(zai_hooks_entry **hooks_entry,
 
             if (!hooks && !(hooks = zend_hash_index_find_ptr(&zai_hook_resolved, zai_hook_install_address(function)))) {
                 *hooks_entry = hooks = zend_hash_index_add_ptr(&zai_hook_resolved, zai_hook_install_address(function), zai_hook_alloc_hooks_entry());
+                zai_hook_mark_hooked_class(ce);
                 zai_hook_resolve_hooks_entry(hooks, function);
 #if PHP_VERSION_ID >= 80200
                 // Internal functions duplicated onto userland classes share their run_time_cache with their parent function
@@ -695,6 +751,55 @@ static inline void zai_store_func_location(zend_function *func) {
     entry->functions[entry->size - 1] = func;
 }
 
+static inline bool zai_function_location_table_changed(HashTable *ht, zai_function_location_scan_pos *pos) {
+    // Deletions and compaction move buckets around, positions are only valid as long as the table just grew
+    return ht->nNumUsed < pos->used || ht->nNumUsed - ht->nNumOfElements != pos->holes;
+}
+
+static inline void zai_function_location_scan_done(HashTable *ht, zai_function_location_scan_pos *pos) {
+    pos->used = ht->nNumUsed;
+    pos->holes = ht->nNumUsed - ht->nNumOfElements;
+}
+
+static void zai_function_location_map_update(void) {
+    HashTable *functions = EG(function_table), *classes = EG(class_table);
+    if (zai_function_location_table_changed(functions, &zai_function_location_scanned_functions)
+     || zai_function_location_table_changed(classes, &zai_function_location_scanned_classes)) {
+        zend_hash_clean(&zai_function_location_map);
+        memset(&zai_function_location_scanned_functions, 0, sizeof(zai_function_location_scan_pos));
+        memset(&zai_function_location_scanned_classes, 0, sizeof(zai_function_location_scan_pos));
+    }
+
+    for (uint32_t i = zai_function_location_scanned_functions.used; i < functions->nNumUsed; ++i) {
+        zval *zv = &functions->arData[i].val;
+        if (Z_TYPE_P(zv) == IS_PTR) {
+            zai_store_func_location(Z_PTR_P(zv));
+        }
+    }
+    zai_function_location_scan_done(functions, &zai_function_location_scanned_functions);
+
+    for (uint32_t i = zai_function_location_scanned_classes.used; i < classes->nNumUsed; ++i) {
+        zval *zv = &classes->arData[i].val;
+        if (Z_TYPE_P(zv) != IS_PTR) { // class aliases are IS_ALIAS_PTR
+            continue;
+        }
+
+        zend_class_entry *ce = Z_PTR_P(zv);
+        if (ce->type != ZEND_USER_CLASS) {
+            continue;
+        }
+
+        zend_function *function;
+        ZEND_HASH_FOREACH_PTR(&ce->function_table, function) {
+            // inherited methods are stored along with the class declaring them
+            if (function->common.scope == ce) {
+                zai_store_func_location(function);
+            }
+        } ZEND_HASH_FOREACH_END();
+    }
+    zai_function_location_scan_done(classes, &zai_function_location_scanned_classes);
+}
+
 static int zai_function_location_map_cmp(const void *a, const void *b) {
     return (int)(*(zend_op_array **)a)->line_start - (int)(*(zend_op_array **)b)->line_start;
 }
@@ -704,6 +809,8 @@ zend_function *zai_hook_find_containing_function(zend_function *func) {
         return NULL;
     }
 
+    zai_function_location_map_update();
+
     zai_function_location_entry *entry;
     if (!(entry = zend_hash_find_ptr(&zai_function_location_map, func->op_array.filename))) {
         return NULL;
@@ -755,6 +862,9 @@ static inline void zai_hook_resolve(HashTable *base_ht, zend_class_entry *ce, ze
             function = function->common.scope->constructor;
         }
 
+        zai_hook_mark_hooked_class(function->common.scope);
+        zai_hook_mark_hooked_class(ce);
+
         zai_install_address addr = zai_hook_install_address(function);
         if (!zend_hash_index_add_ptr(&zai_hook_resolved, addr, hooks)) {
             // it's already there (e.g. thanks to aliases, traits, ...), merge it
@@ -825,7 +935,6 @@ static inline void zai_hook_resolve(HashTable *base_ht, zend_class_entry *ce, ze
 /* {{{ */
 void zai_hook_resolve_function(zend_function *function, zend_string *lcname) {
     zai_hook_resolve(&zai_hook_tls->request_functions, NULL, function, lcname);
-    zai_store_func_location(function);
 }
 
 void zai_hook_resolve_class(zend_class_entry *ce, zend_string *lcname) {
@@ -836,10 +945,22 @@ void zai_hook_resolve_class(zend_class_entry *ce, zend_string *lcname) {
     zend_string *fnname;
     HashTable *method_table = zend_hash_find_ptr(&zai_hook_tls->request_classes, lcname);
     if (!method_table) {
+        bool may_inherit_hooks = zai_hook_may_inherit_hooks(ce);
+#if PHP_VERSION_ID >= 80000
+        if (!may_inherit_hooks && zai_hook_on_function_resolve == zai_hook_on_function_resolve_empty) {
+            return;
+        }
+#else
+        if (!may_inherit_hooks) {
+            return;
+        }
+#endif
+
         ZEND_HASH_FOREACH_STR_KEY_PTR(&ce->function_table, fnname, function) {
-            zai_store_func_location(function);
             if (function->common.scope == ce || !ZEND_USER_CODE(function->type)) {
-                zai_hook_resolve_lookup_inherited(NULL, ce, function, fnname);
+                if (may_inherit_hooks) {
+                    zai_hook_resolve_lookup_inherited(NULL, ce, function, fnname);
+                }
 #if PHP_VERSION_ID >= 80000
                 zai_hook_on_function_resolve(function);
 #endif
@@ -850,7 +971,6 @@ void zai_hook_resolve_class(zend_class_entry *ce, zend_string *lcname) {
 
     ZEND_HASH_FOREACH_STR_KEY_PTR(&ce->function_table, fnname, function) {
         zai_hook_resolve(method_table, ce, function, fnname);
-        zai_store_func_location(function);
     } ZEND_HASH_FOREACH_END();
 
     if (zend_hash_num_elements(method_table) == 0) {
@@ -1176,7 +1296,10 @@ bool zai_hook_rinit(void) {
     zend_hash_init(&zai_hook_tls->request_functions, 8, NULL, zai_hook_hash_destroy, 0);
     zend_hash_init(&zai_hook_tls->request_classes, 8, NULL, zai_hook_hash_destroy, 0);
     zend_hash_init(&zai_hook_resolved, 8, NULL, NULL, 0);
+    memset(zai_hook_hooked_classes, 0, sizeof(zai_hook_hooked_classes));
     zend_hash_init(&zai_function_location_map, 8, NULL, zai_function_location_destroy, 0);
+    memset(&zai_function_location_scanned_functions, 0, sizeof(zai_function_location_scan_pos));
+    memset(&zai_function_location_scanned_classes, 0, sizeof(zai_function_location_scan_pos));
 
     // reserve low hook ids for static hooks
     zai_hook_tls->id = (zend_ulong)zai_hook_static.nNextFreeElement;